@@ -1,4 +1,7 @@
 
+#include "../../NABase/NAConfiguration.h"
+#if NA_COMPILE_GUI == 1
+
 #include "NAAppCore.h"
 #include "../NAApp.h"
 #include "../../NAStruct/NAList.h"
@@ -828,3 +831,7 @@ void na_AlignLayoutElement(
   }
   naClearListIterator(&iter);
 }
+
+
+
+#endif // NA_COMPILE_GUI == 1
@@ -0,0 +1,283 @@
+#if defined NA_ATOMIC_II_INCLUDED || !defined NA_BASE_INCLUDED
+  #warning "Do not include this file directly. Use NABase.h"
+#endif
+#ifndef NA_ATOMIC_II_INCLUDED
+#define NA_ATOMIC_II_INCLUDED
+
+
+
+// The NAMemoryOrder values are the same as the __ATOMIC_ macros of GCC and
+// Clang and can be given to the builtins directly.
+
+#if NA_OS == NA_OS_WINDOWS
+  #include <intrin.h>
+
+  NA_HIDEF void na_FullFence() {
+    #if defined _M_ARM || defined _M_ARM64
+      __dmb(_ARM64_BARRIER_ISH);
+    #else
+      _mm_mfence();
+    #endif
+  }
+
+  // Loads and stores to aligned variables are atomic. The compiler barrier
+  // prevents reordering by the compiler, the fence by the processor.
+  #define NA_WINDOWS_LOAD(type, ptr, order)\
+    type value = *(volatile const type*)(ptr);\
+    _ReadWriteBarrier();\
+    if(order != NA_MEMORY_ORDER_RELAXED) {na_FullFence();}\
+    return value;
+  #define NA_WINDOWS_STORE(type, ptr, value, order)\
+    if(order != NA_MEMORY_ORDER_RELAXED) {na_FullFence();}\
+    _ReadWriteBarrier();\
+    *(volatile type*)(ptr) = value;\
+    if(order == NA_MEMORY_ORDER_SEQ_CST) {na_FullFence();}
+#endif
+
+
+
+NA_IDEF int32 naAtomicLoadi32(const int32* ptr, NAMemoryOrder order) {
+  #if NA_OS == NA_OS_WINDOWS
+    NA_WINDOWS_LOAD(int32, ptr, order)
+  #else
+    return __atomic_load_n(ptr, (int)order);
+  #endif
+}
+
+
+
+NA_IDEF void* naAtomicLoadPtr(void* const* ptr, NAMemoryOrder order) {
+  #if NA_OS == NA_OS_WINDOWS
+    NA_WINDOWS_LOAD(void*, ptr, order)
+  #else
+    return __atomic_load_n(ptr, (int)order);
+  #endif
+}
+
+
+
+NA_IDEF void naAtomicStorei32(int32* ptr, int32 value, NAMemoryOrder order) {
+  #if NA_OS == NA_OS_WINDOWS
+    NA_WINDOWS_STORE(int32, ptr, value, order)
+  #else
+    __atomic_store_n(ptr, value, (int)order);
+  #endif
+}
+
+
+
+NA_IDEF void naAtomicStorePtr(void** ptr, void* value, NAMemoryOrder order) {
+  #if NA_OS == NA_OS_WINDOWS
+    NA_WINDOWS_STORE(void*, ptr, value, order)
+  #else
+    __atomic_store_n(ptr, value, (int)order);
+  #endif
+}
+
+
+
+NA_IDEF int32 naAtomicExchangei32(int32* ptr, int32 value, NAMemoryOrder order) {
+  #if NA_OS == NA_OS_WINDOWS
+    NA_UNUSED(order);
+    return (int32)_InterlockedExchange((volatile long*)ptr, (long)value);
+  #else
+    return __atomic_exchange_n(ptr, value, (int)order);
+  #endif
+}
+
+
+
+NA_IDEF void* naAtomicExchangePtr(void** ptr, void* value, NAMemoryOrder order) {
+  #if NA_OS == NA_OS_WINDOWS
+    NA_UNUSED(order);
+    return _InterlockedExchangePointer((void* volatile*)ptr, value);
+  #else
+    return __atomic_exchange_n(ptr, value, (int)order);
+  #endif
+}
+
+
+
+NA_IDEF int32 naAtomicAddi32(int32* ptr, int32 value, NAMemoryOrder order) {
+  #if NA_OS == NA_OS_WINDOWS
+    NA_UNUSED(order);
+    return (int32)_InterlockedExchangeAdd((volatile long*)ptr, (long)value);
+  #else
+    return __atomic_fetch_add(ptr, value, (int)order);
+  #endif
+}
+
+
+
+NA_IDEF NABool naAtomicCompareExchangei32(
+  int32* ptr,
+  int32* expected,
+  int32 desired,
+  NAMemoryOrder order)
+{
+  #if NA_OS == NA_OS_WINDOWS
+    long previous = _InterlockedCompareExchange((volatile long*)ptr, (long)desired, (long)*expected);
+    NA_UNUSED(order);
+    if(previous == (long)*expected)
+      return NA_TRUE;
+    *expected = (int32)previous;
+    return NA_FALSE;
+  #else
+    return __atomic_compare_exchange_n(ptr, expected, desired, NA_FALSE, (int)order, __ATOMIC_RELAXED);
+  #endif
+}
+
+
+
+NA_IDEF NABool naAtomicCompareExchangePtr(
+  void** ptr,
+  void** expected,
+  void* desired,
+  NAMemoryOrder order)
+{
+  #if NA_OS == NA_OS_WINDOWS
+    void* previous = _InterlockedCompareExchangePointer((void* volatile*)ptr, desired, *expected);
+    NA_UNUSED(order);
+    if(previous == *expected)
+      return NA_TRUE;
+    *expected = previous;
+    return NA_FALSE;
+  #else
+    return __atomic_compare_exchange_n(ptr, expected, desired, NA_FALSE, (int)order, __ATOMIC_RELAXED);
+  #endif
+}
+
+
+
+#if NA_NATIVE_INT64_IN_USE
+
+  NA_IDEF int64 naAtomicLoadi64(const int64* ptr, NAMemoryOrder order) {
+    #if NA_OS == NA_OS_WINDOWS
+      #if NA_ADDRESS_BITS == 64
+        NA_WINDOWS_LOAD(int64, ptr, order)
+      #else
+        // 64 bit loads are not atomic on 32 bit systems.
+        NA_UNUSED(order);
+        return _InterlockedCompareExchange64((volatile __int64*)ptr, 0, 0);
+      #endif
+    #else
+      return __atomic_load_n(ptr, (int)order);
+    #endif
+  }
+
+
+
+  NA_IDEF void naAtomicStorei64(int64* ptr, int64 value, NAMemoryOrder order) {
+    #if NA_OS == NA_OS_WINDOWS
+      #if NA_ADDRESS_BITS == 64
+        NA_WINDOWS_STORE(int64, ptr, value, order)
+      #else
+        naAtomicExchangei64(ptr, value, order);
+      #endif
+    #else
+      __atomic_store_n(ptr, value, (int)order);
+    #endif
+  }
+
+
+
+  NA_IDEF int64 naAtomicExchangei64(int64* ptr, int64 value, NAMemoryOrder order) {
+    #if NA_OS == NA_OS_WINDOWS
+      NA_UNUSED(order);
+      return _InterlockedExchange64((volatile __int64*)ptr, value);
+    #else
+      return __atomic_exchange_n(ptr, value, (int)order);
+    #endif
+  }
+
+
+
+  NA_IDEF int64 naAtomicAddi64(int64* ptr, int64 value, NAMemoryOrder order) {
+    #if NA_OS == NA_OS_WINDOWS
+      NA_UNUSED(order);
+      return _InterlockedExchangeAdd64((volatile __int64*)ptr, value);
+    #else
+      return __atomic_fetch_add(ptr, value, (int)order);
+    #endif
+  }
+
+
+
+  NA_IDEF NABool naAtomicCompareExchangei64(
+    int64* ptr,
+    int64* expected,
+    int64 desired,
+    NAMemoryOrder order)
+  {
+    #if NA_OS == NA_OS_WINDOWS
+      __int64 previous = _InterlockedCompareExchange64((volatile __int64*)ptr, desired, *expected);
+      NA_UNUSED(order);
+      if(previous == *expected)
+        return NA_TRUE;
+      *expected = previous;
+      return NA_FALSE;
+    #else
+      return __atomic_compare_exchange_n(ptr, expected, desired, NA_FALSE, (int)order, __ATOMIC_RELAXED);
+    #endif
+  }
+
+#endif // NA_NATIVE_INT64_IN_USE
+
+
+
+NA_IDEF void naAtomicFence(NAMemoryOrder order) {
+  #if NA_OS == NA_OS_WINDOWS
+    _ReadWriteBarrier();
+    if(order != NA_MEMORY_ORDER_RELAXED)
+      na_FullFence();
+  #else
+    __atomic_thread_fence((int)order);
+  #endif
+}
+
+
+
+NA_IDEF void naAtomicPause() {
+  #if NA_OS == NA_OS_WINDOWS
+    #if defined _M_ARM || defined _M_ARM64
+      __yield();
+    #else
+      _mm_pause();
+    #endif
+  #elif defined __i386__ || defined __x86_64__
+    __builtin_ia32_pause();
+  #elif defined __aarch64__ || defined __arm__
+    __asm__ __volatile__("yield");
+  #endif
+}
+
+
+
+#endif // NA_ATOMIC_II_INCLUDED
+
+
+
+// This is free and unencumbered software released into the public domain.
+
+// Anyone is free to copy, modify, publish, use, compile, sell, or
+// distribute this software, either in source code form or as a compiled
+// binary, for any purpose, commercial or non-commercial, and by any
+// means.
+
+// In jurisdictions that recognize copyright laws, the author or authors
+// of this software dedicate any and all copyright interest in the
+// software to the public domain. We make this dedication for the benefit
+// of the public at large and to the detriment of our heirs and
+// successors. We intend this dedication to be an overt act of
+// relinquishment in perpetuity of all present and future rights to this
+// software under copyright law.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+
+// For more information, please refer to <http://unlicense.org/>
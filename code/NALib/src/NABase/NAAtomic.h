@@ -0,0 +1,125 @@
+#if defined NA_ATOMIC_INCLUDED || !defined NA_BASE_INCLUDED
+  #warning "Do not include this file directly. Use NABase.h"
+#endif
+#ifndef NA_ATOMIC_INCLUDED
+#define NA_ATOMIC_INCLUDED
+
+
+
+// Atomic operations on plain integers and pointers which are shared between
+// threads. The functions work on ordinary variables, no special atomic type
+// is needed. The variables must be naturally aligned though which is the
+// case for any struct field or global variable unless packing is enforced.
+//
+// Every function expects a memory order which denotes how the operation is
+// ordered with other memory accesses of the same thread:
+//
+// NA_MEMORY_ORDER_RELAXED  Only the operation itself is atomic. Use this for
+//                          counters and statistics.
+// NA_MEMORY_ORDER_ACQUIRE  No access after this operation can be moved
+//                          before it. Use this for loads and for locking.
+// NA_MEMORY_ORDER_RELEASE  No access before this operation can be moved
+//                          after it. Use this for stores and for unlocking.
+// NA_MEMORY_ORDER_ACQ_REL  Both of the above. For read-modify-write operations.
+// NA_MEMORY_ORDER_SEQ_CST  Additionally, all threads see all SEQ_CST
+//                          operations in the same order. If in doubt, use
+//                          this one.
+//
+// Loads can not be RELEASE or ACQ_REL, stores can not be ACQUIRE or ACQ_REL.
+//
+// With GCC and Clang, the __atomic builtins are used which map directly to
+// the C11 memory model. With Visual Studio, the Interlocked intrinsics are
+// used which are always full barriers, loads and stores with an order other
+// than RELAXED are followed by a full fence.
+
+typedef enum{
+  NA_MEMORY_ORDER_RELAXED = 0,
+  NA_MEMORY_ORDER_ACQUIRE = 2,
+  NA_MEMORY_ORDER_RELEASE = 3,
+  NA_MEMORY_ORDER_ACQ_REL = 4,
+  NA_MEMORY_ORDER_SEQ_CST = 5
+} NAMemoryOrder;
+
+// Loads and stores a value atomically.
+NA_IAPI int32 naAtomicLoadi32 (const int32* ptr, NAMemoryOrder order);
+NA_IAPI void* naAtomicLoadPtr (void* const* ptr, NAMemoryOrder order);
+NA_IAPI void  naAtomicStorei32(int32* ptr, int32 value, NAMemoryOrder order);
+NA_IAPI void  naAtomicStorePtr(void** ptr, void* value, NAMemoryOrder order);
+
+// Replaces the value and returns the previous one.
+NA_IAPI int32 naAtomicExchangei32(int32* ptr, int32 value, NAMemoryOrder order);
+NA_IAPI void* naAtomicExchangePtr(void** ptr, void* value, NAMemoryOrder order);
+
+// Adds the value and returns the value before the addition. Use a negative
+// value to subtract.
+NA_IAPI int32 naAtomicAddi32(int32* ptr, int32 value, NAMemoryOrder order);
+
+// Compares the value at ptr with expected. If they are equal, desired is
+// stored and NA_TRUE is returned. Otherwise, nothing is stored, NA_FALSE is
+// returned and expected is overwritten with the current value. The order
+// applies to the successful case, the failing case is always RELAXED.
+NA_IAPI NABool naAtomicCompareExchangei32(
+  int32* ptr,
+  int32* expected,
+  int32 desired,
+  NAMemoryOrder order);
+NA_IAPI NABool naAtomicCompareExchangePtr(
+  void** ptr,
+  void** expected,
+  void* desired,
+  NAMemoryOrder order);
+
+// The same for 64 bit integers. Only available if there is a native 64 bit
+// integer type. On 32 bit systems, these are slower than their 32 bit
+// counterparts.
+#if NA_NATIVE_INT64_IN_USE
+  NA_IAPI int64 naAtomicLoadi64    (const int64* ptr, NAMemoryOrder order);
+  NA_IAPI void  naAtomicStorei64   (int64* ptr, int64 value, NAMemoryOrder order);
+  NA_IAPI int64 naAtomicExchangei64(int64* ptr, int64 value, NAMemoryOrder order);
+  NA_IAPI int64 naAtomicAddi64     (int64* ptr, int64 value, NAMemoryOrder order);
+  NA_IAPI NABool naAtomicCompareExchangei64(
+    int64* ptr,
+    int64* expected,
+    int64 desired,
+    NAMemoryOrder order);
+#endif
+
+// Issues a memory fence with the given order without accessing any memory.
+// A RELAXED fence does nothing.
+NA_IAPI void naAtomicFence(NAMemoryOrder order);
+
+// Tells the processor that the current thread is busy waiting in a loop.
+// Use this in spin loops to save power and to let the other hyper-thread
+// of the same core run.
+NA_IAPI void naAtomicPause(void);
+
+
+
+#endif // NA_ATOMIC_INCLUDED
+
+
+
+// This is free and unencumbered software released into the public domain.
+
+// Anyone is free to copy, modify, publish, use, compile, sell, or
+// distribute this software, either in source code form or as a compiled
+// binary, for any purpose, commercial or non-commercial, and by any
+// means.
+
+// In jurisdictions that recognize copyright laws, the author or authors
+// of this software dedicate any and all copyright interest in the
+// software to the public domain. We make this dedication for the benefit
+// of the public at large and to the detriment of our heirs and
+// successors. We intend this dedication to be an overt act of
+// relinquishment in perpetuity of all present and future rights to this
+// software under copyright law.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+
+// For more information, please refer to <http://unlicense.org/>
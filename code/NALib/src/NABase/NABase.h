@@ -50,12 +50,16 @@
 #include "NANumerics.h"
 #include "NAFloatingPoint.h"
 
+// Atomic operations for sharing variables between threads
+#include "NAAtomic.h"
+
 // Adding inline implementations of numerical types
 #include "Core/NAInt64II.h"
 #include "Core/NAInt128II.h"
 #include "Core/NAInt256II.h"
 #include "Core/NANumericsII.h"
 #include "Core/NAFloatingPointII.h"
+#include "Core/NAAtomicII.h"
 
 
 
@@ -228,12 +228,37 @@
 // Runtime memory pools
 // ////////////////////////////////
 
+// Define the use of huge pages:
+//
+// Memory allocated with naMallocMapped with a byteSize of at least
+// NA_HUGE_PAGE_BYTESIZE is marked to be backed by huge pages if the system
+// supports it (for example transparent huge pages on Linux). This reduces
+// the number of TLB misses when accessing a lot of memory. Runtime pool parts
+// and NAMemoryBlocks of that size are allocated with naMallocMapped.
+//
+// Set NA_USE_HUGE_PAGES to 0 to never advise the system to use huge pages.
+//
+// Default is 1 and (1 << 21) respectively.
+
+#ifndef NA_USE_HUGE_PAGES
+  #define NA_USE_HUGE_PAGES 1
+#endif
+
+#ifndef NA_HUGE_PAGE_BYTESIZE
+  #define NA_HUGE_PAGE_BYTESIZE (1 << 21)
+#endif
+
+
+
 // Define the size of a memory pool part. This size is used for the
 // NALib runtime system, more precisely allocation with naNew, as well as
 // for garbage collection.
 //
 // If you set this macro to 0, one memory page size will be used.
 //
+// This is the size used by naStartRuntime. You can choose a different size
+// when starting the runtime with naStartRuntimeWithPartSize.
+//
 // Turns out, on most systems, one pageSize is far too small to result in
 // good speed improvements for naNew. A large enough custom byteSize can
 // result in up to 2 times faster allocation and deallocation.
@@ -271,6 +296,33 @@
   #define NA_MEMORY_POOL_AGGRESSIVE_CLEANUP 0
 #endif
 
+// Define how many empty pool parts shall be retained.
+//
+// When all spaces of a pool part are deleted, the part becomes empty. Freeing
+// it immediately results in a lot of allocations and deallocations when the
+// number of objects of a type constantly goes up and down around a part
+// boundary. Therefore, empty parts are retained to be recycled later on.
+//
+// NA_RUNTIME_RETAINED_PART_COUNT defines how many empty parts are retained
+// per type, NA_RUNTIME_RETAINED_PART_BYTESIZE defines how many bytes of empty
+// parts are retained in total for all types. Both limits must be satisfied.
+//
+// These limits work with hysteresis: Parts becoming empty are only released
+// immediately if a limit is exceeded by a factor of two. Everything above the
+// limits is released lazily during the next call to naCollectGarbage.
+//
+// The limits can be changed at runtime with naSetRuntimePartRetention.
+//
+// Default is 1 and (1 << 22)
+
+#ifndef NA_RUNTIME_RETAINED_PART_COUNT
+  #define NA_RUNTIME_RETAINED_PART_COUNT 1
+#endif
+
+#ifndef NA_RUNTIME_RETAINED_PART_BYTESIZE
+  #define NA_RUNTIME_RETAINED_PART_BYTESIZE (1 << 22)
+#endif
+
 // Defines when the temp garbage collection starts collecting automatically.
 //
 // With this macro, you can define, if and when the garbage collection should
@@ -284,6 +336,10 @@
 // naMallocTmp. If so, the garbage will first be collected and then the new
 // bytes will be allocated and returned.
 //
+// Temporary memory is collected per thread. This value is the initial limit
+// of every thread which can be changed at runtime with
+// naSetThreadGarbageAutoCollectLimit.
+//
 // The default value is 1000000 (1 Million) when no GUI is in use and 0 when
 // a GUI is in use. When a GUI is in use, the event loop of NAApplication
 // calls naCollectGarbage automatically before executing any event.
@@ -298,6 +354,75 @@
 
 
 
+// Define if naNew and naDelete shall be usable from multiple threads.
+//
+// By default, the runtime system assumes that all allocations of runtime
+// types happen in one single thread. If set to 1, every thread gets its own
+// small cache (a so called magazine) of free spaces per type. naNew and
+// naDelete then only work on that cache and only lock the shared pool parts
+// when a magazine runs empty or full, moving multiple spaces at once.
+//
+// Spaces may be deleted in a different thread than the one which created
+// them. They simply go to the magazine of the deleting thread and are given
+// back to their pool part once that magazine overflows.
+//
+// The cached spaces of a thread are given back automatically when the thread
+// ends on most systems, see naFlushRuntimeThreadCache in NAMemory.h.
+//
+// NA_RUNTIME_THREAD_CACHE_COUNT defines the maximal number of spaces one
+// magazine stores. Half of it is moved when refilling or flushing.
+//
+// Default is 0 and 64 respectively.
+
+#ifndef NA_RUNTIME_USE_THREAD_CACHES
+  #define NA_RUNTIME_USE_THREAD_CACHES 0
+#endif
+
+#ifndef NA_RUNTIME_THREAD_CACHE_COUNT
+  #define NA_RUNTIME_THREAD_CACHE_COUNT 64
+#endif
+
+
+
+// Define the byte size of a cache line:
+//
+// Data written concurrently by different threads should not share a cache
+// line, otherwise the cores steadily invalidate each others caches (so called
+// false sharing). Use this value for example as the alignment of a runtime
+// type with NA_RUNTIME_TYPE_ALIGNED. Some architectures like Apple Silicon
+// use 128 bytes.
+//
+// Default is 64.
+
+#ifndef NA_CACHE_LINE_BYTESIZE
+  #define NA_CACHE_LINE_BYTESIZE 64
+#endif
+
+
+
+// Define if reference counts shall be atomic:
+//
+// By default, NARefCount and with it NASmartPtr, NAPointer and all reference
+// counting runtime types (naRetain, naRelease) use plain integer increments
+// and decrements. This is fast but it is not allowed to retain or release
+// the same object from multiple threads at the same time.
+//
+// If set to 1, the reference counts are changed atomically: A retain uses a
+// relaxed increment, a release uses a decrement with release semantics and
+// an acquire fence before the destructor gets called. This allows to share
+// immutable objects like NABuffer parts among multiple threads. Note that
+// when the last reference of a runtime type is released in another thread
+// than the one which created it, NA_RUNTIME_USE_THREAD_CACHES should be 1 as
+// well.
+//
+// Default is 0.
+
+#ifndef NA_ATOMIC_REFCOUNT
+  #define NA_ATOMIC_REFCOUNT 0
+#endif
+
+
+
 // ////////////////////////////////
 // Buffers
 // ////////////////////////////////
@@ -358,6 +483,39 @@
 
 
 
+// ////////////////////////////////
+// Spin mutexes
+// ////////////////////////////////
+
+// An NASpinMutex polls a locked mutex for a while before the thread goes to
+// sleep. The number of polls adapts to the time needed to get the lock in
+// the past but never exceeds the following value. Set it to 0 to never spin.
+//
+// Default is 1000
+
+#ifndef NA_SPIN_MUTEX_MAX_SPIN_COUNT
+  #define NA_SPIN_MUTEX_MAX_SPIN_COUNT 1000
+#endif
+
+
+
+// ////////////////////////////////
+// Mutex profiling
+// ////////////////////////////////
+
+// When set to 1, every NAMutex counts how often it is locked and measures
+// how long threads wait for it and how long it is held. The statistics are
+// available with naGetMutexStats and naWriteBufferMutexStats. Locking then
+// needs two clock readings more, so use it only when looking for contention.
+//
+// Default is 0
+
+#ifndef NA_MUTEX_PROFILING
+  #define NA_MUTEX_PROFILING 0
+#endif
+
+
+
 // ////////////////////////////////
 // Mathematical, chemical and physical constants
 // ////////////////////////////////
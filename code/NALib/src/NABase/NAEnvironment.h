@@ -42,6 +42,7 @@
 #define NA_OS_MAC_OS_X  1
 #define NA_OS_WINDOWS   2
 #define NA_OS_FREEBSD   3
+#define NA_OS_LINUX     4
 
 // Figuring out what system this is. The following symbols will be defined:
 //
@@ -60,6 +61,7 @@
 // Currently, there are the following system configurations assumed:
 // - Mac OS X with GCC or Clang
 // - Windows with Microsoft Visual Studio compiler
+// - Linux with GCC or Clang (no NAApp)
 //
 // Note that the author is completely aware that the system is not bound to
 // a specific compiler. But these combinations are the ones having been used
@@ -171,6 +173,30 @@
   #define NA_FILESIZE_BITS NA_TYPE64_BITS
   #define NA_FILESIZE_MAX NA_MAX_i64
 
+#elif defined __linux__
+  #define NA_OS NA_OS_LINUX
+  #define NA_IS_POSIX 1
+
+  #if defined __LITTLE_ENDIAN__ || (defined __BYTE_ORDER__ && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+    #undef  NA_ENDIANNESS_HOST
+    #define NA_ENDIANNESS_HOST NA_ENDIANNESS_LITTLE
+  #elif defined __BIG_ENDIAN__ || (defined __BYTE_ORDER__ && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+    #undef  NA_ENDIANNESS_HOST
+    #define NA_ENDIANNESS_HOST NA_ENDIANNESS_BIG
+  #endif
+  #if defined __LP64__
+    #define NA_ADDRESS_BITS NA_TYPE64_BITS
+    #define NA_SIZE_T_BITS  NA_TYPE64_BITS
+  #else
+    #define NA_ADDRESS_BITS NA_TYPE32_BITS
+    #define NA_SIZE_T_BITS  NA_TYPE32_BITS
+  #endif
+
+  #include <unistd.h>
+  typedef off_t fsize_t;     // Is signed (Important for negative offsets)
+  #define NA_FILESIZE_BITS NA_TYPE64_BITS
+  #define NA_FILESIZE_MAX NA_MAX_i64
+
 #else
   #define NA_OS NA_OS_UNKNOWN
   #warning "System unknown. Assuming 32bit Addr, 32bit Int, little endian"
@@ -16,9 +16,11 @@
 // NA_INLINE
 // NA_LINKER_NO_EXPORT
 // NA_LINKER_EXPORT
+// NA_THREAD_LOCAL
 //
 // The definition of NA_RESTRICT and NA_INLINE are just mappings of built-in
-// keywords on different systems.
+// keywords on different systems. NA_THREAD_LOCAL marks a global or static
+// variable to exist once per thread.
 //
 // A function declared with NA_LINKER_NO_EXPORT will not be exported when
 // building a binary. Therefore this function will not be listed in the .lib
@@ -38,6 +40,7 @@
   #define NA_LINKER_NO_EXPORT
   #define NA_LINKER_EXPORT      __declspec(dllexport)
   #define NA_FALLTHROUGH        // todo
+  #define NA_THREAD_LOCAL       __declspec(thread)
 #elif NA_OS == NA_OS_MAC_OS_X
   #define NA_INLINE             inline
   #ifdef __cplusplus
@@ -49,6 +52,7 @@
   #define NA_LINKER_NO_EXPORT   __attribute__ ((visibility("hidden")))
   #define NA_LINKER_EXPORT      __attribute__ ((visibility("default")))
   #define NA_FALLTHROUGH        __attribute__((fallthrough))
+  #define NA_THREAD_LOCAL       __thread
 #else
   #define NA_INLINE             inline
   #ifdef __cplusplus
@@ -60,6 +64,11 @@
   #define NA_LINKER_NO_EXPORT
   #define NA_LINKER_EXPORT
   #define NA_FALLTHROUGH
+  #if defined NA_C11 && !defined __STDC_NO_THREADS__
+    #define NA_THREAD_LOCAL     _Thread_local
+  #else
+    #define NA_THREAD_LOCAL     __thread
+  #endif
 #endif
 
 
@@ -230,6 +239,20 @@ typedef void (*NAMutator)  (      void*);
 
 
 
+// ////////////////////////
+// Sorting functions like naSortList expect a comparator with the following
+// signature:
+
+typedef int (*NAComparator)(const void* a, const void* b);
+
+// It works the same as the comparator of the standard qsort function: Return
+// a negative value if a shall come before b, a positive value if b shall come
+// before a and 0 if both are equal. Therefore, existing qsort comparators can
+// be used without change. As with accessors, the comparator is called with
+// POINTERS to the contents.
+
+
+
 #endif // NA_LANGUAGE_INCLUDED
 
 
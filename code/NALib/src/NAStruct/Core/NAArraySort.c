@@ -0,0 +1,307 @@
+
+#include "../NAArray.h"
+#include "../../NAUtility/NABinaryData.h"
+#include "../../NAMath/NAMathOperators.h"
+
+
+
+// Sorting numbers works the same for all types: The numbers are converted
+// into unsigned integers of the same size whose order is the same as the one
+// of the numbers. For signed integers, the sign bit is flipped. For floating
+// point numbers, all bits of negative numbers are flipped and only the sign
+// bit of positive numbers. These unsigned integers are then sorted with a
+// template implementation which exists for 32 and 64 bits, see NAArraySortT.h
+// and afterwards, the conversion is reverted.
+//
+// Arrays up to NA_ARRAY_SORT_SMALL_COUNT elements are sorted on the stack.
+// Larger arrays are sorted with a radix sort using digits of 8 bits.
+#define NA_ARRAY_SORT_SMALL_COUNT 256
+#define NA_ARRAY_SORT_INSERTION_COUNT 32
+#define NA_ARRAY_SORT_RADIX 256
+
+#define NA_T_TYPE uint32
+  #include "NAArraySortT.h"
+#undef NA_T_TYPE
+
+#if NA_NATIVE_INT64_IN_USE
+  #define NA_T_TYPE uint64
+    #include "NAArraySortT.h"
+  #undef NA_T_TYPE
+#endif
+
+
+
+#define NA_ARRAY_SORT_SIGN_u32 ((uint32)1 << 31)
+#define NA_ARRAY_SORT_SIGN_u64 ((uint64)1 << 63)
+
+NA_HIDEF uint32 na_EncodeSortKeyf(uint32 bits) {
+  return bits ^ ((0u - (bits >> 31)) | NA_ARRAY_SORT_SIGN_u32);
+}
+NA_HIDEF uint32 na_DecodeSortKeyf(uint32 bits) {
+  return bits ^ (((bits >> 31) - 1u) | NA_ARRAY_SORT_SIGN_u32);
+}
+
+#if NA_NATIVE_INT64_IN_USE
+  NA_HIDEF uint64 na_EncodeSortKeyd(uint64 bits) {
+    return bits ^ (((uint64)0 - (bits >> 63)) | NA_ARRAY_SORT_SIGN_u64);
+  }
+  NA_HIDEF uint64 na_DecodeSortKeyd(uint64 bits) {
+    return bits ^ (((bits >> 63) - (uint64)1) | NA_ARRAY_SORT_SIGN_u64);
+  }
+#endif
+
+
+
+#if NA_DEBUG
+  NA_HIDEF void na_CheckSortArray(const NAArray* array, size_t typeSize, const size_t* indices, NABool needsIndices) {
+    if(!array)
+      naCrash("array is nullptr");
+    if(naGetArrayTypeSize(array) != typeSize)
+      naError("The typeSize of the array does not match the type to sort.");
+    if(needsIndices && !indices && !naIsArrayEmpty(array))
+      naCrash("indices is nullptr");
+  }
+#endif
+
+
+
+NA_DEF void naSortArrayi32(NAArray* array) {
+  uint32* keys;
+  size_t count;
+  size_t i;
+  #if NA_DEBUG
+    na_CheckSortArray(array, sizeof(int32), NA_NULL, NA_FALSE);
+  #endif
+  count = naGetArrayCount(array);
+  if(count < 2)
+    return;
+  keys = naGetArrayPointerMutable(array);
+  for(i = 0; i < count; ++i) { keys[i] ^= NA_ARRAY_SORT_SIGN_u32; }
+  na_SortArrayKeysuint32(keys, count);
+  for(i = 0; i < count; ++i) { keys[i] ^= NA_ARRAY_SORT_SIGN_u32; }
+}
+
+
+
+NA_DEF void naSortArrayu32(NAArray* array) {
+  #if NA_DEBUG
+    na_CheckSortArray(array, sizeof(uint32), NA_NULL, NA_FALSE);
+  #endif
+  if(naGetArrayCount(array) < 2)
+    return;
+  na_SortArrayKeysuint32(naGetArrayPointerMutable(array), naGetArrayCount(array));
+}
+
+
+
+NA_DEF void naSortArrayf(NAArray* array) {
+  uint32* keys;
+  size_t count;
+  size_t i;
+  #if NA_DEBUG
+    na_CheckSortArray(array, sizeof(float), NA_NULL, NA_FALSE);
+  #endif
+  count = naGetArrayCount(array);
+  if(count < 2)
+    return;
+  keys = naGetArrayPointerMutable(array);
+  for(i = 0; i < count; ++i) { keys[i] = na_EncodeSortKeyf(keys[i]); }
+  na_SortArrayKeysuint32(keys, count);
+  for(i = 0; i < count; ++i) { keys[i] = na_DecodeSortKeyf(keys[i]); }
+}
+
+
+
+#if NA_NATIVE_INT64_IN_USE
+
+NA_DEF void naSortArrayi64(NAArray* array) {
+  uint64* keys;
+  size_t count;
+  size_t i;
+  #if NA_DEBUG
+    na_CheckSortArray(array, sizeof(int64), NA_NULL, NA_FALSE);
+  #endif
+  count = naGetArrayCount(array);
+  if(count < 2)
+    return;
+  keys = naGetArrayPointerMutable(array);
+  for(i = 0; i < count; ++i) { keys[i] ^= NA_ARRAY_SORT_SIGN_u64; }
+  na_SortArrayKeysuint64(keys, count);
+  for(i = 0; i < count; ++i) { keys[i] ^= NA_ARRAY_SORT_SIGN_u64; }
+}
+
+
+
+NA_DEF void naSortArrayu64(NAArray* array) {
+  #if NA_DEBUG
+    na_CheckSortArray(array, sizeof(uint64), NA_NULL, NA_FALSE);
+  #endif
+  if(naGetArrayCount(array) < 2)
+    return;
+  na_SortArrayKeysuint64(naGetArrayPointerMutable(array), naGetArrayCount(array));
+}
+
+
+
+NA_DEF void naSortArrayd(NAArray* array) {
+  uint64* keys;
+  size_t count;
+  size_t i;
+  #if NA_DEBUG
+    na_CheckSortArray(array, sizeof(double), NA_NULL, NA_FALSE);
+  #endif
+  count = naGetArrayCount(array);
+  if(count < 2)
+    return;
+  keys = naGetArrayPointerMutable(array);
+  for(i = 0; i < count; ++i) { keys[i] = na_EncodeSortKeyd(keys[i]); }
+  na_SortArrayKeysuint64(keys, count);
+  for(i = 0; i < count; ++i) { keys[i] = na_DecodeSortKeyd(keys[i]); }
+}
+
+#endif // NA_NATIVE_INT64_IN_USE
+
+
+
+NA_DEF void naSortArrayIndicesi32(const NAArray* array, size_t* indices) {
+  const uint32* values;
+  uint32* keys;
+  size_t count;
+  size_t i;
+  #if NA_DEBUG
+    na_CheckSortArray(array, sizeof(int32), indices, NA_TRUE);
+  #endif
+  count = naGetArrayCount(array);
+  if(!count)
+    return;
+  values = naGetArrayPointerConst(array);
+  keys = naMalloc(count * sizeof(uint32));
+  for(i = 0; i < count; ++i) { keys[i] = values[i] ^ NA_ARRAY_SORT_SIGN_u32; }
+  na_SortArrayKeyIndicesuint32(keys, indices, count);
+  naFree(keys);
+}
+
+
+
+NA_DEF void naSortArrayIndicesu32(const NAArray* array, size_t* indices) {
+  uint32* keys;
+  size_t count;
+  #if NA_DEBUG
+    na_CheckSortArray(array, sizeof(uint32), indices, NA_TRUE);
+  #endif
+  count = naGetArrayCount(array);
+  if(!count)
+    return;
+  keys = naMalloc(count * sizeof(uint32));
+  naCopyn(keys, naGetArrayPointerConst(array), count * sizeof(uint32));
+  na_SortArrayKeyIndicesuint32(keys, indices, count);
+  naFree(keys);
+}
+
+
+
+NA_DEF void naSortArrayIndicesf(const NAArray* array, size_t* indices) {
+  const uint32* values;
+  uint32* keys;
+  size_t count;
+  size_t i;
+  #if NA_DEBUG
+    na_CheckSortArray(array, sizeof(float), indices, NA_TRUE);
+  #endif
+  count = naGetArrayCount(array);
+  if(!count)
+    return;
+  values = naGetArrayPointerConst(array);
+  keys = naMalloc(count * sizeof(uint32));
+  for(i = 0; i < count; ++i) { keys[i] = na_EncodeSortKeyf(values[i]); }
+  na_SortArrayKeyIndicesuint32(keys, indices, count);
+  naFree(keys);
+}
+
+
+
+#if NA_NATIVE_INT64_IN_USE
+
+NA_DEF void naSortArrayIndicesi64(const NAArray* array, size_t* indices) {
+  const uint64* values;
+  uint64* keys;
+  size_t count;
+  size_t i;
+  #if NA_DEBUG
+    na_CheckSortArray(array, sizeof(int64), indices, NA_TRUE);
+  #endif
+  count = naGetArrayCount(array);
+  if(!count)
+    return;
+  values = naGetArrayPointerConst(array);
+  keys = naMalloc(count * sizeof(uint64));
+  for(i = 0; i < count; ++i) { keys[i] = values[i] ^ NA_ARRAY_SORT_SIGN_u64; }
+  na_SortArrayKeyIndicesuint64(keys, indices, count);
+  naFree(keys);
+}
+
+
+
+NA_DEF void naSortArrayIndicesu64(const NAArray* array, size_t* indices) {
+  uint64* keys;
+  size_t count;
+  #if NA_DEBUG
+    na_CheckSortArray(array, sizeof(uint64), indices, NA_TRUE);
+  #endif
+  count = naGetArrayCount(array);
+  if(!count)
+    return;
+  keys = naMalloc(count * sizeof(uint64));
+  naCopyn(keys, naGetArrayPointerConst(array), count * sizeof(uint64));
+  na_SortArrayKeyIndicesuint64(keys, indices, count);
+  naFree(keys);
+}
+
+
+
+NA_DEF void naSortArrayIndicesd(const NAArray* array, size_t* indices) {
+  const uint64* values;
+  uint64* keys;
+  size_t count;
+  size_t i;
+  #if NA_DEBUG
+    na_CheckSortArray(array, sizeof(double), indices, NA_TRUE);
+  #endif
+  count = naGetArrayCount(array);
+  if(!count)
+    return;
+  values = naGetArrayPointerConst(array);
+  keys = naMalloc(count * sizeof(uint64));
+  for(i = 0; i < count; ++i) { keys[i] = na_EncodeSortKeyd(values[i]); }
+  na_SortArrayKeyIndicesuint64(keys, indices, count);
+  naFree(keys);
+}
+
+#endif // NA_NATIVE_INT64_IN_USE
+
+
+
+// This is free and unencumbered software released into the public domain.
+
+// Anyone is free to copy, modify, publish, use, compile, sell, or
+// distribute this software, either in source code form or as a compiled
+// binary, for any purpose, commercial or non-commercial, and by any
+// means.
+
+// In jurisdictions that recognize copyright laws, the author or authors
+// of this software dedicate any and all copyright interest in the
+// software to the public domain. We make this dedication for the benefit
+// of the public at large and to the detriment of our heirs and
+// successors. We intend this dedication to be an overt act of
+// relinquishment in perpetuity of all present and future rights to this
+// software under copyright law.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+
+// For more information, please refer to <http://unlicense.org/>
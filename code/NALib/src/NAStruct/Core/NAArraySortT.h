@@ -0,0 +1,284 @@
+// TEMPLATE
+// This is an NALib template file. It uses macros which are defined before
+// including this file to manipulate the implementation. Go look for the place
+// this file is included to find more info.
+//
+// NA_T_TYPE is an unsigned integer type. All functions sort by the plain
+// unsigned value, the conversion of other types is done in NAArraySort.c.
+
+
+
+// Compares and swaps two values such that a holds the smaller one. There are
+// no branches involved, hence the compiler can use min and max instructions.
+#define NA_ARRAY_SORT_EXCHANGE(a, b)\
+  {NA_T_TYPE na_lo = (a) < (b) ? (a) : (b);\
+  NA_T_TYPE na_hi = (a) < (b) ? (b) : (a);\
+  (a) = na_lo;\
+  (b) = na_hi;}
+
+// Sorts exactly 8 values with an optimal sorting network of 19 comparators
+// in 6 layers. The comparators within a layer are independent of each other.
+NA_HDEF void NA_T1(na_SortNetwork8, NA_T_TYPE)(NA_T_TYPE* data) {
+  NA_T_TYPE v0 = data[0];
+  NA_T_TYPE v1 = data[1];
+  NA_T_TYPE v2 = data[2];
+  NA_T_TYPE v3 = data[3];
+  NA_T_TYPE v4 = data[4];
+  NA_T_TYPE v5 = data[5];
+  NA_T_TYPE v6 = data[6];
+  NA_T_TYPE v7 = data[7];
+  NA_ARRAY_SORT_EXCHANGE(v0, v2) NA_ARRAY_SORT_EXCHANGE(v1, v3)
+  NA_ARRAY_SORT_EXCHANGE(v4, v6) NA_ARRAY_SORT_EXCHANGE(v5, v7)
+  NA_ARRAY_SORT_EXCHANGE(v0, v4) NA_ARRAY_SORT_EXCHANGE(v1, v5)
+  NA_ARRAY_SORT_EXCHANGE(v2, v6) NA_ARRAY_SORT_EXCHANGE(v3, v7)
+  NA_ARRAY_SORT_EXCHANGE(v0, v1) NA_ARRAY_SORT_EXCHANGE(v2, v3)
+  NA_ARRAY_SORT_EXCHANGE(v4, v5) NA_ARRAY_SORT_EXCHANGE(v6, v7)
+  NA_ARRAY_SORT_EXCHANGE(v2, v4) NA_ARRAY_SORT_EXCHANGE(v3, v5)
+  NA_ARRAY_SORT_EXCHANGE(v1, v4) NA_ARRAY_SORT_EXCHANGE(v3, v6)
+  NA_ARRAY_SORT_EXCHANGE(v1, v2) NA_ARRAY_SORT_EXCHANGE(v3, v4)
+  NA_ARRAY_SORT_EXCHANGE(v5, v6)
+  data[0] = v0;
+  data[1] = v1;
+  data[2] = v2;
+  data[3] = v3;
+  data[4] = v4;
+  data[5] = v5;
+  data[6] = v6;
+  data[7] = v7;
+}
+
+#undef NA_ARRAY_SORT_EXCHANGE
+
+
+
+// Sorts a small number of values: Blocks of 8 values are sorted with the
+// network, the remaining values with insertion sort. Then, the blocks are
+// merged using the buffer which must have space for count values.
+NA_HDEF void NA_T1(na_SortArraySmall, NA_T_TYPE)(NA_T_TYPE* data, NA_T_TYPE* buffer, size_t count) {
+  NA_T_TYPE* src = data;
+  NA_T_TYPE* dst = buffer;
+  NA_T_TYPE* swap;
+  size_t blockEnd = count - count % 8;
+  size_t width;
+  size_t i;
+
+  for(i = 0; i < blockEnd; i += 8) {
+    NA_T1(na_SortNetwork8, NA_T_TYPE)(&data[i]);
+  }
+  for(i = blockEnd + 1; i < count; ++i) {
+    NA_T_TYPE value = data[i];
+    size_t j = i;
+    while(j > blockEnd && data[j - 1] > value) {
+      data[j] = data[j - 1];
+      j--;
+    }
+    data[j] = value;
+  }
+
+  for(width = 8; width < count; width *= 2) {
+    for(i = 0; i < count; i += 2 * width) {
+      size_t a = i;
+      size_t aEnd = naMins(i + width, count);
+      size_t b = aEnd;
+      size_t bEnd = naMins(i + 2 * width, count);
+      size_t out = i;
+      while(a < aEnd && b < bEnd) {
+        dst[out++] = src[b] < src[a] ? src[b++] : src[a++];
+      }
+      while(a < aEnd) { dst[out++] = src[a++]; }
+      while(b < bEnd) { dst[out++] = src[b++]; }
+    }
+    swap = src;
+    src = dst;
+    dst = swap;
+  }
+
+  if(src != data) {
+    naCopyn(data, src, count * sizeof(NA_T_TYPE));
+  }
+}
+
+
+
+// Computes the histograms of all digits of the given keys in one pass and
+// turns them into the start offsets of each digit value. Returns a bit mask
+// of all digits which need a pass: When all keys have the same value in a
+// digit, the pass can be skipped.
+NA_HDEF uint32 NA_T1(na_PrepareRadixSort, NA_T_TYPE)(const NA_T_TYPE* keys, size_t count, size_t* offsets) {
+  uint32 passMask = 0;
+  size_t d;
+  size_t i;
+
+  naZeron(offsets, sizeof(NA_T_TYPE) * NA_ARRAY_SORT_RADIX * sizeof(size_t));
+  for(i = 0; i < count; ++i) {
+    NA_T_TYPE key = keys[i];
+    for(d = 0; d < sizeof(NA_T_TYPE); ++d) {
+      offsets[d * NA_ARRAY_SORT_RADIX + ((key >> (d * 8)) & 0xff)]++;
+    }
+  }
+
+  for(d = 0; d < sizeof(NA_T_TYPE); ++d) {
+    size_t* digitOffsets = &offsets[d * NA_ARRAY_SORT_RADIX];
+    size_t sum = 0;
+    if(digitOffsets[(keys[0] >> (d * 8)) & 0xff] != count) {
+      passMask |= 1u << d;
+    }
+    for(i = 0; i < NA_ARRAY_SORT_RADIX; ++i) {
+      size_t digitCount = digitOffsets[i];
+      digitOffsets[i] = sum;
+      sum += digitCount;
+    }
+  }
+  return passMask;
+}
+
+
+
+// Sorts the keys with a least significant digit radix sort using 8 bit
+// digits. The buffer must have space for count keys.
+NA_HDEF void NA_T1(na_RadixSortArray, NA_T_TYPE)(NA_T_TYPE* keys, NA_T_TYPE* buffer, size_t count) {
+  size_t offsets[sizeof(NA_T_TYPE) * NA_ARRAY_SORT_RADIX];
+  NA_T_TYPE* src = keys;
+  NA_T_TYPE* dst = buffer;
+  NA_T_TYPE* swap;
+  uint32 passMask = NA_T1(na_PrepareRadixSort, NA_T_TYPE)(keys, count, offsets);
+  size_t d;
+  size_t i;
+
+  for(d = 0; d < sizeof(NA_T_TYPE); ++d) {
+    size_t* digitOffsets = &offsets[d * NA_ARRAY_SORT_RADIX];
+    if(!(passMask & (1u << d)))
+      continue;
+    for(i = 0; i < count; ++i) {
+      NA_T_TYPE key = src[i];
+      dst[digitOffsets[(key >> (d * 8)) & 0xff]++] = key;
+    }
+    swap = src;
+    src = dst;
+    dst = swap;
+  }
+
+  if(src != keys) {
+    naCopyn(keys, src, count * sizeof(NA_T_TYPE));
+  }
+}
+
+
+
+// Same as above but additionally moves the indices along with their keys.
+// The result is always stored in keys and indices.
+NA_HDEF void NA_T1(na_RadixSortArrayIndices, NA_T_TYPE)(NA_T_TYPE* keys, NA_T_TYPE* keyBuffer, size_t* indices, size_t* indexBuffer, size_t count) {
+  size_t offsets[sizeof(NA_T_TYPE) * NA_ARRAY_SORT_RADIX];
+  NA_T_TYPE* srcKeys = keys;
+  NA_T_TYPE* dstKeys = keyBuffer;
+  size_t* srcIndices = indices;
+  size_t* dstIndices = indexBuffer;
+  NA_T_TYPE* swapKeys;
+  size_t* swapIndices;
+  uint32 passMask = NA_T1(na_PrepareRadixSort, NA_T_TYPE)(keys, count, offsets);
+  size_t d;
+  size_t i;
+
+  for(d = 0; d < sizeof(NA_T_TYPE); ++d) {
+    size_t* digitOffsets = &offsets[d * NA_ARRAY_SORT_RADIX];
+    if(!(passMask & (1u << d)))
+      continue;
+    for(i = 0; i < count; ++i) {
+      NA_T_TYPE key = srcKeys[i];
+      size_t pos = digitOffsets[(key >> (d * 8)) & 0xff]++;
+      dstKeys[pos] = key;
+      dstIndices[pos] = srcIndices[i];
+    }
+    swapKeys = srcKeys;
+    srcKeys = dstKeys;
+    dstKeys = swapKeys;
+    swapIndices = srcIndices;
+    srcIndices = dstIndices;
+    dstIndices = swapIndices;
+  }
+
+  if(srcIndices != indices) {
+    naCopyn(indices, srcIndices, count * sizeof(size_t));
+  }
+}
+
+
+
+// Sorts the indices by their keys with a stable insertion sort. Only used for
+// a small number of keys.
+NA_HDEF void NA_T1(na_InsertionSortArrayIndices, NA_T_TYPE)(NA_T_TYPE* keys, size_t* indices, size_t count) {
+  size_t i;
+  for(i = 1; i < count; ++i) {
+    NA_T_TYPE key = keys[i];
+    size_t index = indices[i];
+    size_t j = i;
+    while(j > 0 && keys[j - 1] > key) {
+      keys[j] = keys[j - 1];
+      indices[j] = indices[j - 1];
+      j--;
+    }
+    keys[j] = key;
+    indices[j] = index;
+  }
+}
+
+
+
+
+// Sorts the keys choosing the algorithm by their count.
+NA_HDEF void NA_T1(na_SortArrayKeys, NA_T_TYPE)(NA_T_TYPE* keys, size_t count) {
+  if(count <= NA_ARRAY_SORT_SMALL_COUNT) {
+    NA_T_TYPE buffer[NA_ARRAY_SORT_SMALL_COUNT];
+    NA_T1(na_SortArraySmall, NA_T_TYPE)(keys, buffer, count);
+  }else{
+    NA_T_TYPE* buffer = naMalloc(count * sizeof(NA_T_TYPE));
+    NA_T1(na_RadixSortArray, NA_T_TYPE)(keys, buffer, count);
+    naFree(buffer);
+  }
+}
+
+
+
+// Fills indices with the sorted order of the keys. The keys are scratch
+// memory and will be sorted afterwards.
+NA_HDEF void NA_T1(na_SortArrayKeyIndices, NA_T_TYPE)(NA_T_TYPE* keys, size_t* indices, size_t count) {
+  size_t i;
+  for(i = 0; i < count; ++i) {
+    indices[i] = i;
+  }
+  if(count <= NA_ARRAY_SORT_INSERTION_COUNT) {
+    NA_T1(na_InsertionSortArrayIndices, NA_T_TYPE)(keys, indices, count);
+  }else{
+    NA_T_TYPE* keyBuffer = naMalloc(count * sizeof(NA_T_TYPE));
+    size_t* indexBuffer = naMalloc(count * sizeof(size_t));
+    NA_T1(na_RadixSortArrayIndices, NA_T_TYPE)(keys, keyBuffer, indices, indexBuffer, count);
+    naFree(keyBuffer);
+    naFree(indexBuffer);
+  }
+}
+
+
+// This is free and unencumbered software released into the public domain.
+
+// Anyone is free to copy, modify, publish, use, compile, sell, or
+// distribute this software, either in source code form or as a compiled
+// binary, for any purpose, commercial or non-commercial, and by any
+// means.
+
+// In jurisdictions that recognize copyright laws, the author or authors
+// of this software dedicate any and all copyright interest in the
+// software to the public domain. We make this dedication for the benefit
+// of the public at large and to the detriment of our heirs and
+// successors. We intend this dedication to be an overt act of
+// relinquishment in perpetuity of all present and future rights to this
+// software under copyright law.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+
+// For more information, please refer to <http://unlicense.org/>
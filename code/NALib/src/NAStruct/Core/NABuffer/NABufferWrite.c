@@ -1,6 +1,7 @@
 
 #include "../../NABuffer.h"
 #include "../../../NAUtility/NAString.h"
+#include "../../../NAUtility/NAThreading.h"
 
 
 // This is the internal function actually preparing and storing the bytes
@@ -390,6 +391,131 @@ NA_DEF void naWriteBufferLineWithArguments(NABufferIterator* iter, const NAUTF8C
 
 
 
+NA_DEF void naWriteBufferRuntimeTypeStats(NABufferIterator* iter, NARuntimeStatsFormat format) {
+  NARuntimeTypeStats* stats = NA_NULL;
+  size_t typeCount = naGetRuntimeTypeStats(NA_NULL, 0);
+  if(typeCount) {
+    stats = naMalloc(typeCount * sizeof(NARuntimeTypeStats));
+    // Note that the count might have changed in the meantime by some other
+    // thread. We only write what we got.
+    typeCount = naMins(typeCount, naGetRuntimeTypeStats(stats, typeCount));
+  }
+
+  switch(format) {
+  case NA_RUNTIME_STATS_FORMAT_CSV:
+    naWriteBufferStringWithFormat(iter, "typeId,type,typeSize,liveCount,maxLiveCount,allocationCount,partCount,emptyPartCount,reservedBytes,usedBytes");
+    naWriteBufferNewLine(iter);
+    for(size_t i = 0; i < typeCount; ++i) {
+      naWriteBufferStringWithFormat(iter, "%zu,%s,%zu,%zu,%zu,%zu,%zu,%zu,%zu,%zu",
+        stats[i].typeId,
+        stats[i].typeName,
+        stats[i].typeSize,
+        stats[i].liveCount,
+        stats[i].maxLiveCount,
+        stats[i].allocationCount,
+        stats[i].partCount,
+        stats[i].emptyPartCount,
+        stats[i].reservedByteSize,
+        stats[i].usedByteSize);
+      naWriteBufferNewLine(iter);
+    }
+    break;
+  case NA_RUNTIME_STATS_FORMAT_JSON:
+    naWriteBufferStringWithFormat(iter, "[");
+    for(size_t i = 0; i < typeCount; ++i) {
+      naWriteBufferStringWithFormat(iter, "%s", i ? "," : "");
+      naWriteBufferNewLine(iter);
+      naWriteBufferStringWithFormat(iter, "  {\"typeId\": %zu, \"type\": \"%s\", \"typeSize\": %zu, \"liveCount\": %zu, \"maxLiveCount\": %zu, \"allocationCount\": %zu, \"partCount\": %zu, \"emptyPartCount\": %zu, \"reservedBytes\": %zu, \"usedBytes\": %zu}",
+        stats[i].typeId,
+        stats[i].typeName,
+        stats[i].typeSize,
+        stats[i].liveCount,
+        stats[i].maxLiveCount,
+        stats[i].allocationCount,
+        stats[i].partCount,
+        stats[i].emptyPartCount,
+        stats[i].reservedByteSize,
+        stats[i].usedByteSize);
+    }
+    naWriteBufferNewLine(iter);
+    naWriteBufferStringWithFormat(iter, "]");
+    naWriteBufferNewLine(iter);
+    break;
+  }
+
+  if(stats) {
+    naFree(stats);
+  }
+}
+
+
+
+NA_DEF void naWriteBufferMutexStats(NABufferIterator* iter, NARuntimeStatsFormat format) {
+  NAMutexStats* stats = NA_NULL;
+  size_t mutexCount = naGetMutexStats(NA_NULL, 0);
+  if(mutexCount) {
+    stats = naMalloc(mutexCount * sizeof(NAMutexStats));
+    // Mutexes might have been cleared in the meantime by some other thread.
+    // We only write what we got.
+    mutexCount = naMins(mutexCount, naGetMutexStats(stats, mutexCount));
+  }
+
+  switch(format) {
+  case NA_RUNTIME_STATS_FORMAT_CSV:
+    naWriteBufferStringWithFormat(iter, "name,acquireCount,contendedCount,failedTryCount,totalWaitTime,maxWaitTime");
+    for(size_t h = 0; h < NA_MUTEX_HOLD_HISTOGRAM_COUNT - 1; ++h) {
+      naWriteBufferStringWithFormat(iter, ",holdBelow%zuus", (size_t)1 << h);
+    }
+    naWriteBufferStringWithFormat(iter, ",holdLonger");
+    naWriteBufferNewLine(iter);
+    for(size_t i = 0; i < mutexCount; ++i) {
+      naWriteBufferStringWithFormat(iter, "%s,%zu,%zu,%zu,%f,%f",
+        stats[i].name ? stats[i].name : "",
+        stats[i].acquireCount,
+        stats[i].contendedCount,
+        stats[i].failedTryCount,
+        stats[i].totalWaitTime,
+        stats[i].maxWaitTime);
+      for(size_t h = 0; h < NA_MUTEX_HOLD_HISTOGRAM_COUNT; ++h) {
+        naWriteBufferStringWithFormat(iter, ",%zu", stats[i].holdHistogram[h]);
+      }
+      naWriteBufferNewLine(iter);
+    }
+    break;
+  case NA_RUNTIME_STATS_FORMAT_JSON:
+    naWriteBufferStringWithFormat(iter, "[");
+    for(size_t i = 0; i < mutexCount; ++i) {
+      naWriteBufferStringWithFormat(iter, "%s", i ? "," : "");
+      naWriteBufferNewLine(iter);
+      if(stats[i].name) {
+        naWriteBufferStringWithFormat(iter, "  {\"name\": \"%s\", ", stats[i].name);
+      }else{
+        naWriteBufferStringWithFormat(iter, "  {\"name\": null, ");
+      }
+      naWriteBufferStringWithFormat(iter, "\"acquireCount\": %zu, \"contendedCount\": %zu, \"failedTryCount\": %zu, \"totalWaitTime\": %f, \"maxWaitTime\": %f, \"holdHistogram\": [",
+        stats[i].acquireCount,
+        stats[i].contendedCount,
+        stats[i].failedTryCount,
+        stats[i].totalWaitTime,
+        stats[i].maxWaitTime);
+      for(size_t h = 0; h < NA_MUTEX_HOLD_HISTOGRAM_COUNT; ++h) {
+        naWriteBufferStringWithFormat(iter, "%s%zu", h ? ", " : "", stats[i].holdHistogram[h]);
+      }
+      naWriteBufferStringWithFormat(iter, "]}");
+    }
+    naWriteBufferNewLine(iter);
+    naWriteBufferStringWithFormat(iter, "]");
+    naWriteBufferNewLine(iter);
+    break;
+  }
+
+  if(stats) {
+    naFree(stats);
+  }
+}
+
+
+
 // This is free and unencumbered software released into the public domain.
 
 // Anyone is free to copy, modify, publish, use, compile, sell, or
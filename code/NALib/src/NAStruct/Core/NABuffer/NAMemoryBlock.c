@@ -15,11 +15,18 @@ NA_HDEF NAMemoryBlock* na_CreateMemoryBlock(size_t byteSize) {
   #endif
 
   NAMemoryBlock* block = naCreate(NAMemoryBlock);
-  block->data = naMakePtrWithDataMutable(naMalloc(byteSize));
-  block->destructor = (NAMutator)naFree;
-  #if NA_DEBUG
-    block->byteSize = byteSize;
-  #endif
+  // Big blocks are mapped directly from the system such that they can be
+  // backed by huge pages. Huge pages only back ranges aligned to their size.
+  if(byteSize >= NA_HUGE_PAGE_BYTESIZE) {
+    block->data = naMakePtrWithDataMutable(naMallocMapped(byteSize, NA_HUGE_PAGE_BYTESIZE));
+    block->destructor = NA_NULL;
+    block->mapped = NA_TRUE;
+  }else{
+    block->data = naMakePtrWithDataMutable(naMalloc(byteSize));
+    block->destructor = (NAMutator)naFree;
+    block->mapped = NA_FALSE;
+  }
+  block->byteSize = byteSize;
   return block;
 }
 
@@ -34,22 +41,21 @@ NA_HDEF NAMemoryBlock* na_CreateMemoryBlockWithData(NAPtr data, size_t byteSize,
       naError("byteSize is zero");
     if(naIsPtrConst(data) && destructor != NA_NULL)
       naError("having a destructor for const data probably is not correct.");
-  #else
-    NA_UNUSED(byteSize);
   #endif
   block = naCreate(NAMemoryBlock);
   block->data = data;
   block->destructor = destructor;
-  #if NA_DEBUG
-    block->byteSize = byteSize;
-  #endif
+  block->byteSize = byteSize;
+  block->mapped = NA_FALSE;
   return block;
 }
 
 
 
 NA_HDEF void na_DestructMemoryBlock(NAMemoryBlock* block) {
-  if(block->destructor) {
+  if(block->mapped) {
+    naFreeMapped(naGetPtrMutable(block->data), block->byteSize);
+  }else if(block->destructor) {
     block->destructor(naGetPtrMutable(block->data));
   }
 }
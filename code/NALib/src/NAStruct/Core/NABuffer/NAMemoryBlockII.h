@@ -9,9 +9,8 @@ struct NAMemoryBlock{
   // automatic reference counting implemented as runtime type.
   NAPtr     data;
   NAMutator destructor;
-  #if NA_DEBUG
-    size_t  byteSize;
-  #endif
+  size_t    byteSize;
+  NABool    mapped;     // Data allocated with naMallocMapped.
 };
 
 
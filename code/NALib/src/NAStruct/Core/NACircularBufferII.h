@@ -1,57 +1,284 @@
-
 // This file contains inline implementations of the file NACircularBuffer.h
 // Do not include this file directly! It will automatically be included when
 // including "NACircularBuffer.h"
 
-#ifndef NA_CIRCULAR_BUFFER_INCLUDED
-#define NA_CIRCULAR_BUFFER_INCLUDED
-
 #include "../../NAUtility/NAMemory.h"
 
 
+
+// The buffer counts all elements ever pushed in tail and all elements ever
+// pulled in head. The slot of a counter is the counter masked with the
+// capacity. As the counters never wrap around in practice, the buffer is
+// empty when both are equal and full when they differ by the capacity.
+//
+// In SPSC mode, every side keeps a copy of the counter of the other side
+// and only reloads it when the copy says the buffer is full or empty. This
+// keeps the cache line of the other side from bouncing with every element.
+//
+// In MPMC mode, every slot has a sequence number. A slot can be written by
+// the producer which claimed counter position p if its sequence equals p
+// and read by the consumer which claimed position p if it equals p + 1.
+
+#define NA_CIRCULAR_BUFFER_PADDING (NA_CACHE_LINE_BYTESIZE - 2 * sizeof(int64))
+
 struct NACircularBuffer{
-  int64 space;
-  int64 cur;
-  int64 last;
   void** data;
+  int64* sequences;             // Only used in MPMC mode.
+  int64 capacity;               // Always a power of two.
+  NACircularBufferMode mode;
+  NAByte padding0[NA_CACHE_LINE_BYTESIZE];
+
+  int64 head;                   // Pulling side.
+  int64 cachedTail;
+  NAByte padding1[NA_CIRCULAR_BUFFER_PADDING];
+
+  int64 tail;                   // Pushing side.
+  int64 cachedHead;
+  NAByte padding2[NA_CIRCULAR_BUFFER_PADDING];
 };
 
 
-NACircularBuffer* naInitCircularBuffer(NACircularBuffer* buffer, int64 count) {
-  buffer->space = count + 1;
-  buffer->cur = 0;
-  buffer->last = 0;
-  buffer->data = naMalloc(sizeof(void*) * buffer->space);
+
+NA_IDEF NACircularBuffer* naInitCircularBuffer(NACircularBuffer* buffer, size_t count) {
+  return naInitCircularBufferWithMode(buffer, count, NA_CIRCULAR_BUFFER_SERIAL);
+}
+
+
+
+NA_IDEF NACircularBuffer* naInitCircularBufferWithMode(NACircularBuffer* buffer, size_t count, NACircularBufferMode mode) {
+  int64 capacity = 1;
+  #if NA_DEBUG
+    if(!buffer)
+      naCrash("buffer is nullptr");
+    if(count == 0)
+      naError("count is zero");
+  #endif
+  while((size_t)capacity < count)
+    capacity <<= 1;
+
+  buffer->capacity = capacity;
+  buffer->mode = mode;
+  buffer->data = naMalloc(sizeof(void*) * (size_t)capacity);
+  buffer->sequences = NA_NULL;
+  if(mode == NA_CIRCULAR_BUFFER_MPMC) {
+    int64 i;
+    buffer->sequences = naMalloc(sizeof(int64) * (size_t)capacity);
+    for(i = 0; i < capacity; ++i)
+      buffer->sequences[i] = i;
+  }
+  buffer->head = 0;
+  buffer->cachedTail = 0;
+  buffer->tail = 0;
+  buffer->cachedHead = 0;
   return buffer;
 }
 
 
-void naClearCircularBuffer(NACircularBuffer* buffer) {
+
+NA_IDEF void naClearCircularBuffer(NACircularBuffer* buffer) {
   naFree(buffer->data);
+  if(buffer->sequences)
+    naFree(buffer->sequences);
+}
+
+
+
+NA_IDEF size_t naGetCircularBufferCapacity(const NACircularBuffer* buffer) {
+  return (size_t)buffer->capacity;
+}
+
+
+
+NA_IDEF size_t naGetCircularBufferCount(const NACircularBuffer* buffer) {
+  if(buffer->mode == NA_CIRCULAR_BUFFER_SERIAL)
+    return (size_t)(buffer->tail - buffer->head);
+
+  // Read head first: The count can then only be too high, never negative.
+  int64 head = naAtomicLoadi64(&buffer->head, NA_MEMORY_ORDER_ACQUIRE);
+  int64 tail = naAtomicLoadi64(&buffer->tail, NA_MEMORY_ORDER_ACQUIRE);
+  int64 count = tail - head;
+  if(count < 0)
+    return 0;
+  return (size_t)((count > buffer->capacity) ? buffer->capacity : count);
+}
+
+
+
+NA_HIDEF NABool na_TryPushCircularBufferMPMC(NACircularBuffer* buffer, void* newData) {
+  int64 mask = buffer->capacity - 1;
+  int64 pos = naAtomicLoadi64(&buffer->tail, NA_MEMORY_ORDER_RELAXED);
+  while(1) {
+    int64 sequence = naAtomicLoadi64(&buffer->sequences[pos & mask], NA_MEMORY_ORDER_ACQUIRE);
+    int64 difference = sequence - pos;
+    if(difference == 0) {
+      // The slot is free, try to claim it.
+      if(naAtomicCompareExchangei64(&buffer->tail, &pos, pos + 1, NA_MEMORY_ORDER_RELAXED))
+        break;
+    }else if(difference < 0) {
+      // The slot still contains the element of the previous round.
+      return NA_FALSE;
+    }else{
+      // Some other producer has been faster.
+      pos = naAtomicLoadi64(&buffer->tail, NA_MEMORY_ORDER_RELAXED);
+    }
+  }
+  buffer->data[pos & mask] = newData;
+  naAtomicStorei64(&buffer->sequences[pos & mask], pos + 1, NA_MEMORY_ORDER_RELEASE);
+  return NA_TRUE;
 }
 
 
-void* naPullCircularBuffer(NACircularBuffer* buffer) {
+
+NA_HIDEF NABool na_TryPullCircularBufferMPMC(NACircularBuffer* buffer, void** data) {
+  int64 mask = buffer->capacity - 1;
+  int64 pos = naAtomicLoadi64(&buffer->head, NA_MEMORY_ORDER_RELAXED);
+  while(1) {
+    int64 sequence = naAtomicLoadi64(&buffer->sequences[pos & mask], NA_MEMORY_ORDER_ACQUIRE);
+    int64 difference = sequence - (pos + 1);
+    if(difference == 0) {
+      if(naAtomicCompareExchangei64(&buffer->head, &pos, pos + 1, NA_MEMORY_ORDER_RELAXED))
+        break;
+    }else if(difference < 0) {
+      // The slot has not been written yet.
+      return NA_FALSE;
+    }else{
+      pos = naAtomicLoadi64(&buffer->head, NA_MEMORY_ORDER_RELAXED);
+    }
+  }
+  *data = buffer->data[pos & mask];
+  // Make the slot available for the producer of the next round.
+  naAtomicStorei64(&buffer->sequences[pos & mask], pos + buffer->capacity, NA_MEMORY_ORDER_RELEASE);
+  return NA_TRUE;
+}
+
+
+
+NA_IDEF size_t naPushCircularBufferN(NACircularBuffer* buffer, void* const* newData, size_t count) {
+  int64 mask = buffer->capacity - 1;
+  int64 tail;
+  int64 free;
+  size_t i;
+
+  switch(buffer->mode) {
+  case NA_CIRCULAR_BUFFER_SERIAL:
+    tail = buffer->tail;
+    free = buffer->capacity - (tail - buffer->head);
+    if((int64)count > free)
+      count = (size_t)free;
+    for(i = 0; i < count; ++i)
+      buffer->data[(tail + (int64)i) & mask] = newData[i];
+    buffer->tail = tail + (int64)count;
+    return count;
+
+  case NA_CIRCULAR_BUFFER_SPSC:
+    tail = buffer->tail;
+    free = buffer->capacity - (tail - buffer->cachedHead);
+    if((int64)count > free) {
+      buffer->cachedHead = naAtomicLoadi64(&buffer->head, NA_MEMORY_ORDER_ACQUIRE);
+      free = buffer->capacity - (tail - buffer->cachedHead);
+      if((int64)count > free)
+        count = (size_t)free;
+    }
+    for(i = 0; i < count; ++i)
+      buffer->data[(tail + (int64)i) & mask] = newData[i];
+    naAtomicStorei64(&buffer->tail, tail + (int64)count, NA_MEMORY_ORDER_RELEASE);
+    return count;
+
+  case NA_CIRCULAR_BUFFER_MPMC:
+    for(i = 0; i < count; ++i) {
+      if(!na_TryPushCircularBufferMPMC(buffer, newData[i]))
+        break;
+    }
+    return i;
+  }
+  return 0;
+}
+
+
+
+NA_IDEF size_t naPullCircularBufferN(NACircularBuffer* buffer, void** data, size_t count) {
+  int64 mask = buffer->capacity - 1;
+  int64 head;
+  int64 available;
+  size_t i;
+
+  switch(buffer->mode) {
+  case NA_CIRCULAR_BUFFER_SERIAL:
+    head = buffer->head;
+    available = buffer->tail - head;
+    if((int64)count > available)
+      count = (size_t)available;
+    for(i = 0; i < count; ++i)
+      data[i] = buffer->data[(head + (int64)i) & mask];
+    buffer->head = head + (int64)count;
+    return count;
+
+  case NA_CIRCULAR_BUFFER_SPSC:
+    head = buffer->head;
+    available = buffer->cachedTail - head;
+    if((int64)count > available) {
+      buffer->cachedTail = naAtomicLoadi64(&buffer->tail, NA_MEMORY_ORDER_ACQUIRE);
+      available = buffer->cachedTail - head;
+      if((int64)count > available)
+        count = (size_t)available;
+    }
+    for(i = 0; i < count; ++i)
+      data[i] = buffer->data[(head + (int64)i) & mask];
+    naAtomicStorei64(&buffer->head, head + (int64)count, NA_MEMORY_ORDER_RELEASE);
+    return count;
+
+  case NA_CIRCULAR_BUFFER_MPMC:
+    for(i = 0; i < count; ++i) {
+      if(!na_TryPullCircularBufferMPMC(buffer, &data[i]))
+        break;
+    }
+    return i;
+  }
+  return 0;
+}
+
+
+
+NA_IDEF NABool naTryPushCircularBuffer(NACircularBuffer* buffer, void* newData) {
+  if(buffer->mode == NA_CIRCULAR_BUFFER_MPMC)
+    return na_TryPushCircularBufferMPMC(buffer, newData);
+  return naPushCircularBufferN(buffer, &newData, 1) == 1;
+}
+
+
+
+NA_IDEF NABool naTryPullCircularBuffer(NACircularBuffer* buffer, void** data) {
+  if(buffer->mode == NA_CIRCULAR_BUFFER_MPMC)
+    return na_TryPullCircularBufferMPMC(buffer, data);
+  return naPullCircularBufferN(buffer, data, 1) == 1;
+}
+
+
+
+NA_IDEF void* naPullCircularBuffer(NACircularBuffer* buffer) {
+  void* retValue = NA_NULL;
+  NABool success = naTryPullCircularBuffer(buffer, &retValue);
   #if NA_DEBUG
-    if(buffer->last == buffer->cur)
+    if(!success)
       naError("Buffer is empty");
+  #else
+    NA_UNUSED(success);
   #endif
-  void* retValue = buffer->data[buffer->cur];
-  buffer->cur = buffer->cur % buffer->space;
   return retValue;
 }
 
 
-void naPushCircularBuffer(NACircularBuffer* buffer, void* newData) {
-  buffer->data[buffer->last] = newData;
-  buffer->last = buffer->last % buffer->space;
+
+NA_IDEF void naPushCircularBuffer(NACircularBuffer* buffer, void* newData) {
+  NABool success = naTryPushCircularBuffer(buffer, newData);
   #if NA_DEBUG
-    if(buffer->last == buffer->cur)
-      naError("Buffer did just overflow");
+    if(!success)
+      naError("Buffer is full");
+  #else
+    NA_UNUSED(success);
   #endif
 }
 
-#endif // NA_CIRCULAR_BUFFER_INCLUDED
 
 
 // This is free and unencumbered software released into the public domain.
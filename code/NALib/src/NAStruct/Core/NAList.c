@@ -7,6 +7,53 @@ NA_RUNTIME_TYPE(NAListElement, NA_NULL, NA_FALSE);
 
 
 
+NA_DEF NAList* naInitListWithSlab(NAList* list, size_t elementsPerChunk) {
+  naInitList(list);
+  if(!elementsPerChunk) {
+    elementsPerChunk = (naGetSystemMemoryPagesize() - sizeof(void*)) / sizeof(NAListElement);
+    if(!elementsPerChunk)
+      elementsPerChunk = 1;
+  }
+  list->slab = naAlloc(NA_ListSlab);
+  list->slab->freeElements = NA_NULL;
+  list->slab->chunks = NA_NULL;
+  list->slab->elementsPerChunk = elementsPerChunk;
+  return list;
+}
+
+
+
+NA_HDEF NAListElement* na_AddListSlabChunk(NA_ListSlab* slab) {
+  // The elements follow the pointer to the next chunk.
+  void** chunk = naMalloc(sizeof(void*) + slab->elementsPerChunk * sizeof(NAListElement));
+  *chunk = slab->chunks;
+  slab->chunks = chunk;
+
+  // Put all elements into the free list, keeping them in ascending order
+  // such that consecutive additions get consecutive addresses.
+  NAListElement* elements = (NAListElement*)(chunk + 1);
+  for(size_t i = 0; i < slab->elementsPerChunk - 1; ++i) {
+    elements[i].next = &elements[i + 1];
+  }
+  elements[slab->elementsPerChunk - 1].next = slab->freeElements;
+  slab->freeElements = elements;
+  return elements;
+}
+
+
+
+NA_HDEF void na_ClearListSlab(NA_ListSlab* slab) {
+  void* chunk = slab->chunks;
+  while(chunk) {
+    void* nextChunk = *(void**)chunk;
+    naFree(chunk);
+    chunk = nextChunk;
+  }
+  naFree(slab);
+}
+
+
+
 NA_DEF NABool naLocateListData(NAListIterator* iter, const void* data) {
   // todo: search in left-right exponential search starting from the current
   // position.
@@ -96,6 +143,193 @@ NA_DEF NABool naLocateListIndexBack(NAListIterator* iter, size_t index) {
 
 
 
+
+NA_DEF void naSpliceListRange(
+  NAListIterator* srcBegin,
+  NAListIterator* srcEnd,
+  NAListIterator* dstIter,
+  size_t count)
+{
+  NAList* src;
+  NAList* dst;
+  NAListElement* first;
+  NAListElement* last;
+  NAListElement* pos;
+  #if NA_DEBUG
+    NAListElement* testelem;
+    size_t testcount;
+    if(!srcBegin->mutator || !srcEnd->mutator || !dstIter->mutator)
+      naError("Trying to mutate elements with an accessor");
+    if(naIsPtrConst(srcBegin->listptr) || naIsPtrConst(dstIter->listptr))
+      naError("Trying to modify list while iterator is no modifier");
+    if(naGetPtrConst(srcBegin->listptr) != naGetPtrConst(srcEnd->listptr))
+      naError("srcBegin and srcEnd belong to different lists.");
+  #endif
+  src = (NAList*)naGetPtrMutable(srcBegin->listptr);
+  dst = (NAList*)naGetPtrMutable(dstIter->listptr);
+  #if NA_DEBUG
+    na_CheckListMove(src, dst);
+  #endif
+
+  first = srcBegin->cur;
+  if(first == srcEnd->cur)
+    return;
+  #if NA_DEBUG
+    if(first == &src->sentinel)
+      naError("srcBegin is at initial position but srcEnd is not.");
+  #endif
+  last = srcEnd->cur->prev;
+  pos = dstIter->cur;
+
+  #if NA_DEBUG
+    // Walk the range: It must end at srcEnd, must not contain dstIter and no
+    // element other than the first one must have an iterator.
+    testcount = 0;
+    testelem = first;
+    while(testelem != srcEnd->cur) {
+      if(testelem == &src->sentinel) {
+        naError("srcEnd is positioned before srcBegin.");
+        return;
+      }
+      if(testelem == pos)
+        naError("dstIter is positioned within the range.");
+      if(testelem->iterCount > (size_t)(testelem == first))
+        naError("Element still has an iterator");
+      testcount++;
+      testelem = testelem->next;
+    }
+    if(count != NA_LIST_UNKNOWN_COUNT && count != testcount)
+      naError("count does not match the number of elements in the range.");
+
+    // Only now that the whole range is valid, the elements belong to dst.
+    testelem = first;
+    while(testelem != srcEnd->cur) {
+      testelem->list = dst;
+      testelem = testelem->next;
+    }
+  #endif
+
+  if(src != dst) {
+    if(count == NA_LIST_UNKNOWN_COUNT) {
+      NAListElement* element = first;
+      count = 1;
+      while(element != last) {
+        count++;
+        element = element->next;
+      }
+    }
+    #if NA_DEBUG
+      if(src->count < count)
+        naError("List count negative.");
+      if(dst->count + count < dst->count)
+        naError("Integer overflow");
+    #endif
+    src->count -= count;
+    dst->count += count;
+  }
+
+  // Unlink the range from src.
+  first->prev->next = srcEnd->cur;
+  srcEnd->cur->prev = first->prev;
+
+  // Link the range right before the dst position.
+  first->prev = pos->prev;
+  last->next = pos;
+  pos->prev->next = first;
+  pos->prev = last;
+
+  #if NA_DEBUG
+    first->iterCount--;
+    srcEnd->cur->iterCount++;
+  #endif
+  srcBegin->cur = srcEnd->cur;
+}
+
+
+
+// Merges two sorted chains of elements linked by their next pointers and
+// ending with a null pointer. Elements of a come before equal ones of b.
+NA_HDEF NAListElement* na_MergeListElements(
+  NAListElement* a,
+  NAListElement* b,
+  NAComparator comparator)
+{
+  NAListElement* first;
+  NAListElement** link = &first;
+  while(a && b) {
+    if(comparator(naGetPtrConst(b->ptr), naGetPtrConst(a->ptr)) < 0) {
+      *link = b;
+      b = b->next;
+    }else{
+      *link = a;
+      a = a->next;
+    }
+    link = &((*link)->next);
+  }
+  *link = a ? a : b;
+  return first;
+}
+
+
+
+// Each bin i holds either nothing or a sorted chain of 2^i elements, just
+// like the bits of a binary counter. As a list can not have more than 2^64
+// elements, 64 bins are enough.
+#define NA_LIST_SORT_BIN_COUNT 64
+
+NA_DEF void naSortList(NAList* list, NAComparator comparator) {
+  NAListElement* bins[NA_LIST_SORT_BIN_COUNT] = {NA_NULL};
+  NAListElement* element;
+  NAListElement* carry;
+  NAListElement* prev;
+  size_t i;
+
+  #if NA_DEBUG
+    if(list->iterCount)
+      naError("List still has iterators operating upon the elements.");
+    if(!comparator)
+      naCrash("comparator is nullptr");
+  #endif
+
+  if(list->count < 2)
+    return;
+
+  // Detach the elements from the sentinel and feed them one by one into the
+  // bins. Bins with a higher index always contain elements which came
+  // earlier in the list, therefore merging them first keeps the sort stable.
+  list->sentinel.prev->next = NA_NULL;
+  element = list->sentinel.next;
+  while(element) {
+    carry = element;
+    element = element->next;
+    carry->next = NA_NULL;
+    for(i = 0; bins[i]; ++i) {
+      carry = na_MergeListElements(bins[i], carry, comparator);
+      bins[i] = NA_NULL;
+    }
+    bins[i] = carry;
+  }
+
+  carry = NA_NULL;
+  for(i = 0; i < NA_LIST_SORT_BIN_COUNT; ++i) {
+    if(bins[i]) {
+      carry = na_MergeListElements(bins[i], carry, comparator);
+    }
+  }
+
+  // Restore the prev pointers and reattach the sentinel.
+  prev = &list->sentinel;
+  list->sentinel.next = carry;
+  while(carry) {
+    carry->prev = prev;
+    prev = carry;
+    carry = carry->next;
+  }
+  prev->next = &list->sentinel;
+  list->sentinel.prev = prev;
+}
+
+
 // This is free and unencumbered software released into the public domain.
 
 // Anyone is free to copy, modify, publish, use, compile, sell, or
@@ -9,9 +9,10 @@
 
 
 // The following struct should be opaque. Or even better: Completely invisible
-// to the programmer.
-NA_PROTOTYPE(NAListElement);
+// to the programmer. Only intrusive lists need it to be complete.
+NA_PROTOTYPE(NA_ListSlab);
 
+#define NA_LIST_NOT_INTRUSIVE NA_MAX_s
 
 struct NAListElement{
   NAPtr ptr;            // A pointer to the stored content
@@ -29,6 +30,9 @@ struct NAList{
   NAListElement sentinel; // The sentinel of the list.
                           // Stores the first and last element of the list
                           // as next and prev pointer. The content is NA_NULL.
+  size_t elementOffset;   // Offset of the element within the content for
+                          // intrusive lists or NA_LIST_NOT_INTRUSIVE.
+  NA_ListSlab* slab;      // The slab of the list or NA_NULL to use naNew.
   #if NA_DEBUG
     size_t iterCount;     // debugging iterator count
   #endif
@@ -45,6 +49,19 @@ struct NAListIterator{
   #endif
 };
 
+// The slab keeps removed elements in a singly linked free list using their
+// next pointers. Only when the free list is empty, a new chunk is allocated.
+struct NA_ListSlab{
+  NAListElement* freeElements;
+  void* chunks;            // Every chunk starts with a pointer to the next.
+  size_t elementsPerChunk;
+};
+
+NA_HAPI NAListElement* na_AddListSlabChunk(NA_ListSlab* slab);
+NA_HAPI void na_ClearListSlab(NA_ListSlab* slab);
+
+
+
 NA_IDEF NAListElement* naNewListElement(NAListElement* prev, NAListElement* next) {
   NAListElement* elem = naNew(NAListElement);
   elem->prev = prev;
@@ -56,6 +73,58 @@ NA_IDEF NAListElement* naNewListElement(NAListElement* prev, NAListElement* next
 }
 
 
+
+// Returns the element to store the given content in, depending on the kind
+// of the list.
+NA_HIDEF NAListElement* na_NewListElement(NAList* list, const void* content, NAListElement* prev, NAListElement* next) {
+  NAListElement* elem;
+  if(list->elementOffset != NA_LIST_NOT_INTRUSIVE) {
+    #if NA_DEBUG
+      if(!content)
+        naCrash("Intrusive lists can not store nullptr.");
+    #endif
+    elem = (NAListElement*)((NAByte*)content + list->elementOffset);
+  }else if(list->slab) {
+    elem = list->slab->freeElements;
+    if(!elem)
+      elem = na_AddListSlabChunk(list->slab);
+    list->slab->freeElements = elem->next;
+  }else{
+    return naNewListElement(prev, next);
+  }
+  elem->prev = prev;
+  elem->next = next;
+  #if NA_DEBUG
+    elem->iterCount = 0;
+  #endif
+  return elem;
+}
+
+
+
+NA_HIDEF void na_DeleteListElement(NAList* list, NAListElement* elem) {
+  if(list->elementOffset != NA_LIST_NOT_INTRUSIVE) {
+    // The element belongs to the content.
+  }else if(list->slab) {
+    elem->next = list->slab->freeElements;
+    list->slab->freeElements = elem;
+  }else{
+    naDelete(elem);
+  }
+}
+
+
+
+#if NA_DEBUG
+  NA_HIDEF void na_CheckListMove(const NAList* src, const NAList* dst) {
+    if(src != dst && (src->slab || dst->slab))
+      naError("Elements of a list with a slab can not be moved to another list.");
+    if(src->elementOffset != dst->elementOffset)
+      naError("Elements can only be moved between lists of the same kind.");
+  }
+#endif
+
+
 NA_IDEF NAList* naInitList(NAList* list) {
   #if NA_DEBUG
     if(!list)
@@ -65,6 +134,8 @@ NA_IDEF NAList* naInitList(NAList* list) {
   list->sentinel.ptr  = naMakePtrNull();
   list->sentinel.next = &list->sentinel;
   list->sentinel.prev = &list->sentinel;
+  list->elementOffset = NA_LIST_NOT_INTRUSIVE;
+  list->slab = NA_NULL;
   #if NA_DEBUG
     list->sentinel.list = list;
     list->sentinel.iterCount = 0;
@@ -75,6 +146,14 @@ NA_IDEF NAList* naInitList(NAList* list) {
 
 
 
+NA_IDEF NAList* naInitListIntrusive(NAList* list, size_t elementOffset) {
+  naInitList(list);
+  list->elementOffset = elementOffset;
+  return list;
+}
+
+
+
 NA_IDEF NAList* naInitListWithCopy(NAList* list, NAList* originalList) {
   NAListElement* cur;
   #if NA_DEBUG
@@ -106,6 +185,10 @@ NA_IDEF void naClearList(NAList* list, NAMutator elementDestructor) {
   #endif
 
   naEmptyList(list, elementDestructor);
+  if(list->slab) {
+    na_ClearListSlab(list->slab);
+    list->slab = NA_NULL;
+  }
 }
 
 
@@ -116,13 +199,12 @@ NA_IDEF void naEmptyList(NAList* list, NAMutator elementDestructor) {
       naCrash("list is nullptr");
   #endif
 
-  if(elementDestructor) {
-    naForeachListMutable(list, elementDestructor);
-  }
-
   NAListElement* cur;
   NAListElement* next;
 
+  // Note that the element of an intrusive list may be destroyed together with
+  // its content. Therefore, the destructor is called after the element is
+  // not used anymore.
   cur = list->sentinel.next;
   while(cur != &list->sentinel) {
     #if NA_DEBUG
@@ -130,7 +212,10 @@ NA_IDEF void naEmptyList(NAList* list, NAMutator elementDestructor) {
         naError("Iterators still running on a list element. Did you use naClearListIterator?");
     #endif
     next = cur->next;
-    naDelete(cur);
+    void* content = elementDestructor ? naGetPtrMutable(cur->ptr) : NA_NULL;
+    na_DeleteListElement(list, cur);
+    if(elementDestructor)
+      elementDestructor(content);
     cur = next;
   }
   list->count = 0;
@@ -180,25 +265,25 @@ NA_HIDEF void na_InjectMutableListElement(NAList* list, NAListElement* element,
 
 
 NA_IDEF void naAddListFirstConst(NAList* list, const void* content) {
-  NAListElement* newelement = naNewListElement(&list->sentinel, list->sentinel.next);
+  NAListElement* newelement = na_NewListElement(list, content, &list->sentinel, list->sentinel.next);
   na_InjectConstListElement(list, newelement, content);
 }
 
 
 NA_IDEF void naAddListFirstMutable(NAList* list, void* content) {
-  NAListElement* newelement = naNewListElement(&list->sentinel, list->sentinel.next);
+  NAListElement* newelement = na_NewListElement(list, content, &list->sentinel, list->sentinel.next);
   na_InjectMutableListElement(list, newelement, content);
 }
 
 
 NA_IDEF void naAddListLastConst(NAList* list, const void* content) {
-  NAListElement* newelement = naNewListElement(list->sentinel.prev, &list->sentinel);
+  NAListElement* newelement = na_NewListElement(list, content, list->sentinel.prev, &list->sentinel);
   na_InjectConstListElement(list, newelement, content);
 }
 
 
 NA_IDEF void naAddListLastMutable(NAList* list, void* content) {
-  NAListElement* newelement = naNewListElement(list->sentinel.prev, &list->sentinel);
+  NAListElement* newelement = na_NewListElement(list, content, list->sentinel.prev, &list->sentinel);
   na_InjectMutableListElement(list, newelement, content);
 }
 
@@ -222,7 +307,7 @@ NA_HIDEF void na_EjectList(NAList* list, NAListElement* element, NABool deleteEl
   list->count--;
   
   if(deleteElement)
-    naDelete(element);
+    na_DeleteListElement(list, element);
 }
 
 
@@ -453,6 +538,7 @@ NA_IDEF void naMoveListToLast(NAList* src, NAList* dst) {
   #if NA_DEBUG
     if(src->iterCount)
       naError("Src list still has iterators operating upon the elements.");
+    na_CheckListMove(src, dst);
   #endif
 
   if(!naIsListEmpty(src)) {
@@ -481,6 +567,7 @@ NA_IDEF void naMoveListToLast(NAList* src, NAList* dst) {
 NA_IDEF void naMoveListFirstToLast(NAList* src, NAList* dst) {
   NAListElement* element;
   #if NA_DEBUG
+    na_CheckListMove(src, dst);
     if(naIsListEmpty(src))
       naError("Src List has no first element because it is empty.");
     if(src->sentinel.next->iterCount)
@@ -772,7 +859,7 @@ NA_IDEF void naAddListBeforeConst(NAListIterator* iter, const void* content) {
     if(naIsPtrConst(iter->listptr))
       naError("Trying to modify list while iterator is no modifier");
   #endif
-  newelement = naNewListElement(iter->cur->prev, iter->cur);
+  newelement = na_NewListElement((NAList*)naGetPtrConst(iter->listptr), content, iter->cur->prev, iter->cur);
   na_InjectConstListElement((NAList*)naGetPtrConst(iter->listptr), newelement, content);
 }
 
@@ -785,7 +872,7 @@ NA_IDEF void naAddListBeforeMutable(NAListIterator* iter, void* content) {
     if(naIsPtrConst(iter->listptr))
       naError("Trying to modify list while iterator is no modifier");
   #endif
-  newelement = naNewListElement(iter->cur->prev, iter->cur);
+  newelement = na_NewListElement((NAList*)naGetPtrConst(iter->listptr), content, iter->cur->prev, iter->cur);
   na_InjectMutableListElement((NAList*)naGetPtrMutable(iter->listptr), newelement, content);
 }
 
@@ -798,7 +885,7 @@ NA_IDEF void naAddListAfterConst(NAListIterator* iter, const void* content) {
     if(naIsPtrConst(iter->listptr))
       naError("Trying to modify list while iterator is no modifier");
   #endif
-  newelement = naNewListElement(iter->cur, iter->cur->next);
+  newelement = na_NewListElement((NAList*)naGetPtrConst(iter->listptr), content, iter->cur, iter->cur->next);
   na_InjectConstListElement((NAList*)naGetPtrConst(iter->listptr), newelement, content);
 }
 
@@ -811,7 +898,7 @@ NA_IDEF void naAddListAfterMutable(NAListIterator* iter, void* content) {
     if(naIsPtrConst(iter->listptr))
       naError("Trying to modify list while iterator is no modifier");
   #endif
-  newelement = naNewListElement(iter->cur, iter->cur->next);
+  newelement = na_NewListElement((NAList*)naGetPtrConst(iter->listptr), content, iter->cur, iter->cur->next);
   na_InjectMutableListElement((NAList*)naGetPtrMutable(iter->listptr), newelement, content);
 }
 
@@ -1006,6 +1093,7 @@ NA_IDEF void naMoveListCurToFirst(NAListIterator* srcIter, NABool advance, NALis
   #endif
   src = (NAList*)naGetPtrMutable(srcIter->listptr);
   #if NA_DEBUG
+    na_CheckListMove(src, dst);
     if(srcIter->cur == &src->sentinel)
       naError("List has no current element set.");
   #endif
@@ -1040,6 +1128,7 @@ NA_IDEF void naMoveListCurToLast(NAListIterator* srcIter, NABool advance, NAList
   #endif
   src = (NAList*)naGetPtrMutable(srcIter->listptr);
   #if NA_DEBUG
+    na_CheckListMove(src, dst);
     if(srcIter->cur == &src->sentinel)
       naError("List has no current element set.");
   #endif
@@ -1074,6 +1163,9 @@ NA_IDEF void naMoveListRemainingToLast(NAListIterator* srcIter, NAList* dst) {
       naError("Trying to modify list while iterator is no modifier");
   #endif
   src = (NAList*)naGetPtrMutable(srcIter->listptr);
+  #if NA_DEBUG
+    na_CheckListMove(src, dst);
+  #endif
 
   if(!naIsListEmpty(src)) {
     size_t movecount = 1;
@@ -1145,6 +1237,7 @@ NA_IDEF void naMoveListThisToFirst(NAListIterator* srcIter, NAList* dst) {
   #endif
   src = (NAList*)naGetPtrMutable(srcIter->listptr);
   #if NA_DEBUG
+    na_CheckListMove(src, dst);
     if(srcIter->cur == &src->sentinel)
       naError("List iterator does not point to any element. No ''This'' available.");
   #endif
@@ -1181,6 +1274,7 @@ NA_IDEF void naMoveListThisToLast(NAListIterator* srcIter, NAList* dst) {
   #endif
   src = (NAList*)naGetPtrMutable(srcIter->listptr);
   #if NA_DEBUG
+    na_CheckListMove(src, dst);
     if(srcIter->cur == &src->sentinel)
       naError("List iterator does not point to any element. No ''This'' available.");
   #endif
@@ -0,0 +1,60 @@
+
+#include "../NAMPSCQueue.h"
+#include "../../NAUtility/NAMemory.h"
+
+
+
+typedef struct NA_MPSCQueueValue NA_MPSCQueueValue;
+struct NA_MPSCQueueValue{
+  NAMPSCQueueNode node;
+  void* data;
+};
+NA_RUNTIME_TYPE(NA_MPSCQueueValue, NA_NULL, NA_FALSE);
+
+
+
+NA_DEF void naPushMPSCQueue(NAMPSCQueue* queue, void* data) {
+  NA_MPSCQueueValue* value = naNew(NA_MPSCQueueValue);
+  value->data = data;
+  naPushMPSCQueueNode(queue, &value->node);
+}
+
+
+
+NA_DEF NABool naPullMPSCQueue(NAMPSCQueue* queue, void** data) {
+  NAMPSCQueueNode* node = naPullMPSCQueueNode(queue);
+  NA_MPSCQueueValue* value;
+  if(!node)
+    return NA_FALSE;
+  value = naGetMPSCQueueNodeOwner(node, NA_MPSCQueueValue, node);
+  *data = value->data;
+  naDelete(value);
+  return NA_TRUE;
+}
+
+
+
+// This is free and unencumbered software released into the public domain.
+
+// Anyone is free to copy, modify, publish, use, compile, sell, or
+// distribute this software, either in source code form or as a compiled
+// binary, for any purpose, commercial or non-commercial, and by any
+// means.
+
+// In jurisdictions that recognize copyright laws, the author or authors
+// of this software dedicate any and all copyright interest in the
+// software to the public domain. We make this dedication for the benefit
+// of the public at large and to the detriment of our heirs and
+// successors. We intend this dedication to be an overt act of
+// relinquishment in perpetuity of all present and future rights to this
+// software under copyright law.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+
+// For more information, please refer to <http://unlicense.org/>
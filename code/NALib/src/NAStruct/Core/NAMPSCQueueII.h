@@ -0,0 +1,133 @@
+// This file contains inline implementations of the file NAMPSCQueue.h
+// Do not include this file directly! It will automatically be included when
+// including "NAMPSCQueue.h"
+
+
+
+// The nodes form a singly linked list from first to last. Producers exchange
+// last with their new node and then link the previous last node to it. The
+// consumer walks from first along the next pointers. A stub node belonging
+// to the queue itself ensures that the list is never empty, so producers and
+// the consumer never touch the same pointer except when there is exactly one
+// node left.
+
+struct NAMPSCQueueNode{
+  NAMPSCQueueNode* next;
+};
+
+struct NAMPSCQueue{
+  NAMPSCQueueNode* last;  // Written by the producers.
+  NAByte padding0[NA_CACHE_LINE_BYTESIZE - sizeof(NAMPSCQueueNode*)];
+  NAMPSCQueueNode* first; // Only accessed by the consumer.
+  NAMPSCQueueNode stub;
+};
+
+#undef naGetMPSCQueueNodeOwner
+#define naGetMPSCQueueNodeOwner(node, type, member)\
+  ((type*)((NAByte*)(node) - offsetof(type, member)))
+
+
+
+NA_IDEF NAMPSCQueue* naInitMPSCQueue(NAMPSCQueue* queue) {
+  #if NA_DEBUG
+    if(!queue)
+      naCrash("queue is nullptr");
+  #endif
+  queue->stub.next = NA_NULL;
+  queue->last = &queue->stub;
+  queue->first = &queue->stub;
+  return queue;
+}
+
+
+
+NA_IDEF void naClearMPSCQueue(NAMPSCQueue* queue) {
+  #if NA_DEBUG
+    if(!naIsMPSCQueueEmpty(queue))
+      naError("Queue is not empty.");
+  #else
+    NA_UNUSED(queue);
+  #endif
+}
+
+
+
+NA_IDEF void naPushMPSCQueueNode(NAMPSCQueue* queue, NAMPSCQueueNode* node) {
+  NAMPSCQueueNode* prev;
+  naAtomicStorePtr((void**)&node->next, NA_NULL, NA_MEMORY_ORDER_RELAXED);
+  prev = (NAMPSCQueueNode*)naAtomicExchangePtr((void**)&queue->last, node, NA_MEMORY_ORDER_ACQ_REL);
+  // Between the exchange and the following store, the list is interrupted at
+  // prev. This is the moment the consumer sees the queue as empty.
+  naAtomicStorePtr((void**)&prev->next, node, NA_MEMORY_ORDER_RELEASE);
+}
+
+
+
+NA_IDEF NAMPSCQueueNode* naPullMPSCQueueNode(NAMPSCQueue* queue) {
+  NAMPSCQueueNode* first = queue->first;
+  NAMPSCQueueNode* next = (NAMPSCQueueNode*)naAtomicLoadPtr((void* const*)&first->next, NA_MEMORY_ORDER_ACQUIRE);
+
+  // Skip the stub.
+  if(first == &queue->stub) {
+    if(!next)
+      return NA_NULL;
+    queue->first = next;
+    first = next;
+    next = (NAMPSCQueueNode*)naAtomicLoadPtr((void* const*)&first->next, NA_MEMORY_ORDER_ACQUIRE);
+  }
+
+  if(next) {
+    queue->first = next;
+    return first;
+  }
+
+  // First has no successor. If it is not the last node, a producer has not
+  // yet linked its node.
+  if(first != (NAMPSCQueueNode*)naAtomicLoadPtr((void* const*)&queue->last, NA_MEMORY_ORDER_ACQUIRE))
+    return NA_NULL;
+
+  // First is the only node. Push the stub behind it such that first can be
+  // removed without the queue running empty.
+  naPushMPSCQueueNode(queue, &queue->stub);
+  next = (NAMPSCQueueNode*)naAtomicLoadPtr((void* const*)&first->next, NA_MEMORY_ORDER_ACQUIRE);
+  if(next) {
+    queue->first = next;
+    return first;
+  }
+  return NA_NULL;
+}
+
+
+
+NA_IDEF NABool naIsMPSCQueueEmpty(const NAMPSCQueue* queue) {
+  const NAMPSCQueueNode* first = queue->first;
+  return first == &queue->stub
+    && !naAtomicLoadPtr((void* const*)&first->next, NA_MEMORY_ORDER_ACQUIRE);
+}
+
+
+
+// This is free and unencumbered software released into the public domain.
+
+// Anyone is free to copy, modify, publish, use, compile, sell, or
+// distribute this software, either in source code form or as a compiled
+// binary, for any purpose, commercial or non-commercial, and by any
+// means.
+
+// In jurisdictions that recognize copyright laws, the author or authors
+// of this software dedicate any and all copyright interest in the
+// software to the public domain. We make this dedication for the benefit
+// of the public at large and to the detriment of our heirs and
+// successors. We intend this dedication to be an overt act of
+// relinquishment in perpetuity of all present and future rights to this
+// software under copyright law.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+
+// For more information, please refer to <http://unlicense.org/>
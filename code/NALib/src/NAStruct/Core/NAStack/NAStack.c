@@ -3,6 +3,82 @@
 
 
 
+// Appends the given array to the directory of blocks.
+NA_HDEF void na_AddStackBlock(NAStack* stack, void* array) {
+  if(stack->blockCount == stack->blockCapacity) {
+    size_t newCapacity = stack->blockCapacity ? 2 * stack->blockCapacity : 8;
+    NA_StackBlock* newBlocks = naMalloc(newCapacity * sizeof(NA_StackBlock));
+    if(stack->blocks) {
+      naCopyn(newBlocks, stack->blocks, stack->blockCount * sizeof(NA_StackBlock));
+      naFree(stack->blocks);
+    }
+    stack->blocks = newBlocks;
+    stack->blockCapacity = newCapacity;
+  }
+
+  NA_StackBlock* block = &stack->blocks[stack->blockCount];
+  block->first = (NAByte*)array + sizeof(size_t);
+  block->count = *((size_t*)array);
+  block->baseIndex = 0;
+  if(stack->blockCount) {
+    const NA_StackBlock* prevBlock = &stack->blocks[stack->blockCount - 1];
+    block->baseIndex = prevBlock->baseIndex + prevBlock->count;
+  }
+  stack->blockCount++;
+}
+
+
+
+// Returns the position of the highest bit set. x must not be 0.
+NA_HIDEF size_t na_GetStackHighestBit(size_t x) {
+  #if NA_OS == NA_OS_WINDOWS
+    unsigned long index;
+    #if NA_ADDRESS_BITS == NA_TYPE64_BITS
+      _BitScanReverse64(&index, (unsigned __int64)x);
+    #else
+      _BitScanReverse(&index, (unsigned long)x);
+    #endif
+    return (size_t)index;
+  #else
+    return (size_t)(sizeof(unsigned long long) * 8 - 1) - (size_t)__builtin_clzll((unsigned long long)x);
+  #endif
+}
+
+
+
+// Returns the index of the block containing the element with the given
+// index.
+NA_HIDEF size_t na_GetStackBlockIndex(const NAStack* stack, size_t index) {
+  size_t initialCount = stack->blocks[0].count;
+
+  switch(stack->flags & NA_STACK_GROW_MASK) {
+  case NA_STACK_FIXED_SIZE:
+    return 0;
+  case NA_STACK_GROW_LINEAR:
+    // All blocks have the initial count.
+    return index / initialCount;
+  case NA_STACK_GROW_EXPONENTIAL:
+    // Block k starts at initialCount * (2^k - 1).
+    return na_GetStackHighestBit(index / initialCount + 1);
+  default: {
+    // The fibonacci counts are rounded, hence search in the directory.
+    size_t lower = 0;
+    size_t upper = stack->blockCount - 1;
+    while(lower < upper) {
+      size_t middle = (lower + upper + 1) / 2;
+      if(stack->blocks[middle].baseIndex <= index) {
+        lower = middle;
+      }else{
+        upper = middle - 1;
+      }
+    }
+    return lower;
+  }
+  }
+}
+
+
+
 NA_DEF NAStack* naInitStack(
   NAStack* stack,
   size_t typeSize,
@@ -21,6 +97,10 @@ NA_DEF NAStack* naInitStack(
   stack->typeSize = typeSize;
   stack->flags = flags;
   naInitList(&stack->arrays);
+  stack->blocks = NA_NULL;
+  stack->blockCount = 0;
+  stack->blockCapacity = 0;
+  stack->curBlock = 0;
 
   if(!initialCount) {
     // Compute the initial count automatically such that the first array fits
@@ -30,6 +110,7 @@ NA_DEF NAStack* naInitStack(
   }
   void* newArray = na_AllocStackArray(initialCount, stack->typeSize);
   naAddListLastMutable(&stack->arrays, newArray);
+  na_AddStackBlock(stack, newArray);
 
   // Create the cur pointer and let it point to the array just created.
   stack->curArray = naMakeListMutator(&stack->arrays);
@@ -56,6 +137,7 @@ NA_DEF void naClearStack(NAStack* stack) {
 
   naClearListIterator(&stack->curArray);
   naClearList(&stack->arrays, (NAMutator)na_DeallocStackArray);
+  naFree(stack->blocks);
 }
 
 
@@ -68,20 +150,8 @@ NA_DEF void* naPeekStack(NAStack* stack, size_t index) {
       naError("index out of bounds.");
   #endif
 
-  NAListIterator iter = naMakeListMutator(&stack->arrays);
-  size_t curBaseIndex = 0;
-  void* retValue = NA_NULL;
-  while(naIterateList(&iter)) {
-    size_t nextBaseIndex = curBaseIndex + na_GetStackArrayCount(&iter);
-    if(nextBaseIndex > index)
-    {
-      naClearListIterator(&iter);
-      return na_GetStackArrayAt(&iter, index - curBaseIndex, stack->typeSize);
-    }
-    curBaseIndex = nextBaseIndex;
-  }
-  naClearListIterator(&iter);
-  return retValue;
+  const NA_StackBlock* block = &stack->blocks[na_GetStackBlockIndex(stack, index)];
+  return block->first + (index - block->baseIndex) * stack->typeSize;
 }
 
 
@@ -129,10 +199,12 @@ NA_HDEF void na_GrowStack(NAStack* stack) {
 
     void* newArray = na_AllocStackArray(newArrayCount, stack->typeSize);
     naAddListLastMutable(&stack->arrays, newArray);
+    na_AddStackBlock(stack, newArray);
   }
 
   // Now, we have an array with spare elements.
   naIterateList(&stack->curArray);
+  stack->curBlock++;
   stack->curBaseIndex += lastArrayCount;
   stack->curCount = 0;
 }
@@ -152,6 +224,7 @@ NA_HDEF void na_ShrinkStack(NAStack* stack) {
 
     // We iterate one array backwards
     naIterateListBack(&stack->curArray);
+    stack->curBlock--;
     stack->curCount = na_GetStackArrayCount(&stack->curArray);
     stack->curBaseIndex -= stack->curCount;
 
@@ -161,6 +234,7 @@ NA_HDEF void na_ShrinkStack(NAStack* stack) {
       // Remove and deallocate all arrays which are after the old array iter.
       while(!naIsListAtLast(&oldArrayIter)) {
         na_DeallocStackArray(naRemoveListLastMutable(&stack->arrays));
+        stack->blockCount--;
       }
       break;
     case NA_STACK_NO_SHRINKING:
@@ -179,20 +253,8 @@ NA_DEF size_t naGetStackReservedCount(const NAStack* stack) {
     if(!stack)
       naCrash("stack is nullptr");
   #endif
-  size_t retSize = stack->curBaseIndex;
-
-  // We us an iterator starting from the current array position of the stack
-  // and add the count of all remaining arrays.
-  NAListIterator curArray = naMakeListAccessor(&stack->arrays);
-  naLocateListIterator(&curArray, &stack->curArray);
-  retSize += na_GetStackArrayCount(&curArray);
-
-  while(naIterateList(&curArray)) {
-    retSize += na_GetStackArrayCount(&curArray);
-  }
-
-  naClearListIterator(&curArray);
-  return retSize;
+  const NA_StackBlock* lastBlock = &stack->blocks[stack->blockCount - 1];
+  return lastBlock->baseIndex + lastBlock->count;
 }
 
 
@@ -215,6 +277,7 @@ NA_DEF void naShrinkStackIfNecessary(NAStack* stack, NABool aggressive) {
   // Delete as long as there are arrays after this one.
   while(!naIsListAtInitial(&arrayIter) && !naIsListAtLast(&arrayIter)) {
     na_DeallocStackArray(naRemoveListLastMutable(&stack->arrays));
+    stack->blockCount--;
   }
   naClearListIterator(&arrayIter);
 }
@@ -229,21 +292,36 @@ NA_DEF void naDumpStack(NAStack* stack, void* buf) {
       naCrash("buf is nullptr");
   #endif
   NAByte* bufPtr = (NAByte*)buf;
-  NAListIterator arrayIter = naMakeListAccessor(&stack->arrays);
-  while(naIterateList(&arrayIter)) {
-    size_t count = naEqualListIterator(&arrayIter, &stack->curArray) ?
+  for(size_t i = 0; i <= stack->curBlock; ++i) {
+    size_t count = (i == stack->curBlock) ?
       stack->curCount :
-      na_GetStackArrayCount(&arrayIter);
+      stack->blocks[i].count;
     if(count) {
       count *= stack->typeSize;
-      naCopyn(
-        bufPtr,
-        na_GetStackArrayFirstConst(&arrayIter),
-        count);
+      naCopyn(bufPtr, stack->blocks[i].first, count);
       bufPtr += count;
     }
   }
-  naClearListIterator(&arrayIter);
+}
+
+
+
+NA_DEF size_t naGetStackBlockSpans(NAStack* stack, NAStackSpan* spans, size_t maxSpanCount) {
+  #if NA_DEBUG
+    if(!stack)
+      naCrash("stack is nullptr");
+  #endif
+  // All blocks before the current one are full. The current one only counts
+  // if it contains elements.
+  size_t spanCount = stack->curCount ? stack->curBlock + 1 : stack->curBlock;
+  if(spans) {
+    size_t count = naMins(spanCount, maxSpanCount);
+    for(size_t i = 0; i < count; ++i) {
+      spans[i].first = stack->blocks[i].first;
+      spans[i].count = (i == stack->curBlock) ? stack->curCount : stack->blocks[i].count;
+    }
+  }
+  return spanCount;
 }
 
 
@@ -10,6 +10,14 @@
 
 
 
+// The same arrays as in the list but directly accessible by their index.
+NA_PROTOTYPE(NA_StackBlock);
+struct NA_StackBlock{
+  NAByte* first;     // The first element of the array
+  size_t  baseIndex; // Absolute index of the first element
+  size_t  count;     // Number of elements fitting into the array
+};
+
 struct NAStack{
   size_t         typeSize;     // The size of the stored elements in bytes.
   uint32         flags;        // Flags defining the behaviour of the stack.
@@ -17,6 +25,10 @@ struct NAStack{
   NAListIterator curArray;     // List position of current array
   size_t         curBaseIndex; // Absolute index of current array
   size_t         curCount;     // Number of used elements in current array
+  NA_StackBlock* blocks;       // Directory of all arrays in the list
+  size_t         blockCount;   // Number of arrays in the list
+  size_t         blockCapacity;// Number of blocks fitting into blocks
+  size_t         curBlock;     // Index of the current array in blocks
   #if NA_DEBUG
     size_t        iterCount;     // The number of iterators on this stack.
   #endif
@@ -37,6 +49,13 @@ struct NAStackIterator{
 
 
 
+struct NAStackSpan{
+  void*  first;  // The first element of the block
+  size_t count;  // The number of elements stored in the block
+};
+
+
+
 #define NA_STACK_GROW_MASK         0x0f
 #define NA_STACK_SHRINK_MASK       0xf0
 
@@ -0,0 +1,216 @@
+
+#include "../NAVector.h"
+#include "../../NAUtility/NABinaryData.h"
+#include <string.h>
+
+
+
+#define NA_VECTOR_MIN_CAPACITY 4
+
+
+
+NA_HDEF NAByte* na_AllocVectorData(const NAVector* vector, size_t capacity) {
+  return vector->align
+    ? naMallocAligned(capacity * vector->typeSize, vector->align)
+    : naMalloc(capacity * vector->typeSize);
+}
+
+
+
+// Returns the capacity to grow to such that at least count elements fit.
+NA_HDEF size_t na_GetVectorGrowCapacity(const NAVector* vector, size_t count) {
+  size_t capacity = vector->capacity * 2;
+  if(capacity < NA_VECTOR_MIN_CAPACITY)
+    capacity = NA_VECTOR_MIN_CAPACITY;
+  if(capacity < count)
+    capacity = count;
+  return capacity;
+}
+
+
+
+NA_HDEF void na_MoveVectorToCapacity(NAVector* vector, size_t capacity) {
+  NAByte* newData = NA_NULL;
+  if(capacity) {
+    newData = na_AllocVectorData(vector, capacity);
+    if(vector->count)
+      naCopyn(newData, vector->data, vector->count * vector->typeSize);
+  }
+  naClearVector(vector);
+  vector->data = newData;
+  vector->capacity = capacity;
+}
+
+
+
+NA_HDEF void na_GrowVector(NAVector* vector, size_t count) {
+  na_MoveVectorToCapacity(vector, na_GetVectorGrowCapacity(vector, count));
+}
+
+
+
+NA_DEF void naReserveVector(NAVector* vector, size_t capacity) {
+  #if NA_DEBUG
+    if(!vector)
+      naCrash("vector is nullptr");
+  #endif
+  if(capacity > vector->capacity)
+    na_MoveVectorToCapacity(vector, capacity);
+}
+
+
+
+NA_DEF void naShrinkVectorToFit(NAVector* vector) {
+  #if NA_DEBUG
+    if(!vector)
+      naCrash("vector is nullptr");
+  #endif
+  if(vector->capacity > vector->count)
+    na_MoveVectorToCapacity(vector, vector->count);
+}
+
+
+
+NA_DEF void naResizeVector(NAVector* vector, size_t count) {
+  #if NA_DEBUG
+    if(!vector)
+      naCrash("vector is nullptr");
+  #endif
+  if(count > vector->capacity)
+    na_GrowVector(vector, count);
+  vector->count = count;
+}
+
+
+
+NA_DEF void naPushVectorElements(NAVector* vector, const void* data, size_t count) {
+  #if NA_DEBUG
+    if(!vector)
+      naCrash("vector is nullptr");
+    if(count && !data)
+      naCrash("data is nullptr");
+  #endif
+  if(!count)
+    return;
+  size_t typeSize = vector->typeSize;
+  if(vector->count + count > vector->capacity) {
+    // The data may point into the vector itself. Therefore, the old block is
+    // freed only after the new elements have been copied.
+    size_t oldCount = vector->count;
+    size_t capacity = na_GetVectorGrowCapacity(vector, oldCount + count);
+    NAByte* newData = na_AllocVectorData(vector, capacity);
+    if(oldCount)
+      naCopyn(newData, vector->data, oldCount * typeSize);
+    naCopyn(newData + oldCount * typeSize, data, count * typeSize);
+    naClearVector(vector);
+    vector->data = newData;
+    vector->capacity = capacity;
+  }else{
+    naCopyn(vector->data + vector->count * typeSize, data, count * typeSize);
+  }
+  vector->count += count;
+}
+
+
+
+NA_DEF void* naInsertVectorElements(NAVector* vector, size_t index, size_t count) {
+  #if NA_DEBUG
+    if(!vector)
+      naCrash("vector is nullptr");
+    if(index > vector->count)
+      naError("index out of bounds.");
+  #endif
+  size_t typeSize = vector->typeSize;
+  if(vector->count + count > vector->capacity) {
+    // Copy directly into the new block, leaving the gap open.
+    size_t oldCount = vector->count;
+    NAByte* oldData = vector->data;
+    size_t capacity = na_GetVectorGrowCapacity(vector, oldCount + count);
+    NAByte* newData = na_AllocVectorData(vector, capacity);
+    if(index)
+      naCopyn(newData, oldData, index * typeSize);
+    if(oldCount > index)
+      naCopyn(newData + (index + count) * typeSize, oldData + index * typeSize, (oldCount - index) * typeSize);
+    naClearVector(vector);
+    vector->data = newData;
+    vector->capacity = capacity;
+  }else if(vector->count > index) {
+    memmove(
+      vector->data + (index + count) * typeSize,
+      vector->data + index * typeSize,
+      (vector->count - index) * typeSize);
+  }
+  vector->count += count;
+  return vector->data + index * typeSize;
+}
+
+
+
+NA_DEF void naEraseVectorElements(NAVector* vector, size_t index, size_t count) {
+  #if NA_DEBUG
+    if(!vector)
+      naCrash("vector is nullptr");
+    if(index + count > vector->count)
+      naError("range out of bounds.");
+  #endif
+  size_t typeSize = vector->typeSize;
+  size_t tailCount = vector->count - index - count;
+  if(count && tailCount) {
+    memmove(
+      vector->data + index * typeSize,
+      vector->data + (index + count) * typeSize,
+      tailCount * typeSize);
+  }
+  vector->count -= count;
+}
+
+
+
+NA_DEF NAArray* naInitArrayWithVector(NAArray* array, NAVector* vector) {
+  #if NA_DEBUG
+    if(!vector)
+      naCrash("vector is nullptr");
+  #endif
+  if(vector->count) {
+    naInitArrayWithDataMutable(
+      array,
+      vector->data,
+      vector->typeSize,
+      vector->count,
+      vector->align ? (NAMutator)naFreeAligned : (NAMutator)naFree);
+  }else{
+    naInitArray(array);
+    naClearVector(vector);
+  }
+  vector->data = NA_NULL;
+  vector->count = 0;
+  vector->capacity = 0;
+  return array;
+}
+
+
+
+// This is free and unencumbered software released into the public domain.
+
+// Anyone is free to copy, modify, publish, use, compile, sell, or
+// distribute this software, either in source code form or as a compiled
+// binary, for any purpose, commercial or non-commercial, and by any
+// means.
+
+// In jurisdictions that recognize copyright laws, the author or authors
+// of this software dedicate any and all copyright interest in the
+// software to the public domain. We make this dedication for the benefit
+// of the public at large and to the detriment of our heirs and
+// successors. We intend this dedication to be an overt act of
+// relinquishment in perpetuity of all present and future rights to this
+// software under copyright law.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+
+// For more information, please refer to <http://unlicense.org/>
@@ -0,0 +1,244 @@
+// This file contains inline implementations of the file NAVector.h
+// Do not include this file directly! It will automatically be included when
+// including "NAVector.h"
+
+
+
+#include "../../NAUtility/NAMemory.h"
+
+
+
+struct NAVector{
+  NAByte* data;     // The memory block storing the elements
+  size_t count;     // The number of elements stored
+  size_t capacity;  // The number of elements fitting into data
+  size_t typeSize;  // The size in bytes of one element
+  size_t align;     // The alignment of data or 0 if not aligned
+};
+
+// Grows the vector such that at least count elements fit.
+NA_HAPI void na_GrowVector(NAVector* vector, size_t count);
+
+
+
+NA_IDEF NAVector* naInitVector(NAVector* vector, size_t typeSize, size_t capacity) {
+  return naInitVectorAligned(vector, typeSize, capacity, 0);
+}
+
+
+
+NA_IDEF NAVector* naInitVectorAligned(NAVector* vector, size_t typeSize, size_t capacity, size_t align) {
+  #if NA_DEBUG
+    if(!vector)
+      naCrash("vector is nullptr");
+    if(typeSize == 0)
+      naError("typeSize must not be zero.");
+    if(align & (align - 1))
+      naError("align must be a power of two.");
+  #endif
+  vector->data = NA_NULL;
+  vector->count = 0;
+  vector->capacity = 0;
+  vector->typeSize = typeSize;
+  vector->align = align;
+  if(capacity)
+    naReserveVector(vector, capacity);
+  return vector;
+}
+
+
+
+NA_IDEF void naClearVector(NAVector* vector) {
+  #if NA_DEBUG
+    if(!vector)
+      naCrash("vector is nullptr");
+  #endif
+  if(vector->data) {
+    if(vector->align) {
+      naFreeAligned(vector->data);
+    }else{
+      naFree(vector->data);
+    }
+  }
+}
+
+
+
+NA_IDEF void naEmptyVector(NAVector* vector) {
+  vector->count = 0;
+}
+
+
+
+NA_IDEF void* naPushVector(NAVector* vector) {
+  if(vector->count == vector->capacity)
+    na_GrowVector(vector, vector->count + 1);
+  vector->count++;
+  return vector->data + (vector->count - 1) * vector->typeSize;
+}
+
+
+
+NA_IDEF void* naPopVector(NAVector* vector) {
+  #if NA_DEBUG
+    if(vector->count == 0)
+      naError("Vector is empty.");
+  #endif
+  vector->count--;
+  return vector->data + vector->count * vector->typeSize;
+}
+
+
+
+NA_IDEF void* naPopVectorp(NAVector* vector) {
+  return *((void**)naPopVector(vector));
+}
+
+
+
+NA_IDEF const void* naGetVectorPointerConst(const NAVector* vector) {
+  return vector->data;
+}
+
+
+
+NA_IDEF void* naGetVectorPointerMutable(NAVector* vector) {
+  return vector->data;
+}
+
+
+
+NA_IDEF const void* naGetVectorElementConst(const NAVector* vector, size_t index) {
+  #if NA_DEBUG
+    if(index >= vector->count)
+      naError("index out of bounds.");
+  #endif
+  return vector->data + index * vector->typeSize;
+}
+
+
+
+NA_IDEF void* naGetVectorElementMutable(NAVector* vector, size_t index) {
+  #if NA_DEBUG
+    if(index >= vector->count)
+      naError("index out of bounds.");
+  #endif
+  return vector->data + index * vector->typeSize;
+}
+
+
+
+NA_IDEF const void* naGetVectorElementpConst(const NAVector* vector, size_t index) {
+  return *((const void* const*)naGetVectorElementConst(vector, index));
+}
+
+
+
+NA_IDEF void* naGetVectorElementpMutable(NAVector* vector, size_t index) {
+  return *((void**)naGetVectorElementMutable(vector, index));
+}
+
+
+
+NA_IDEF size_t naGetVectorCount(const NAVector* vector) {
+  return vector->count;
+}
+
+
+
+NA_IDEF size_t naGetVectorCapacity(const NAVector* vector) {
+  return vector->capacity;
+}
+
+
+
+NA_IDEF size_t naGetVectorTypeSize(const NAVector* vector) {
+  return vector->typeSize;
+}
+
+
+
+NA_IDEF NABool naIsVectorEmpty(const NAVector* vector) {
+  return vector->count == 0;
+}
+
+
+
+NA_IDEF void naForeachVectorConst(const NAVector* vector, NAAccessor accessor) {
+  #if NA_DEBUG
+    if(!accessor)
+      naCrash("Accessor is nullptr");
+  #endif
+  const NAByte* ptr = vector->data;
+  for(size_t i = 0; i < vector->count; ++i) {
+    accessor(ptr);
+    ptr += vector->typeSize;
+  }
+}
+
+
+
+NA_IDEF void naForeachVectorMutable(NAVector* vector, NAMutator mutator) {
+  #if NA_DEBUG
+    if(!mutator)
+      naCrash("Mutator is nullptr");
+  #endif
+  NAByte* ptr = vector->data;
+  for(size_t i = 0; i < vector->count; ++i) {
+    mutator(ptr);
+    ptr += vector->typeSize;
+  }
+}
+
+
+
+NA_IDEF void naForeachVectorpConst(const NAVector* vector, NAAccessor accessor) {
+  #if NA_DEBUG
+    if(!accessor)
+      naCrash("Accessor is nullptr");
+  #endif
+  const void* const* ptr = (const void* const*)vector->data;
+  for(size_t i = 0; i < vector->count; ++i) {
+    accessor(ptr[i]);
+  }
+}
+
+
+
+NA_IDEF void naForeachVectorpMutable(NAVector* vector, NAMutator mutator) {
+  #if NA_DEBUG
+    if(!mutator)
+      naCrash("Mutator is nullptr");
+  #endif
+  void** ptr = (void**)vector->data;
+  for(size_t i = 0; i < vector->count; ++i) {
+    mutator(ptr[i]);
+  }
+}
+
+
+
+// This is free and unencumbered software released into the public domain.
+
+// Anyone is free to copy, modify, publish, use, compile, sell, or
+// distribute this software, either in source code form or as a compiled
+// binary, for any purpose, commercial or non-commercial, and by any
+// means.
+
+// In jurisdictions that recognize copyright laws, the author or authors
+// of this software dedicate any and all copyright interest in the
+// software to the public domain. We make this dedication for the benefit
+// of the public at large and to the detriment of our heirs and
+// successors. We intend this dedication to be an overt act of
+// relinquishment in perpetuity of all present and future rights to this
+// software under copyright law.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+
+// For more information, please refer to <http://unlicense.org/>
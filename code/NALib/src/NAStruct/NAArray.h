@@ -84,6 +84,9 @@ NA_IAPI void naForeachArrayMutable (NAArray* array, NAMutator  mutator);
 NA_IAPI void naForeachArraypConst  (NAArray* array, NAAccessor accessor);
 NA_IAPI void naForeachArraypMutable(NAArray* array, NAMutator  mutator);
 
+// See NATaskPool.h for variants distributing the elements onto multiple
+// threads.
+
 // Returns a pointer to the very first element of the raw data array.
 // Notice: This function is speedy.
 NA_IAPI const void* naGetArrayPointerConst  (const NAArray* array);
@@ -108,6 +111,41 @@ NA_IAPI size_t naGetArrayMaxIndex (const NAArray* array);
 NA_IAPI size_t naGetArrayTypeSize (const NAArray* array);
 NA_IAPI NABool naIsArrayEmpty     (const NAArray* array);
 
+// Sorts the elements of an array storing numbers of the type denoted by the
+// suffix in ascending order. The typeSize of the array must match the type.
+//
+// Large arrays are sorted with a radix sort which needs a temporary buffer
+// of the same size as the array but no comparisons at all. Digits in which
+// all numbers are equal, for example the upper bytes of timestamps lying
+// close together, are skipped. Small arrays are sorted with sorting networks
+// and merging without any heap allocation.
+//
+// Floating point numbers are sorted by their bit pattern: -0 comes before +0
+// and NaNs come after +infinity or before -infinity depending on their sign.
+NA_API void naSortArrayi32(NAArray* array);
+NA_API void naSortArrayu32(NAArray* array);
+NA_API void naSortArrayf  (NAArray* array);
+#if NA_NATIVE_INT64_IN_USE
+  NA_API void naSortArrayi64(NAArray* array);
+  NA_API void naSortArrayu64(NAArray* array);
+  NA_API void naSortArrayd  (NAArray* array);
+#endif
+
+// Instead of sorting the array, these functions store the indices of the
+// elements in sorted order in the given indices which must have space for
+// as many indices as the array has elements. Use them to sort keys with a
+// payload: Sort the indices by the keys and access the payloads with the
+// indices afterwards. The array itself is left unchanged. Elements with
+// equal keys keep their order (stable sort).
+NA_API void naSortArrayIndicesi32(const NAArray* array, size_t* indices);
+NA_API void naSortArrayIndicesu32(const NAArray* array, size_t* indices);
+NA_API void naSortArrayIndicesf  (const NAArray* array, size_t* indices);
+#if NA_NATIVE_INT64_IN_USE
+  NA_API void naSortArrayIndicesi64(const NAArray* array, size_t* indices);
+  NA_API void naSortArrayIndicesu64(const NAArray* array, size_t* indices);
+  NA_API void naSortArrayIndicesd  (const NAArray* array, size_t* indices);
+#endif
+
 
 
 
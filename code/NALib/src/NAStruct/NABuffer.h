@@ -533,6 +533,28 @@ NA_API void naWriteBufferLineWithArguments(
   const NAUTF8Char* format,
   va_list argumentList);
 
+// Writes the statistics of all registered runtime types as returned by
+// naGetRuntimeTypeStats to the buffer, either as CSV with a header line and
+// one line per type or as a JSON array with one object per type. Useful for
+// finding out which types use how much memory without attaching a profiler.
+typedef enum{
+  NA_RUNTIME_STATS_FORMAT_CSV,
+  NA_RUNTIME_STATS_FORMAT_JSON
+} NARuntimeStatsFormat;
+
+NA_API void naWriteBufferRuntimeTypeStats(
+  NABufferIterator* iter,
+  NARuntimeStatsFormat format);
+
+// Writes the statistics of all mutexes as returned by naGetMutexStats to the
+// buffer in the same formats. Only available with NA_MUTEX_PROFILING set to
+// 1, otherwise only the CSV header or an empty JSON array is written. The
+// hold time histogram becomes one column per entry in CSV and an array in
+// JSON.
+NA_API void naWriteBufferMutexStats(
+  NABufferIterator* iter,
+  NARuntimeStatsFormat format);
+
 
 
 // ////////////////////////////////
@@ -15,29 +15,85 @@
 // elements but which are wrapped around at the end such that the one element
 // after the last one of the array will again be the first one.
 //
-// This implementation stores void pointers. The implementation allocates
-// space for exactly count+1 elements. The additional element is required to
-// guarantee proper function of the circular structure.
+// This implementation stores void pointers. The number of elements is
+// rounded up to the next power of two.
+//
+// A circular buffer can also be used to pass elements from one thread to
+// another without any locking. Choose one of the following modes when
+// initializing:
+//
+// NA_CIRCULAR_BUFFER_SERIAL  Only one thread at a time uses the buffer.
+// NA_CIRCULAR_BUFFER_SPSC    Single producer, single consumer: One thread
+//                            pushes and one other thread pulls. Every
+//                            operation finishes in a fixed number of steps,
+//                            no matter what the other thread does.
+// NA_CIRCULAR_BUFFER_MPMC    Multiple producers, multiple consumers: Any
+//                            thread can push and pull. Every element slot
+//                            has a sequence number telling whether it is
+//                            ready to be written or read.
+//
+// The counters of the pushing and the pulling side are stored on separate
+// cache lines such that producers and consumers do not slow each other down.
 
+#include "../NABase/NABase.h"
+
+typedef enum{
+  NA_CIRCULAR_BUFFER_SERIAL,
+  NA_CIRCULAR_BUFFER_SPSC,
+  NA_CIRCULAR_BUFFER_MPMC
+} NACircularBufferMode;
 
 // The full type definition is in the file "NACircularBufferII.h"
 NA_PROTOTYPE(NACircularBuffer);
 
 
 
-// Creates a circular buffer with sufficient space for the given number of
-// void-Pointers.
-NACircularBuffer* naInitCircularBuffer(NACircularBuffer* buffer, int64 count);
+// Initializes a circular buffer with sufficient space for the given number
+// of void-Pointers. The first variant uses NA_CIRCULAR_BUFFER_SERIAL.
+NA_IAPI NACircularBuffer* naInitCircularBuffer(
+  NACircularBuffer* buffer,
+  size_t count);
+NA_IAPI NACircularBuffer* naInitCircularBufferWithMode(
+  NACircularBuffer* buffer,
+  size_t count,
+  NACircularBufferMode mode);
 
 // Clears the circular buffer. Does not deletes the content-pointers!
-void naClearCircularBuffer(NACircularBuffer* buffer);
+NA_IAPI void naClearCircularBuffer(NACircularBuffer* buffer);
+
+// Returns the number of elements the buffer can store.
+NA_IAPI size_t naGetCircularBufferCapacity(const NACircularBuffer* buffer);
+
+// Returns the number of elements currently stored. When other threads use
+// the buffer at the same time, the value may already be outdated.
+NA_IAPI size_t naGetCircularBufferCount(const NACircularBuffer* buffer);
 
 // Returns the beginning of the filled buffer and moves the buffer forward.
-void* naPullCircularBuffer(NACircularBuffer* buffer);
+// The buffer must not be empty.
+NA_IAPI void* naPullCircularBuffer(NACircularBuffer* buffer);
 
 // Puts one element at the tail of the buffer. Does not copy any content, only
-// stores the pointer!
-void naPushCircularBuffer(NACircularBuffer* buffer, void* newData);
+// stores the pointer! The buffer must not be full.
+NA_IAPI void naPushCircularBuffer(NACircularBuffer* buffer, void* newData);
+
+// Same as above but return NA_FALSE instead of failing when the buffer is
+// empty or full. Use these when multiple threads use the buffer.
+NA_IAPI NABool naTryPullCircularBuffer(NACircularBuffer* buffer, void** data);
+NA_IAPI NABool naTryPushCircularBuffer(NACircularBuffer* buffer, void* newData);
+
+// Pushes or pulls up to count elements at once and returns the number of
+// elements actually pushed or pulled which might be less if the buffer is
+// full or empty. In SPSC mode, all elements are published with one single
+// counter update. In MPMC mode, the elements are handled one after the
+// other and may interleave with the ones of other threads.
+NA_IAPI size_t naPushCircularBufferN(
+  NACircularBuffer* buffer,
+  void* const* newData,
+  size_t count);
+NA_IAPI size_t naPullCircularBufferN(
+  NACircularBuffer* buffer,
+  void** data,
+  size_t count);
 
 
 
@@ -19,6 +19,16 @@
 // Additionally, there exists an NAListIterator which allows you to iterate
 // through the list easily and even remove elements while traversing the
 // list. See below for a detailed explanation of the iteration functions.
+//
+// By default, every element of a list is allocated with naNew and stores a
+// pointer to your content. When a list holds many elements and traversing it
+// is performance critical, there are two alternatives, see below:
+// - A list with its own slab allocates its elements in chunks which are only
+//   used by this list, keeping the elements close together in memory.
+// - An intrusive list uses an NAListElement which you put into your content
+//   struct. Adding and removing does not allocate anything and the element
+//   and the content share the same cache lines.
+// All other functions including the iterators work the same for all lists.
 
 
 #include <stdlib.h>
@@ -28,10 +38,13 @@
 // This file defines the following types:
 // - NAList          Defines the struct storing a list.
 // - NAListIterator  Defines the struct holding the iterator of a list.
+// - NAListElement   Defines one element of a list. Only needed for intrusive
+//                   lists.
 //
 // The full type definitions are in the file "NAListII.h"
 NA_PROTOTYPE(NAList);
 NA_PROTOTYPE(NAListIterator);
+NA_PROTOTYPE(NAListElement);
 
 
 // Creates an empty list.
@@ -45,6 +58,30 @@ NA_IAPI NAList* naInitList    (NAList* list);
 // list.
 NA_IAPI NAList* naInitListWithCopy    (NAList* list, NAList* originalList);
 
+// Creates an empty list which allocates its elements from its own slab: A
+// chain of memory chunks each holding elementsPerChunk elements. Removed
+// elements are reused by later additions of the same list. The memory is
+// only given back when the list is cleared. Use 0 to let NALib choose a
+// chunk size which fills a memory page.
+NA_API NAList* naInitListWithSlab(NAList* list, size_t elementsPerChunk);
+
+// Creates an empty intrusive list. Every content added to this list must be
+// a struct containing an NAListElement member at the given byte offset:
+//
+// typedef struct MyObject MyObject;
+// struct MyObject{
+//   int value;
+//   NAListElement listElement;
+// };
+// naInitListIntrusive(&list, offsetof(MyObject, listElement));
+// naAddListLastMutable(&list, myObject);
+//
+// The element member belongs to the list as long as the content is stored in
+// it and hence, a content can only be stored in one intrusive list per
+// element member. The content must stay in memory until it is removed. Note
+// that the element member is written even when adding content as const.
+NA_IAPI NAList* naInitListIntrusive(NAList* list, size_t elementOffset);
+
 // Clears or empties the given list. The given destructor is called for every
 // element if not nullptr.
 //
@@ -136,6 +173,10 @@ NA_IAPI void naForeachListMutable(const NAList* list, NAMutator  mutator);
 // it as the last element of dst list.
 //
 // Note that there is NO memory allocation or deallocation used in the process!
+// Therefore, moving elements between different lists is only possible if both
+// lists are default lists or both are intrusive lists using the same element
+// offset. Lists with their own slab can only move elements within themselves.
+// This holds for all move functions, also the ones using iterators.
 NA_IAPI void naMoveListToLast(     NAList* src, NAList* dst);
 NA_IAPI void naMoveListFirstToLast(NAList* src, NAList* dst);
 
@@ -359,6 +400,35 @@ NA_IAPI void naMoveListThisToLast (     NAListIterator* srcIter,
 // The iterator will point to the first element after this function.
 NA_IAPI void naExchangeListParts(       NAListIterator* iter);
 
+// The splice function moves all elements starting with the element of
+// srcBegin up to but not including the element of srcEnd before the current
+// element of dstIter. If dstIter is at initial position, the elements are
+// attached at the end of its list. If srcEnd is at initial position, all
+// remaining elements are moved. Both src iterators must belong to the same
+// list and srcEnd must not be positioned before srcBegin. As with the other
+// move functions, no memory is allocated or deallocated.
+//
+// When you know the number of elements in the range, provide it as count and
+// the function runs in constant time, no matter how many elements are moved.
+// Otherwise, use NA_LIST_UNKNOWN_COUNT and the elements will be counted. When
+// moving within the same list, nothing needs to be counted either way.
+//
+// The dst list can be the same as the src list as long as dstIter is not
+// positioned within the range. After this function, srcBegin points to the
+// same element as srcEnd and dstIter still points to the same element.
+#define NA_LIST_UNKNOWN_COUNT NA_MAX_s
+NA_API void naSpliceListRange(          NAListIterator* srcBegin,
+                                        NAListIterator* srcEnd,
+                                        NAListIterator* dstIter,
+                                                size_t count);
+
+// Sorts the list with the given comparator. Elements comparing equal keep
+// their order (stable sort). The sort is a bottom-up merge sort which only
+// relinks the existing elements: Nothing is allocated and the contents stay
+// where they are. There must be no iterators on the list while sorting.
+NA_API void naSortList(                         NAList* list,
+                                          NAComparator comparator);
+
 
 
 // Inline implementations are in a separate file:
@@ -0,0 +1,112 @@
+
+#ifndef NA_MPSC_QUEUE_INCLUDED
+#define NA_MPSC_QUEUE_INCLUDED
+#ifdef __cplusplus
+  extern "C"{
+#endif
+
+
+
+// An NAMPSCQueue is an unbounded first-in-first-out queue which can be
+// filled by any number of threads at the same time (multiple producers) but
+// must only be emptied by one single thread (single consumer). This is the
+// typical situation of posting messages or work to a specific thread, for
+// example a main thread or a worker thread with its own event loop.
+//
+// The queue needs no locks. Pushing is one single atomic exchange and never
+// waits for other threads. Pulling never waits either, but there is one
+// thing to know: While a producer is in the middle of pushing, the consumer
+// may see the queue as empty up to that element, even if other elements have
+// been pushed after it. Once the producer is done, everything becomes
+// visible. Therefore, a consumer should always be woken up again (for
+// example with an NAAlarm) after something has been pushed and must not
+// expect the queue to be empty just because a pull returned nothing.
+//
+// The queue is intrusive: Instead of allocating a list element for every
+// message, you place an NAMPSCQueueNode into your own message struct and
+// push that node. When pulling, you get the node back and can get to your
+// struct with naGetMPSCQueueNodeOwner. A node can only be in one queue at
+// a time and must stay valid until pulled.
+//
+// If you only have a pointer to send, use the value variants which take the
+// node from the runtime pool. Do not mix nodes and values in the same queue.
+// As the nodes are created by the producers and deleted by the consumer,
+// NA_RUNTIME_USE_THREAD_CACHES must be 1 when using the value variants from
+// multiple threads. See NAConfiguration.h
+
+#include "../NABase/NABase.h"
+
+// The full type definitions are in the file "NAMPSCQueueII.h"
+NA_PROTOTYPE(NAMPSCQueue);
+NA_PROTOTYPE(NAMPSCQueueNode);
+
+
+
+// Initializes and clears a queue. The queue must be empty when cleared.
+NA_IAPI NAMPSCQueue* naInitMPSCQueue(NAMPSCQueue* queue);
+NA_IAPI void naClearMPSCQueue(NAMPSCQueue* queue);
+
+// Appends the node to the queue. Can be called by any thread.
+NA_IAPI void naPushMPSCQueueNode(NAMPSCQueue* queue, NAMPSCQueueNode* node);
+
+// Removes the first node of the queue and returns it. Returns NA_NULL if
+// there is no node available (see the note about producers above). Must only
+// be called by the consumer thread.
+NA_IAPI NAMPSCQueueNode* naPullMPSCQueueNode(NAMPSCQueue* queue);
+
+// Returns the struct the node is a member of. For example:
+// MyMessage* message = naGetMPSCQueueNodeOwner(node, MyMessage, queueNode);
+#define naGetMPSCQueueNodeOwner(node, type, member)
+
+// Appends the given pointer to the queue using a node from the runtime pool.
+// Can be called by any thread. The runtime must be running.
+NA_API void naPushMPSCQueue(NAMPSCQueue* queue, void* data);
+
+// Removes the first pointer of the queue and stores it in data. Returns
+// NA_FALSE if there is none available. Must only be called by the consumer.
+NA_API NABool naPullMPSCQueue(NAMPSCQueue* queue, void** data);
+
+// Returns whether there is no node available to the consumer. Must only be
+// called by the consumer thread.
+NA_IAPI NABool naIsMPSCQueueEmpty(const NAMPSCQueue* queue);
+
+
+
+
+// Inline implementations are in a separate file:
+#include "Core/NAMPSCQueueII.h"
+
+
+
+
+#ifdef __cplusplus
+  } // extern "C"
+#endif
+#endif // NA_MPSC_QUEUE_INCLUDED
+
+
+
+// This is free and unencumbered software released into the public domain.
+
+// Anyone is free to copy, modify, publish, use, compile, sell, or
+// distribute this software, either in source code form or as a compiled
+// binary, for any purpose, commercial or non-commercial, and by any
+// means.
+
+// In jurisdictions that recognize copyright laws, the author or authors
+// of this software dedicate any and all copyright interest in the
+// software to the public domain. We make this dedication for the benefit
+// of the public at large and to the detriment of our heirs and
+// successors. We intend this dedication to be an overt act of
+// relinquishment in perpetuity of all present and future rights to this
+// software under copyright law.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+
+// For more information, please refer to <http://unlicense.org/>
@@ -54,6 +54,7 @@
 // The full type definition is in the file "NAStackII.h"
 NA_PROTOTYPE(NAStack);
 NA_PROTOTYPE(NAStackIterator);
+NA_PROTOTYPE(NAStackSpan);
 
 
 
@@ -106,8 +107,12 @@ NA_API void naClearStack  (NAStack* stack);
 // Push:  Grows the stack by 1 element and returns a pointer to the element.
 // Pop:   Shrinks the stack by 1 element and returns a pointer to the element.
 //        which just had beed popped.
-// Peek:  Looks at the element with the given index. Warning: Not very fast.
-//        Better use iterators if you want to visit all elements of the stack.
+// Peek:  Looks at the element with the given index. With the LINEAR,
+//        EXPONENTIAL and FIXED_SIZE flags, the memory block is computed
+//        directly from the index. With FIBONACCI and AUTO, the block is
+//        searched in a small directory of all blocks which takes a few steps
+//        at most. Still, better use iterators or naGetStackBlockSpans if you
+//        want to visit all elements of the stack.
 //
 // Note that the Pop function returns the element which had been removed. It
 // will still be available after a call to this function as long as it does
@@ -120,7 +125,7 @@ NA_API  void* naPeekStack(NAStack* stack, size_t index);
 
 // Returns the number of elements actually stored in the stack
 NA_IAPI size_t naGetStackCount(const NAStack* stack);
-// Returns the number of elements reserved in memory. Warning: Rather slow.
+// Returns the number of elements reserved in memory.
 NA_API size_t naGetStackReservedCount(const NAStack* stack);
 
 // If you want the stack to shrink manually, you can call this function. This
@@ -138,6 +143,22 @@ NA_API void naShrinkStackIfNecessary(NAStack* stack, NABool aggressive);
 // plain C array.
 NA_API void naDumpStack(NAStack* stack, void* buf);
 
+// The elements of a stack are stored in memory blocks. Within a block, the
+// elements are stored one after the other like a plain C array. This
+// function fills the given spans with the first element (span.first) and the
+// number of elements (span.count) of every block in use, from base to top, up
+// to maxSpanCount spans.
+// Returns the number of blocks in use which can be larger than maxSpanCount.
+// Call it with spans being NA_NULL to get the number of blocks only.
+//
+// As the blocks grow, there are only a few of them. This allows to process
+// all elements block by block, for example with SIMD operations or memcpy.
+// The spans stay valid until the stack shrinks or is cleared.
+NA_API size_t naGetStackBlockSpans(
+  NAStack* stack,
+  NAStackSpan* spans,
+  size_t maxSpanCount);
+
 
 
 // //////////////////////////
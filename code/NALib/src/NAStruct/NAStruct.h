@@ -14,9 +14,11 @@
 #include "NACircularBuffer.h"
 #include "NAHeap.h"
 #include "NAList.h"
+#include "NAMPSCQueue.h"
 #include "NAPool.h"
 #include "NAStack.h"
 #include "NATree.h"
+#include "NAVector.h"
 
 
 
@@ -0,0 +1,176 @@
+
+#ifndef NA_VECTOR_INCLUDED
+#define NA_VECTOR_INCLUDED
+#ifdef __cplusplus
+  extern "C"{
+#endif
+
+
+
+// /////////////////////////////////////
+// NAVector
+// /////////////////////////////////////
+
+// An NAVector is an array which grows as elements are added. All elements
+// are always stored one after the other in one single memory block. Use it
+// when building up an array whose final count is not known beforehand.
+//
+// Compared to the other structures:
+// - NAArray has a fixed count once initialized.
+// - NAStack grows by adding additional memory blocks. Pointers to its
+//   elements stay valid while growing, but the elements are not contiguous.
+// - NAVector moves all elements to a bigger block when growing. Therefore,
+//   pointers to its elements become invalid with every call which may grow
+//   the vector. Use indices instead. But you get one contiguous block which
+//   can directly be given to any function expecting a C array.
+//
+// Whenever the vector runs out of space, the capacity is doubled. Hence,
+// appending n elements one by one costs O(n) copies in total. If you know
+// how many elements will be added, use naReserveVector to avoid any copies.
+//
+// Optionally, the memory can be aligned, for example to the size of a SIMD
+// register or a cache line (see NA_CACHE_LINE_BYTESIZE).
+
+#include "../NABase/NABase.h"
+#include "NAArray.h"
+
+// The full type definition is in the file "NAVectorII.h"
+NA_PROTOTYPE(NAVector);
+
+
+
+// Initializes an empty vector storing elements of typeSize bytes. Memory for
+// capacity elements is allocated immediately. capacity may be 0.
+//
+// The Aligned variant stores the elements in memory aligned to align bytes
+// which must be a power of two. Note that only the first element is aligned
+// unless typeSize is a multiple of align.
+NA_IAPI NAVector* naInitVector(
+  NAVector* vector,
+  size_t typeSize,
+  size_t capacity);
+NA_IAPI NAVector* naInitVectorAligned(
+  NAVector* vector,
+  size_t typeSize,
+  size_t capacity,
+  size_t align);
+
+// Clears the vector and frees its memory. If you need to destruct the
+// elements, use naForeachVector first.
+NA_IAPI void naClearVector(NAVector* vector);
+
+// Removes all elements but keeps the memory.
+NA_IAPI void naEmptyVector(NAVector* vector);
+
+// Makes sure that the vector can store at least capacity elements without
+// moving. Never shrinks the vector.
+NA_API void naReserveVector(NAVector* vector, size_t capacity);
+
+// Reduces the capacity to the current count. An empty vector frees all its
+// memory.
+NA_API void naShrinkVectorToFit(NAVector* vector);
+
+// Sets the count of the vector. New elements are uninitialized.
+NA_API void naResizeVector(NAVector* vector, size_t count);
+
+// Appends a new uninitialized element at the end of the vector and returns a
+// pointer to it. The pointer stays valid until the vector grows.
+NA_IAPI void* naPushVector(NAVector* vector);
+
+// Appends count elements copied from the given data.
+NA_API void naPushVectorElements(
+  NAVector* vector,
+  const void* data,
+  size_t count);
+
+// Removes the last element and returns a pointer to it. The pointer stays
+// valid until the next element is added. The p variant expects this vector
+// to store pointers and returns the pointer stored.
+NA_IAPI void* naPopVector (NAVector* vector);
+NA_IAPI void* naPopVectorp(NAVector* vector);
+
+// Inserts count uninitialized elements before the element at index and
+// returns a pointer to the first of them. The following elements are moved
+// backwards. index may be equal to the count of the vector to append.
+NA_API void* naInsertVectorElements(
+  NAVector* vector,
+  size_t index,
+  size_t count);
+
+// Removes count elements starting at index. The following elements are
+// moved forwards.
+NA_API void naEraseVectorElements(
+  NAVector* vector,
+  size_t index,
+  size_t count);
+
+// Returns a pointer to the first element. May be NA_NULL if the vector has
+// no memory allocated.
+NA_IAPI const void* naGetVectorPointerConst  (const NAVector* vector);
+NA_IAPI       void* naGetVectorPointerMutable(      NAVector* vector);
+
+// Returns a pointer to the element at the given index. The p variants
+// expect this vector to store pointers and return the pointer stored.
+NA_IAPI const void* naGetVectorElementConst   (const NAVector* vector, size_t index);
+NA_IAPI       void* naGetVectorElementMutable (      NAVector* vector, size_t index);
+NA_IAPI const void* naGetVectorElementpConst  (const NAVector* vector, size_t index);
+NA_IAPI       void* naGetVectorElementpMutable(      NAVector* vector, size_t index);
+
+// Returns information about the elements stored in the vector.
+NA_IAPI size_t naGetVectorCount   (const NAVector* vector);
+NA_IAPI size_t naGetVectorCapacity(const NAVector* vector);
+NA_IAPI size_t naGetVectorTypeSize(const NAVector* vector);
+NA_IAPI NABool naIsVectorEmpty    (const NAVector* vector);
+
+// Traverses the whole vector and calls the accessor or mutator on each
+// element. The p variants expect this vector to store pointers.
+NA_IAPI void naForeachVectorConst   (const NAVector* vector, NAAccessor accessor);
+NA_IAPI void naForeachVectorMutable (      NAVector* vector, NAMutator  mutator);
+NA_IAPI void naForeachVectorpConst  (const NAVector* vector, NAAccessor accessor);
+NA_IAPI void naForeachVectorpMutable(      NAVector* vector, NAMutator  mutator);
+
+// Initializes the array with the elements of the vector without copying
+// them. The array takes over the memory and the vector will be empty
+// afterwards with no memory allocated.
+NA_API NAArray* naInitArrayWithVector(NAArray* array, NAVector* vector);
+
+
+
+
+// Inline implementations are in a separate file:
+#include "Core/NAVectorII.h"
+
+
+
+
+#ifdef __cplusplus
+  } // extern "C"
+#endif
+#endif // NA_VECTOR_INCLUDED
+
+
+
+// This is free and unencumbered software released into the public domain.
+
+// Anyone is free to copy, modify, publish, use, compile, sell, or
+// distribute this software, either in source code form or as a compiled
+// binary, for any purpose, commercial or non-commercial, and by any
+// means.
+
+// In jurisdictions that recognize copyright laws, the author or authors
+// of this software dedicate any and all copyright interest in the
+// software to the public domain. We make this dedication for the benefit
+// of the public at large and to the detriment of our heirs and
+// successors. We intend this dedication to be an overt act of
+// relinquishment in perpetuity of all present and future rights to this
+// software under copyright law.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+
+// For more information, please refer to <http://unlicense.org/>
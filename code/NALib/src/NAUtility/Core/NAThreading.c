@@ -0,0 +1,155 @@
+#include "../../NAUtility/NAThreading.h"
+
+#if NA_OS == NA_OS_MAC_OS_X
+  #include <mach/mach_time.h>
+#endif
+
+
+
+NA_HDEF int64 na_GetMonotonicTime() {
+  #if NA_OS == NA_OS_WINDOWS
+    static LARGE_INTEGER frequency = {0};
+    LARGE_INTEGER counter;
+    if(!frequency.QuadPart)
+      QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (int64)((double)counter.QuadPart * (1000000000. / (double)frequency.QuadPart));
+  #elif NA_OS == NA_OS_MAC_OS_X
+    static mach_timebase_info_data_t timebase = {0, 0};
+    if(!timebase.denom)
+      mach_timebase_info(&timebase);
+    return (int64)(mach_absolute_time() * timebase.numer / timebase.denom);
+  #else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (int64)now.tv_sec * 1000000000 + (int64)now.tv_nsec;
+  #endif
+}
+
+
+
+#if NA_MUTEX_PROFILING == 1
+
+  // All mutex profiles are stored in a list which is protected by a simple
+  // spin lock. It can not be an NAMutex as it is needed when creating one.
+  NA_MutexProfile* na_FirstMutexProfile = NA_NULL;
+  int32 na_MutexProfileListLock = 0;
+
+  NA_HDEF void na_LockMutexProfileList() {
+    int32 expected = 0;
+    while(!naAtomicCompareExchangei32(&na_MutexProfileListLock, &expected, 1, NA_MEMORY_ORDER_ACQUIRE)) {
+      naAtomicPause();
+      expected = 0;
+    }
+  }
+
+  NA_HDEF void na_UnlockMutexProfileList() {
+    naAtomicStorei32(&na_MutexProfileListLock, 0, NA_MEMORY_ORDER_RELEASE);
+  }
+
+
+
+  NA_HDEF void na_RegisterMutexProfile(NA_MutexProfile* profile) {
+    na_LockMutexProfileList();
+    profile->prev = NA_NULL;
+    profile->next = na_FirstMutexProfile;
+    if(na_FirstMutexProfile)
+      na_FirstMutexProfile->prev = profile;
+    na_FirstMutexProfile = profile;
+    na_UnlockMutexProfileList();
+  }
+
+
+
+  NA_HDEF void na_UnregisterMutexProfile(NA_MutexProfile* profile) {
+    na_LockMutexProfileList();
+    if(profile->prev) {
+      profile->prev->next = profile->next;
+    }else{
+      na_FirstMutexProfile = profile->next;
+    }
+    if(profile->next)
+      profile->next->prev = profile->prev;
+    na_UnlockMutexProfileList();
+  }
+
+#endif
+
+
+
+NA_DEF size_t naGetMutexStats(NAMutexStats* stats, size_t maxCount) {
+  #if NA_MUTEX_PROFILING == 1
+    size_t count = 0;
+    const NA_MutexProfile* profile;
+    na_LockMutexProfileList();
+    for(profile = na_FirstMutexProfile; profile; profile = profile->next) {
+      if(stats) {
+        size_t i;
+        if(count == maxCount)
+          break;
+        stats[count].name = profile->name;
+        stats[count].acquireCount = (size_t)naAtomicLoadi64(&profile->acquireCount, NA_MEMORY_ORDER_RELAXED);
+        stats[count].contendedCount = (size_t)naAtomicLoadi64(&profile->contendedCount, NA_MEMORY_ORDER_RELAXED);
+        stats[count].failedTryCount = (size_t)naAtomicLoadi64(&profile->failedTryCount, NA_MEMORY_ORDER_RELAXED);
+        stats[count].totalWaitTime = (double)naAtomicLoadi64(&profile->totalWaitTime, NA_MEMORY_ORDER_RELAXED) * 1e-9;
+        stats[count].maxWaitTime = (double)naAtomicLoadi64(&profile->maxWaitTime, NA_MEMORY_ORDER_RELAXED) * 1e-9;
+        for(i = 0; i < NA_MUTEX_HOLD_HISTOGRAM_COUNT; ++i)
+          stats[count].holdHistogram[i] = (size_t)naAtomicLoadi64(&profile->holdHistogram[i], NA_MEMORY_ORDER_RELAXED);
+      }
+      count++;
+    }
+    na_UnlockMutexProfileList();
+    return count;
+  #else
+    NA_UNUSED(stats);
+    NA_UNUSED(maxCount);
+    return 0;
+  #endif
+}
+
+
+
+NA_DEF void naResetMutexStats() {
+  #if NA_MUTEX_PROFILING == 1
+    NA_MutexProfile* profile;
+    na_LockMutexProfileList();
+    for(profile = na_FirstMutexProfile; profile; profile = profile->next) {
+      size_t i;
+      na_SetMutexProfileCount(&profile->acquireCount, 0);
+      na_SetMutexProfileCount(&profile->contendedCount, 0);
+      na_SetMutexProfileCount(&profile->failedTryCount, 0);
+      na_SetMutexProfileCount(&profile->totalWaitTime, 0);
+      na_SetMutexProfileCount(&profile->maxWaitTime, 0);
+      for(i = 0; i < NA_MUTEX_HOLD_HISTOGRAM_COUNT; ++i)
+        na_SetMutexProfileCount(&profile->holdHistogram[i], 0);
+    }
+    na_UnlockMutexProfileList();
+  #endif
+}
+
+
+
+// This is free and unencumbered software released into the public domain.
+
+// Anyone is free to copy, modify, publish, use, compile, sell, or
+// distribute this software, either in source code form or as a compiled
+// binary, for any purpose, commercial or non-commercial, and by any
+// means.
+
+// In jurisdictions that recognize copyright laws, the author or authors
+// of this software dedicate any and all copyright interest in the
+// software to the public domain. We make this dedication for the benefit
+// of the public at large and to the detriment of our heirs and
+// successors. We intend this dedication to be an overt act of
+// relinquishment in perpetuity of all present and future rights to this
+// software under copyright law.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+
+// For more information, please refer to <http://unlicense.org/>
@@ -12,10 +12,18 @@
 #elif NA_OS == NA_OS_MAC_OS_X
   #include <objc/objc.h>
   #include <dispatch/dispatch.h>
+  #include <pthread.h>
   // Workaround for XCode 3 where the following macro is not defined:
   #ifndef DISPATCH_QUEUE_SERIAL
     #define DISPATCH_QUEUE_SERIAL NULL
   #endif
+#elif NA_OS == NA_OS_LINUX
+  #include <pthread.h>
+  #include <time.h>
+  #include <errno.h>
+  #include <unistd.h>
+  #include <sys/syscall.h>
+  #include <linux/futex.h>
 #endif
 
 
@@ -25,7 +33,14 @@
 // ////////////////////////////
 
 NA_IDEF int naSleepN(size_t nanoSeconds) {
-  return naSleepU(nanoSeconds / 1000);
+  #if NA_OS == NA_OS_LINUX
+    struct timespec duration;
+    duration.tv_sec = (time_t)(nanoSeconds / 1000000000);
+    duration.tv_nsec = (long)(nanoSeconds % 1000000000);
+    return nanosleep(&duration, NA_NULL);
+  #else
+    return naSleepU(nanoSeconds / 1000);
+  #endif
 }
 
 
@@ -34,7 +49,7 @@ NA_IDEF int naSleepU(size_t microSeconds) {
   #if NA_OS == NA_OS_WINDOWS
     Sleep((DWORD)(microSeconds / 1000));
     return 0;
-  #elif NA_OS == NA_OS_MAC_OS_X
+  #elif NA_IS_POSIX
     return usleep((useconds_t)(microSeconds));
   #endif
 }
@@ -45,7 +60,7 @@ NA_IDEF int naSleepM(size_t milliSeconds) {
   #if NA_OS == NA_OS_WINDOWS
     Sleep((DWORD)(milliSeconds));
     return 0;
-  #elif NA_OS == NA_OS_MAC_OS_X
+  #elif NA_IS_POSIX
     return usleep((useconds_t)(milliSeconds * 1000LL));
   #endif
 }
@@ -56,7 +71,7 @@ NA_IDEF int naSleepS(double seconds) {
   #if NA_OS == NA_OS_WINDOWS
     Sleep((DWORD)(seconds * 1000));
     return 0;
-  #elif NA_OS == NA_OS_MAC_OS_X
+  #elif NA_IS_POSIX
     return usleep((useconds_t)(seconds * 1000000LL));
   #endif
 }
@@ -80,6 +95,8 @@ NA_IDEF int naSleepS(double seconds) {
   typedef HANDLE            NANativeThread;
 #elif NA_OS == NA_OS_MAC_OS_X
   typedef dispatch_queue_t  NANativeThread;
+#elif NA_OS == NA_OS_LINUX
+  typedef pthread_t         NANativeThread;
 #endif
 
 
@@ -88,6 +105,8 @@ struct NAThreadStruct{
   const char* name;
   #if NA_OS == NA_OS_MAC_OS_X
     dispatch_group_t dispatchGroup; // Needed to wait for threads.
+  #elif NA_OS == NA_OS_LINUX
+    NABool joinable;                // Needed to join or detach exactly once.
   #endif
   NANativeThread nativeThread;  // If you experience an error here when working
   NAMutator function;           // with plain C files on a Mac: Turn off the
@@ -101,6 +120,9 @@ NA_IDEF NAThread naMakeThread(const char* threadName, NAMutator function, void*
   threadstruct->name = threadName;
   #if NA_OS == NA_OS_WINDOWS
     threadstruct->nativeThread = NA_NULL; // Note that on windows, creating the thread would immediately start it.
+  #elif NA_OS == NA_OS_LINUX
+    // Same as on windows: creating a pthread immediately starts it.
+    threadstruct->joinable = NA_FALSE;
   #else
     threadstruct->dispatchGroup = dispatch_group_create();
     threadstruct->nativeThread = dispatch_queue_create(threadName, DISPATCH_QUEUE_SERIAL);
@@ -116,6 +138,9 @@ NA_IDEF void naClearThread(NAThread thread) {
   NAThreadStruct* threadstruct = (NAThreadStruct*)thread;
   #if NA_OS == NA_OS_WINDOWS
     CloseHandle(threadstruct->nativeThread);
+  #elif NA_OS == NA_OS_LINUX
+    if(threadstruct->joinable)
+      pthread_detach(threadstruct->nativeThread);
   #else
     #if NA_MACOS_USES_ARC
       // Thread will be released automatically when ARC is turned on.
@@ -137,6 +162,13 @@ NA_IDEF void naClearThread(NAThread thread) {
     thread->function(thread->arg);
     return 0;
   }
+#elif NA_OS == NA_OS_LINUX
+  // Same for pthreads which expect a function returning a pointer.
+  NA_HDEF static void* na_RunPosixThread(void* arg) {
+    NAThreadStruct* thread = (NAThreadStruct*)arg;
+    thread->function(thread->arg);
+    return NA_NULL;
+  }
 #endif
 
 
@@ -145,6 +177,13 @@ NA_IDEF void naRunThread(NAThread thread) {
   NAThreadStruct* threadstruct = (NAThreadStruct*)thread;
   #if NA_OS == NA_OS_WINDOWS
     threadstruct->nativeThread = CreateThread(NULL, 0, na_RunWindowsThread, threadstruct, 0, 0);
+  #elif NA_OS == NA_OS_LINUX
+    #if NA_DEBUG
+      if(threadstruct->joinable)
+        naError("Thread is still running or has not been awaited.");
+    #endif
+    if(pthread_create(&threadstruct->nativeThread, NA_NULL, na_RunPosixThread, threadstruct) == 0)
+      threadstruct->joinable = NA_TRUE;
   #else
     dispatch_group_async_f(threadstruct->dispatchGroup, threadstruct->nativeThread, threadstruct->arg, threadstruct->function);
   #endif
@@ -156,6 +195,11 @@ NA_IDEF void naAwaitThread(NAThread thread) {
   NAThreadStruct* threadstruct = (NAThreadStruct*)thread;
   #if NA_OS == NA_OS_WINDOWS
     WaitForSingleObject(threadstruct->nativeThread, INFINITE);
+  #elif NA_OS == NA_OS_LINUX
+    if(threadstruct->joinable) {
+      pthread_join(threadstruct->nativeThread, NA_NULL);
+      threadstruct->joinable = NA_FALSE;
+    }
   #else
     dispatch_group_wait(threadstruct->dispatchGroup, DISPATCH_TIME_FOREVER);
   #endif
@@ -192,6 +236,36 @@ NA_IDEF void naAwaitThread(NAThread thread) {
   // the same thread. The author thinks that this is inconsistent and therefore
   // has implemented mutexes like this to be the same on all systems.
 
+#elif NA_OS == NA_OS_LINUX
+
+  // On Linux, a mutex is a single futex word. The state is 0 when unlocked,
+  // 1 when locked and 2 when locked with possibly sleeping waiters. Locking
+  // and unlocking an uncontended mutex therefore is just one atomic operation
+  // in user space. Only when there is contention, the kernel is called.
+  NA_PROTOTYPE(NALinuxMutex);
+  struct NALinuxMutex{
+    int32 state;
+    #if NA_DEBUG
+      NABool seemslocked;
+    #endif
+  };
+
+  // Number of times a contended lock polls the state before going to sleep.
+  #define NA_LINUX_MUTEX_SPIN_COUNT 100
+
+  NA_HIDEF long na_FutexWait(int32* addr, int32 expected, const struct timespec* timeout) {
+    return syscall(SYS_futex, addr, FUTEX_WAIT_PRIVATE, expected, timeout, NA_NULL, 0);
+  }
+
+  NA_HIDEF long na_FutexWake(int32* addr, int32 count) {
+    return syscall(SYS_futex, addr, FUTEX_WAKE_PRIVATE, count, NA_NULL, NA_NULL, 0);
+  }
+
+  NA_HIDEF int32 na_CompareExchangeFutexState(int32* addr, int32 expected, int32 desired) {
+    naAtomicCompareExchangei32(addr, &expected, desired, NA_MEMORY_ORDER_ACQUIRE);
+    return expected;
+  }
+
 #else
 
   #if NA_DEBUG
@@ -209,7 +283,13 @@ NA_IDEF void naAwaitThread(NAThread thread) {
 
 
 
-NA_IDEF NAMutex naMakeMutex(void) {
+#if NA_DEBUG
+  NA_HIAPI NABool na_IsNativeMutexLocked(NAMutex mutex);
+#endif
+
+
+
+NA_HIDEF NAMutex na_MakeNativeMutex(void) {
   #if NA_OS == NA_OS_WINDOWS
     NAWindowsMutex* windowsMutex = naAlloc(NAWindowsMutex);
     #if(NA_WINDOWS_MUTEX_USE_CRITICAL_SECTION == 1)
@@ -222,6 +302,13 @@ NA_IDEF NAMutex naMakeMutex(void) {
       windowsMutex->seemslocked = NA_FALSE;
     #endif
     return windowsMutex;
+  #elif NA_OS == NA_OS_LINUX
+    NALinuxMutex* linuxMutex = naAlloc(NALinuxMutex);
+    linuxMutex->state = 0;
+    #if NA_DEBUG
+      linuxMutex->seemslocked = NA_FALSE;
+    #endif
+    return linuxMutex;
   #else
 
     #if NA_DEBUG
@@ -238,7 +325,7 @@ NA_IDEF NAMutex naMakeMutex(void) {
 
 
 
-NA_IDEF void naClearMutex(NAMutex mutex) {
+NA_HIDEF void na_ClearNativeMutex(NAMutex mutex) {
   #if NA_OS == NA_OS_WINDOWS
     NAWindowsMutex* windowsMutex = (NAWindowsMutex*)mutex;
     #if(NA_WINDOWS_MUTEX_USE_CRITICAL_SECTION == 1)
@@ -247,6 +334,8 @@ NA_IDEF void naClearMutex(NAMutex mutex) {
       CloseHandle(windowsMutex->mutex);
     #endif
     naFree(windowsMutex);
+  #elif NA_OS == NA_OS_LINUX
+    naFree(mutex);
   #else
     #if NA_DEBUG
       NAMacintoshMutex* macintoshmutex = (NAMacintoshMutex*)mutex;
@@ -272,7 +361,7 @@ NA_IDEF void naClearMutex(NAMutex mutex) {
 #if(NA_OS == NA_OS_WINDOWS) && (NA_WINDOWS_MUTEX_USE_CRITICAL_SECTION == 1)
   _Acquires_lock_(((NAWindowsMutex*)mutex)->mutex)
 #endif
-NA_IDEF void naLockMutex(NAMutex mutex) {
+NA_HIDEF void na_LockNativeMutex(NAMutex mutex) {
   #if NA_OS == NA_OS_WINDOWS
     NAWindowsMutex* windowsMutex = (NAWindowsMutex*)mutex;
     #if(NA_WINDOWS_MUTEX_USE_CRITICAL_SECTION == 1)
@@ -288,7 +377,32 @@ NA_IDEF void naLockMutex(NAMutex mutex) {
     #if NA_DEBUG
       windowsMutex->seemslocked = NA_TRUE;
     #endif
-   #else
+  #elif NA_OS == NA_OS_LINUX
+    NALinuxMutex* linuxMutex = (NALinuxMutex*)mutex;
+    int32 state = na_CompareExchangeFutexState(&linuxMutex->state, 0, 1);
+    if(state != 0) {
+      // Contended: Spin a little in case the owner releases the lock soon.
+      size_t spin;
+      for(spin = 0; spin < NA_LINUX_MUTEX_SPIN_COUNT && state == 1; ++spin) {
+        naAtomicPause();
+        state = na_CompareExchangeFutexState(&linuxMutex->state, 0, 1);
+        if(state == 0)
+          break;
+      }
+      // Still locked: Mark the mutex as having waiters and go to sleep.
+      if(state != 0) {
+        if(state != 2)
+          state = naAtomicExchangei32(&linuxMutex->state, 2, NA_MEMORY_ORDER_ACQUIRE);
+        while(state != 0) {
+          na_FutexWait(&linuxMutex->state, 2, NA_NULL);
+          state = naAtomicExchangei32(&linuxMutex->state, 2, NA_MEMORY_ORDER_ACQUIRE);
+        }
+      }
+    }
+    #if NA_DEBUG
+      linuxMutex->seemslocked = NA_TRUE;
+    #endif
+  #else
     #if NA_DEBUG
       NAMacintoshMutex* macintoshmutex = (NAMacintoshMutex*)mutex;
       dispatch_semaphore_wait(macintoshmutex->mutex, DISPATCH_TIME_FOREVER);
@@ -304,11 +418,11 @@ NA_IDEF void naLockMutex(NAMutex mutex) {
 #if(NA_OS == NA_OS_WINDOWS) && (NA_WINDOWS_MUTEX_USE_CRITICAL_SECTION == 1)
   _Releases_lock_(((NAWindowsMutex*)mutex)->mutex)
 #endif
-NA_IDEF void naUnlockMutex(NAMutex mutex) {
+NA_HIDEF void na_UnlockNativeMutex(NAMutex mutex) {
   #if NA_OS == NA_OS_WINDOWS
     NAWindowsMutex* windowsMutex = (NAWindowsMutex*)mutex;
     #if NA_DEBUG
-      if(!naIsMutexLocked(mutex))
+      if(!na_IsNativeMutexLocked(mutex))
         naError("Mutex was not locked. Note: If this only happends once and very rarely, it might be because this check is unreliable!");
     #endif
     #if NA_DEBUG
@@ -320,6 +434,18 @@ NA_IDEF void naUnlockMutex(NAMutex mutex) {
     #else
       ReleaseMutex(windowsMutex->mutex);
     #endif
+  #elif NA_OS == NA_OS_LINUX
+    NALinuxMutex* linuxMutex = (NALinuxMutex*)mutex;
+    #if NA_DEBUG
+      if(!na_IsNativeMutexLocked(mutex))
+        naError("Mutex was not locked. Note: If this only happends once and very rarely, it might be because this check is unreliable!");
+      linuxMutex->seemslocked = NA_FALSE;
+    #endif
+    // Only call the kernel if someone might be waiting.
+    if(naAtomicAddi32(&linuxMutex->state, -1, NA_MEMORY_ORDER_RELEASE) != 1) {
+      naAtomicStorei32(&linuxMutex->state, 0, NA_MEMORY_ORDER_RELEASE);
+      na_FutexWake(&linuxMutex->state, 1);
+    }
   #else
     #if NA_DEBUG
       NAMacintoshMutex* macintoshmutex = (NAMacintoshMutex*)mutex;
@@ -334,10 +460,13 @@ NA_IDEF void naUnlockMutex(NAMutex mutex) {
 
 
 #if NA_DEBUG
-  NA_IDEF NABool naIsMutexLocked(NAMutex mutex) {
+  NA_HIDEF NABool na_IsNativeMutexLocked(NAMutex mutex) {
     #if NA_OS == NA_OS_WINDOWS
       NAWindowsMutex* windowsMutex = (NAWindowsMutex*)mutex;
       return windowsMutex->seemslocked;
+    #elif NA_OS == NA_OS_LINUX
+      NALinuxMutex* linuxMutex = (NALinuxMutex*)mutex;
+      return linuxMutex->seemslocked;
     #else
       NAMacintoshMutex* macintoshmutex = (NAMacintoshMutex*)mutex;
       return macintoshmutex->seemslocked;
@@ -363,7 +492,7 @@ NA_IDEF void naUnlockMutex(NAMutex mutex) {
 #if(NA_OS == NA_OS_WINDOWS) && (NA_WINDOWS_MUTEX_USE_CRITICAL_SECTION == 1)
   _When_(return == NA_TRUE, _Acquires_lock_(((NAWindowsMutex*)mutex)->mutex))
 #endif
-NA_IDEF NABool naTryMutex(NAMutex mutex) {
+NA_HIDEF NABool na_TryNativeMutex(NAMutex mutex) {
   #if NA_OS == NA_OS_WINDOWS
     NAWindowsMutex* windowsMutex = (NAWindowsMutex*)mutex;
     #if(NA_WINDOWS_MUTEX_USE_CRITICAL_SECTION == 1)
@@ -394,6 +523,14 @@ NA_IDEF NABool naTryMutex(NAMutex mutex) {
         }
       }
     #endif
+  #elif NA_OS == NA_OS_LINUX
+    NALinuxMutex* linuxMutex = (NALinuxMutex*)mutex;
+    if(na_CompareExchangeFutexState(&linuxMutex->state, 0, 1) != 0)
+      return NA_FALSE;
+    #if NA_DEBUG
+      linuxMutex->seemslocked = NA_TRUE;
+    #endif
+    return NA_TRUE;
   #else
     #if NA_DEBUG
       NAMacintoshMutex* macintoshmutex = (NAMacintoshMutex*)mutex;
@@ -413,6 +550,487 @@ NA_IDEF NABool naTryMutex(NAMutex mutex) {
 
 
 
+// Returns a monotonic time in nanoseconds. Used for profiling and for
+// timeouts spanning multiple waits.
+NA_HAPI int64 na_GetMonotonicTime(void);
+
+
+
+// ////////////////////////////
+// MUTEX PROFILING
+// ////////////////////////////
+
+#if NA_MUTEX_PROFILING == 1
+
+  // With profiling, an NAMutex points to a profile wrapping the native mutex.
+  // All counters except for lockTime are registered globally and read by
+  // naGetMutexStats, hence they are updated atomically. Except for
+  // failedTryCount, they are only written by the thread holding the mutex,
+  // so no read-modify-write operations are needed. failedTryCount is
+  // written by threads which did not get the mutex and which may fail at
+  // the same time, therefore it is incremented with an atomic add.
+  NA_PROTOTYPE(NA_MutexProfile);
+  struct NA_MutexProfile{
+    NAMutex native;
+    const char* name;
+    int64 lockTime;             // Time of the last lock, in nanoseconds
+    int64 acquireCount;
+    int64 contendedCount;
+    int64 failedTryCount;
+    int64 totalWaitTime;        // in nanoseconds
+    int64 maxWaitTime;          // in nanoseconds
+    int64 holdHistogram[NA_MUTEX_HOLD_HISTOGRAM_COUNT];
+    NA_MutexProfile* prev;
+    NA_MutexProfile* next;
+  };
+
+  NA_HAPI void na_RegisterMutexProfile(NA_MutexProfile* profile);
+  NA_HAPI void na_UnregisterMutexProfile(NA_MutexProfile* profile);
+
+  NA_HIDEF void na_SetMutexProfileCount(int64* count, int64 value) {
+    naAtomicStorei64(count, value, NA_MEMORY_ORDER_RELAXED);
+  }
+
+  NA_HIDEF void na_IncMutexProfileCount(int64* count, int64 value) {
+    na_SetMutexProfileCount(count, naAtomicLoadi64(count, NA_MEMORY_ORDER_RELAXED) + value);
+  }
+
+  NA_HIDEF void na_StartMutexProfileHold(NA_MutexProfile* profile) {
+    na_IncMutexProfileCount(&profile->acquireCount, 1);
+    profile->lockTime = na_GetMonotonicTime();
+  }
+
+  NA_HIDEF void na_EndMutexProfileHold(NA_MutexProfile* profile) {
+    // Entry i counts holds of less than 2^i microseconds.
+    int64 microSeconds = (na_GetMonotonicTime() - profile->lockTime) / 1000;
+    size_t index = 0;
+    while(microSeconds > 0 && index < NA_MUTEX_HOLD_HISTOGRAM_COUNT - 1) {
+      microSeconds >>= 1;
+      index++;
+    }
+    na_IncMutexProfileCount(&profile->holdHistogram[index], 1);
+  }
+
+#endif
+
+
+
+NA_IDEF NAMutex naMakeMutex(void) {
+  #if NA_MUTEX_PROFILING == 1
+    NA_MutexProfile* profile = naAlloc(NA_MutexProfile);
+    size_t i;
+    profile->native = na_MakeNativeMutex();
+    profile->name = NA_NULL;
+    profile->lockTime = 0;
+    profile->acquireCount = 0;
+    profile->contendedCount = 0;
+    profile->failedTryCount = 0;
+    profile->totalWaitTime = 0;
+    profile->maxWaitTime = 0;
+    for(i = 0; i < NA_MUTEX_HOLD_HISTOGRAM_COUNT; ++i)
+      profile->holdHistogram[i] = 0;
+    na_RegisterMutexProfile(profile);
+    return profile;
+  #else
+    return na_MakeNativeMutex();
+  #endif
+}
+
+
+
+NA_IDEF void naClearMutex(NAMutex mutex) {
+  #if NA_MUTEX_PROFILING == 1
+    NA_MutexProfile* profile = (NA_MutexProfile*)mutex;
+    na_UnregisterMutexProfile(profile);
+    na_ClearNativeMutex(profile->native);
+    naFree(profile);
+  #else
+    na_ClearNativeMutex(mutex);
+  #endif
+}
+
+
+
+NA_IDEF void naLockMutex(NAMutex mutex) {
+  #if NA_MUTEX_PROFILING == 1
+    NA_MutexProfile* profile = (NA_MutexProfile*)mutex;
+    if(!na_TryNativeMutex(profile->native)) {
+      int64 waitStart = na_GetMonotonicTime();
+      int64 waitTime;
+      na_LockNativeMutex(profile->native);
+      waitTime = na_GetMonotonicTime() - waitStart;
+      na_IncMutexProfileCount(&profile->contendedCount, 1);
+      na_IncMutexProfileCount(&profile->totalWaitTime, waitTime);
+      if(waitTime > naAtomicLoadi64(&profile->maxWaitTime, NA_MEMORY_ORDER_RELAXED))
+        na_SetMutexProfileCount(&profile->maxWaitTime, waitTime);
+    }
+    na_StartMutexProfileHold(profile);
+  #else
+    na_LockNativeMutex(mutex);
+  #endif
+}
+
+
+
+NA_IDEF void naUnlockMutex(NAMutex mutex) {
+  #if NA_MUTEX_PROFILING == 1
+    NA_MutexProfile* profile = (NA_MutexProfile*)mutex;
+    na_EndMutexProfileHold(profile);
+    na_UnlockNativeMutex(profile->native);
+  #else
+    na_UnlockNativeMutex(mutex);
+  #endif
+}
+
+
+
+#if NA_DEBUG
+  NA_IDEF NABool naIsMutexLocked(NAMutex mutex) {
+    #if NA_MUTEX_PROFILING == 1
+      return na_IsNativeMutexLocked(((NA_MutexProfile*)mutex)->native);
+    #else
+      return na_IsNativeMutexLocked(mutex);
+    #endif
+  }
+#endif
+
+
+
+NA_IDEF NABool naTryMutex(NAMutex mutex) {
+  #if NA_MUTEX_PROFILING == 1
+    NA_MutexProfile* profile = (NA_MutexProfile*)mutex;
+    if(!na_TryNativeMutex(profile->native)) {
+      naAtomicAddi64(&profile->failedTryCount, 1, NA_MEMORY_ORDER_RELAXED);
+      return NA_FALSE;
+    }
+    na_StartMutexProfileHold(profile);
+    return NA_TRUE;
+  #else
+    return na_TryNativeMutex(mutex);
+  #endif
+}
+
+
+
+NA_IDEF void naSetMutexName(NAMutex mutex, const char* name) {
+  #if NA_MUTEX_PROFILING == 1
+    ((NA_MutexProfile*)mutex)->name = name;
+  #else
+    NA_UNUSED(mutex);
+    NA_UNUSED(name);
+  #endif
+}
+
+
+
+// ////////////////////////////
+// READER-WRITER LOCKS
+// ////////////////////////////
+
+#if NA_OS == NA_OS_WINDOWS
+  typedef SRWLOCK NANativeRWLock;
+#else
+  typedef pthread_rwlock_t NANativeRWLock;
+#endif
+
+NA_PROTOTYPE(NA_RWLock);
+struct NA_RWLock{
+  NANativeRWLock lock;
+  #if NA_DEBUG
+    int32 readerCount;
+    NABool seemsWriteLocked;
+  #endif
+};
+
+
+
+NA_IDEF NARWLock naMakeRWLock(void) {
+  NA_RWLock* rwLock = naAlloc(NA_RWLock);
+  #if NA_OS == NA_OS_WINDOWS
+    InitializeSRWLock(&rwLock->lock);
+  #else
+    pthread_rwlock_init(&rwLock->lock, NA_NULL);
+  #endif
+  #if NA_DEBUG
+    rwLock->readerCount = 0;
+    rwLock->seemsWriteLocked = NA_FALSE;
+  #endif
+  return rwLock;
+}
+
+
+
+NA_IDEF void naClearRWLock(NARWLock lock) {
+  NA_RWLock* rwLock = (NA_RWLock*)lock;
+  #if NA_DEBUG
+    if(rwLock->readerCount || rwLock->seemsWriteLocked)
+      naError("Lock is still locked.");
+  #endif
+  #if NA_OS != NA_OS_WINDOWS
+    // SRW locks need no cleanup.
+    pthread_rwlock_destroy(&rwLock->lock);
+  #endif
+  naFree(rwLock);
+}
+
+
+
+NA_IDEF void naLockRWLockShared(NARWLock lock) {
+  NA_RWLock* rwLock = (NA_RWLock*)lock;
+  #if NA_OS == NA_OS_WINDOWS
+    AcquireSRWLockShared(&rwLock->lock);
+  #else
+    pthread_rwlock_rdlock(&rwLock->lock);
+  #endif
+  #if NA_DEBUG
+    naAtomicAddi32(&rwLock->readerCount, 1, NA_MEMORY_ORDER_RELAXED);
+  #endif
+}
+
+
+
+NA_IDEF void naUnlockRWLockShared(NARWLock lock) {
+  NA_RWLock* rwLock = (NA_RWLock*)lock;
+  #if NA_DEBUG
+    if(naAtomicAddi32(&rwLock->readerCount, -1, NA_MEMORY_ORDER_RELAXED) <= 0)
+      naError("Lock was not locked shared.");
+  #endif
+  #if NA_OS == NA_OS_WINDOWS
+    ReleaseSRWLockShared(&rwLock->lock);
+  #else
+    pthread_rwlock_unlock(&rwLock->lock);
+  #endif
+}
+
+
+
+NA_IDEF void naLockRWLockExclusive(NARWLock lock) {
+  NA_RWLock* rwLock = (NA_RWLock*)lock;
+  #if NA_OS == NA_OS_WINDOWS
+    AcquireSRWLockExclusive(&rwLock->lock);
+  #else
+    pthread_rwlock_wrlock(&rwLock->lock);
+  #endif
+  #if NA_DEBUG
+    rwLock->seemsWriteLocked = NA_TRUE;
+  #endif
+}
+
+
+
+NA_IDEF void naUnlockRWLockExclusive(NARWLock lock) {
+  NA_RWLock* rwLock = (NA_RWLock*)lock;
+  #if NA_DEBUG
+    if(!rwLock->seemsWriteLocked)
+      naError("Lock was not locked exclusive.");
+    rwLock->seemsWriteLocked = NA_FALSE;
+  #endif
+  #if NA_OS == NA_OS_WINDOWS
+    ReleaseSRWLockExclusive(&rwLock->lock);
+  #else
+    pthread_rwlock_unlock(&rwLock->lock);
+  #endif
+}
+
+
+
+NA_IDEF NABool naTryRWLockShared(NARWLock lock) {
+  NA_RWLock* rwLock = (NA_RWLock*)lock;
+  #if NA_OS == NA_OS_WINDOWS
+    if(!TryAcquireSRWLockShared(&rwLock->lock))
+      return NA_FALSE;
+  #else
+    if(pthread_rwlock_tryrdlock(&rwLock->lock) != 0)
+      return NA_FALSE;
+  #endif
+  #if NA_DEBUG
+    naAtomicAddi32(&rwLock->readerCount, 1, NA_MEMORY_ORDER_RELAXED);
+  #endif
+  return NA_TRUE;
+}
+
+
+
+NA_IDEF NABool naTryRWLockExclusive(NARWLock lock) {
+  NA_RWLock* rwLock = (NA_RWLock*)lock;
+  #if NA_OS == NA_OS_WINDOWS
+    if(!TryAcquireSRWLockExclusive(&rwLock->lock))
+      return NA_FALSE;
+  #else
+    if(pthread_rwlock_trywrlock(&rwLock->lock) != 0)
+      return NA_FALSE;
+  #endif
+  #if NA_DEBUG
+    rwLock->seemsWriteLocked = NA_TRUE;
+  #endif
+  return NA_TRUE;
+}
+
+
+
+// ////////////////////////////
+// SPIN MUTEXES
+// ////////////////////////////
+
+// A spin mutex counts the threads holding or wanting the lock. A thread
+// increasing the count from 0 owns the lock, every other one sleeps on a
+// semaphore which the unlocking thread signals once per waiter. Before
+// increasing the count, a thread polls for a count of 0 for a while.
+
+#if NA_OS == NA_OS_WINDOWS
+  typedef HANDLE NA_SpinMutexSemaphore;
+#elif NA_OS == NA_OS_MAC_OS_X
+  typedef dispatch_semaphore_t NA_SpinMutexSemaphore;
+#elif NA_OS == NA_OS_LINUX
+  // The number of pending signals, used as a futex.
+  typedef int32 NA_SpinMutexSemaphore;
+#endif
+
+NA_PROTOTYPE(NA_SpinMutex);
+struct NA_SpinMutex{
+  int32 count;
+  int32 spinEstimate;   // Average number of polls needed lately.
+  NA_SpinMutexSemaphore semaphore;
+  #if NA_DEBUG
+    NABool seemslocked;
+  #endif
+};
+
+
+
+NA_HIDEF void na_WaitSpinMutexSemaphore(NA_SpinMutex* spinMutex) {
+  #if NA_OS == NA_OS_WINDOWS
+    WaitForSingleObject(spinMutex->semaphore, INFINITE);
+  #elif NA_OS == NA_OS_MAC_OS_X
+    dispatch_semaphore_wait(spinMutex->semaphore, DISPATCH_TIME_FOREVER);
+  #elif NA_OS == NA_OS_LINUX
+    int32 signals = naAtomicLoadi32(&spinMutex->semaphore, NA_MEMORY_ORDER_ACQUIRE);
+    while(1) {
+      if(signals == 0) {
+        na_FutexWait(&spinMutex->semaphore, 0, NA_NULL);
+        signals = naAtomicLoadi32(&spinMutex->semaphore, NA_MEMORY_ORDER_ACQUIRE);
+      }else if(naAtomicCompareExchangei32(&spinMutex->semaphore, &signals, signals - 1, NA_MEMORY_ORDER_ACQUIRE)) {
+        break;
+      }
+    }
+  #endif
+}
+
+
+
+NA_HIDEF void na_SignalSpinMutexSemaphore(NA_SpinMutex* spinMutex) {
+  #if NA_OS == NA_OS_WINDOWS
+    ReleaseSemaphore(spinMutex->semaphore, 1, NA_NULL);
+  #elif NA_OS == NA_OS_MAC_OS_X
+    dispatch_semaphore_signal(spinMutex->semaphore);
+  #elif NA_OS == NA_OS_LINUX
+    naAtomicAddi32(&spinMutex->semaphore, 1, NA_MEMORY_ORDER_RELEASE);
+    na_FutexWake(&spinMutex->semaphore, 1);
+  #endif
+}
+
+
+
+NA_IDEF NASpinMutex naMakeSpinMutex(void) {
+  NA_SpinMutex* spinMutex = naAlloc(NA_SpinMutex);
+  spinMutex->count = 0;
+  spinMutex->spinEstimate = 0;
+  #if NA_OS == NA_OS_WINDOWS
+    spinMutex->semaphore = CreateSemaphore(NA_NULL, 0, 0x7fffffff, NA_NULL);
+  #elif NA_OS == NA_OS_MAC_OS_X
+    spinMutex->semaphore = dispatch_semaphore_create(0);
+  #elif NA_OS == NA_OS_LINUX
+    spinMutex->semaphore = 0;
+  #endif
+  #if NA_DEBUG
+    spinMutex->seemslocked = NA_FALSE;
+  #endif
+  return spinMutex;
+}
+
+
+
+NA_IDEF void naClearSpinMutex(NASpinMutex mutex) {
+  NA_SpinMutex* spinMutex = (NA_SpinMutex*)mutex;
+  #if NA_DEBUG
+    if(spinMutex->count)
+      naError("Mutex is still locked.");
+  #endif
+  #if NA_OS == NA_OS_WINDOWS
+    CloseHandle(spinMutex->semaphore);
+  #elif NA_OS == NA_OS_MAC_OS_X
+    #if !NA_MACOS_USES_ARC
+      dispatch_release(spinMutex->semaphore);
+    #endif
+  #endif
+  naFree(spinMutex);
+}
+
+
+
+NA_IDEF void naLockSpinMutex(NASpinMutex mutex) {
+  NA_SpinMutex* spinMutex = (NA_SpinMutex*)mutex;
+  int32 expected = 0;
+  if(!naAtomicCompareExchangei32(&spinMutex->count, &expected, 1, NA_MEMORY_ORDER_ACQUIRE)) {
+    // Poll up to twice as long as it took lately, then go to sleep. The
+    // estimate is only a hint, hence the relaxed and racy update.
+    int32 estimate = naAtomicLoadi32(&spinMutex->spinEstimate, NA_MEMORY_ORDER_RELAXED);
+    int32 maxSpin = 2 * estimate + 10;
+    int32 spin;
+    NABool locked = NA_FALSE;
+    if(maxSpin > NA_SPIN_MUTEX_MAX_SPIN_COUNT)
+      maxSpin = NA_SPIN_MUTEX_MAX_SPIN_COUNT;
+    for(spin = 0; spin < maxSpin; ++spin) {
+      naAtomicPause();
+      if(naAtomicLoadi32(&spinMutex->count, NA_MEMORY_ORDER_RELAXED) == 0) {
+        expected = 0;
+        if(naAtomicCompareExchangei32(&spinMutex->count, &expected, 1, NA_MEMORY_ORDER_ACQUIRE)) {
+          locked = NA_TRUE;
+          break;
+        }
+      }
+    }
+    naAtomicStorei32(&spinMutex->spinEstimate, estimate + (spin - estimate) / 8, NA_MEMORY_ORDER_RELAXED);
+
+    if(!locked) {
+      if(naAtomicAddi32(&spinMutex->count, 1, NA_MEMORY_ORDER_ACQUIRE) != 0)
+        na_WaitSpinMutexSemaphore(spinMutex);
+    }
+  }
+  #if NA_DEBUG
+    spinMutex->seemslocked = NA_TRUE;
+  #endif
+}
+
+
+
+NA_IDEF void naUnlockSpinMutex(NASpinMutex mutex) {
+  NA_SpinMutex* spinMutex = (NA_SpinMutex*)mutex;
+  #if NA_DEBUG
+    if(!spinMutex->seemslocked)
+      naError("Mutex was not locked.");
+    spinMutex->seemslocked = NA_FALSE;
+  #endif
+  // Hand the lock over to one of the sleeping threads, if any.
+  if(naAtomicAddi32(&spinMutex->count, -1, NA_MEMORY_ORDER_RELEASE) > 1)
+    na_SignalSpinMutexSemaphore(spinMutex);
+}
+
+
+
+NA_IDEF NABool naTrySpinMutex(NASpinMutex mutex) {
+  NA_SpinMutex* spinMutex = (NA_SpinMutex*)mutex;
+  int32 expected = 0;
+  if(!naAtomicCompareExchangei32(&spinMutex->count, &expected, 1, NA_MEMORY_ORDER_ACQUIRE))
+    return NA_FALSE;
+  #if NA_DEBUG
+    spinMutex->seemslocked = NA_TRUE;
+  #endif
+  return NA_TRUE;
+}
+
+
+
 // ////////////////////////////
 // ALARMS
 // ////////////////////////////
@@ -422,6 +1040,11 @@ NA_IDEF NABool naTryMutex(NAMutex mutex) {
   typedef HANDLE            NANativeAlarm;
 #elif NA_OS == NA_OS_MAC_OS_X
   typedef dispatch_semaphore_t  NANativeAlarm;
+#elif NA_OS == NA_OS_LINUX
+  // On Linux, an alarm is a futex sequence counter. Awaiting threads sleep as
+  // long as the counter stays the same, triggering increments it and wakes
+  // one of them. Triggers without waiting threads are therefore not stored.
+  typedef int32*                NANativeAlarm;
 #endif
 
 
@@ -431,7 +1054,11 @@ NA_IDEF NAAlarm naMakeAlarm(void) {
   #if NA_OS == NA_OS_WINDOWS
     alarmer = CreateEvent(NULL, FALSE, FALSE, NULL);
     return (NAAlarm)alarmer;
-#else
+  #elif NA_OS == NA_OS_LINUX
+    alarmer = naAlloc(int32);
+    *alarmer = 0;
+    return (NAAlarm)alarmer;
+  #else
     alarmer = dispatch_semaphore_create(0);
     return (NAAlarm)NA_COCOA_PTR_OBJC_TO_C(alarmer);
   #endif
@@ -442,6 +1069,8 @@ NA_IDEF NAAlarm naMakeAlarm(void) {
 NA_IDEF void naClearAlarm(NAAlarm alarmer) {
   #if NA_OS == NA_OS_WINDOWS
     CloseHandle(alarmer);
+  #elif NA_OS == NA_OS_LINUX
+    naFree(alarmer);
   #else
     #if NA_MACOS_USES_ARC
       NA_UNUSED(alarmer);
@@ -468,6 +1097,8 @@ NA_IDEF NABool naAwaitAlarm(NAAlarm alarmer, double maxWaitTime) {
       result = WaitForSingleObject(alarmer, (DWORD)(1000. * maxWaitTime));
     }
     return (result == WAIT_OBJECT_0);
+  #elif NA_OS == NA_OS_LINUX
+    return naAwaitAlarmTicket(alarmer, naGetAlarmTicket(alarmer), maxWaitTime);
   #else
     long result;
     #if NA_DEBUG
@@ -486,9 +1117,87 @@ NA_IDEF NABool naAwaitAlarm(NAAlarm alarmer, double maxWaitTime) {
 
 
 
+NA_IDEF int32 naGetAlarmTicket(NAAlarm alarmer) {
+  #if NA_OS == NA_OS_LINUX
+    return naAtomicLoadi32((NANativeAlarm)alarmer, NA_MEMORY_ORDER_ACQUIRE);
+  #else
+    // Events and semaphores keep a trigger without waiting threads until the
+    // next wait, hence no ticket is needed.
+    NA_UNUSED(alarmer);
+    return 0;
+  #endif
+}
+
+
+
+NA_IDEF NABool naAwaitAlarmTicket(NAAlarm alarmer, int32 ticket, double maxWaitTime) {
+  #if NA_OS == NA_OS_WINDOWS
+    DWORD result;
+    NA_UNUSED(ticket);
+    #if NA_DEBUG
+      if(maxWaitTime < 0.)
+        naError("maxWaitTime is negative. Beware of the zero!");
+    #endif
+    // Unlike naAwaitAlarm, the event is not reset such that a trigger since
+    // the ticket is detected.
+    if(maxWaitTime == 0) {
+      result = WaitForSingleObject(alarmer, INFINITE);
+    }else{
+      result = WaitForSingleObject(alarmer, (DWORD)(1000. * maxWaitTime));
+    }
+    return (result == WAIT_OBJECT_0);
+  #elif NA_OS == NA_OS_LINUX
+    NANativeAlarm sequence = (NANativeAlarm)alarmer;
+    struct timespec deadline;
+    #if NA_DEBUG
+      if(maxWaitTime < 0.)
+        naError("maxWaitTime is negative. Beware of the zero!");
+    #endif
+    if(maxWaitTime != 0) {
+      clock_gettime(CLOCK_MONOTONIC, &deadline);
+      deadline.tv_sec += (time_t)maxWaitTime;
+      deadline.tv_nsec += (long)((maxWaitTime - (double)(time_t)maxWaitTime) * 1000000000.);
+      if(deadline.tv_nsec >= 1000000000) {
+        deadline.tv_sec += 1;
+        deadline.tv_nsec -= 1000000000;
+      }
+    }
+    while(naAtomicLoadi32(sequence, NA_MEMORY_ORDER_ACQUIRE) == ticket) {
+      if(maxWaitTime == 0) {
+        na_FutexWait(sequence, ticket, NA_NULL);
+      }else{
+        // FUTEX_WAIT expects a relative timeout. Recompute it after every
+        // spurious wakeup.
+        struct timespec now;
+        struct timespec remaining;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        remaining.tv_sec = deadline.tv_sec - now.tv_sec;
+        remaining.tv_nsec = deadline.tv_nsec - now.tv_nsec;
+        if(remaining.tv_nsec < 0) {
+          remaining.tv_sec -= 1;
+          remaining.tv_nsec += 1000000000;
+        }
+        if(remaining.tv_sec < 0)
+          return NA_FALSE;
+        if(na_FutexWait(sequence, ticket, &remaining) != 0 && errno == ETIMEDOUT)
+          return (naAtomicLoadi32(sequence, NA_MEMORY_ORDER_ACQUIRE) != ticket);
+      }
+    }
+    return NA_TRUE;
+  #else
+    NA_UNUSED(ticket);
+    return naAwaitAlarm(alarmer, maxWaitTime);
+  #endif
+}
+
+
+
 NA_IDEF void naTriggerAlarm(NAAlarm alarmer) {
   #if NA_OS == NA_OS_WINDOWS
     SetEvent(alarmer);
+  #elif NA_OS == NA_OS_LINUX
+    naAtomicAddi32((NANativeAlarm)alarmer, 1, NA_MEMORY_ORDER_RELEASE);
+    na_FutexWake((NANativeAlarm)alarmer, 1);
   #else
     dispatch_semaphore_signal((NA_COCOA_BRIDGE dispatch_semaphore_t)alarmer);
   #endif
@@ -496,6 +1205,76 @@ NA_IDEF void naTriggerAlarm(NAAlarm alarmer) {
 
 
 
+// ////////////////////////////
+// THREAD LOCALS
+// ////////////////////////////
+
+// The index of the fiber local or the pthread key is stored directly in the
+// NAThreadLocal pointer.
+
+NA_IDEF NAThreadLocal naMakeThreadLocal(NAMutator destructor) {
+  #if NA_OS == NA_OS_WINDOWS
+    DWORD index;
+    #if NA_THREAD_LOCAL_DESTRUCTORS == 1
+      // The callback has the same calling convention as NAMutator.
+      index = FlsAlloc((PFLS_CALLBACK_FUNCTION)destructor);
+    #else
+      #if NA_DEBUG
+        if(destructor)
+          naError("Destructors are not supported on 32 bit Windows.");
+      #endif
+      index = FlsAlloc(NA_NULL);
+    #endif
+    #if NA_DEBUG
+      if(index == FLS_OUT_OF_INDEXES)
+        naError("No more thread locals available.");
+    #endif
+    return (NAThreadLocal)(size_t)index;
+  #else
+    pthread_key_t key;
+    int result = pthread_key_create(&key, destructor);
+    #if NA_DEBUG
+      if(result)
+        naError("No more thread locals available.");
+    #else
+      NA_UNUSED(result);
+    #endif
+    return (NAThreadLocal)(size_t)key;
+  #endif
+}
+
+
+
+NA_IDEF void naClearThreadLocal(NAThreadLocal threadLocal) {
+  #if NA_OS == NA_OS_WINDOWS
+    FlsFree((DWORD)(size_t)threadLocal);
+  #else
+    pthread_key_delete((pthread_key_t)(size_t)threadLocal);
+  #endif
+}
+
+
+
+NA_IDEF void naSetThreadLocal(NAThreadLocal threadLocal, void* value) {
+  #if NA_OS == NA_OS_WINDOWS
+    FlsSetValue((DWORD)(size_t)threadLocal, value);
+  #else
+    pthread_setspecific((pthread_key_t)(size_t)threadLocal, value);
+  #endif
+}
+
+
+
+NA_IDEF void* naGetThreadLocal(NAThreadLocal threadLocal) {
+  #if NA_OS == NA_OS_WINDOWS
+    return FlsGetValue((DWORD)(size_t)threadLocal);
+  #else
+    return pthread_getspecific((pthread_key_t)(size_t)threadLocal);
+  #endif
+}
+
+
+
 // This is free and unencumbered software released into the public domain.
 
 // Anyone is free to copy, modify, publish, use, compile, sell, or
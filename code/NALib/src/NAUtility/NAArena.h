@@ -0,0 +1,103 @@
+#ifndef NA_ARENA_INCLUDED
+#define NA_ARENA_INCLUDED
+#ifdef __cplusplus
+  extern "C"{
+#endif
+
+
+
+// An NAArena is a region allocator: Memory is handed out by simply bumping a
+// pointer forward in a large chunk of memory. Individual allocations can not
+// be freed. Instead, the whole arena is reset at once or rewound to a mark
+// previously taken.
+//
+// This is very useful for data which lives for a well defined time span, for
+// example all temporary strings and structures needed to parse a file or
+// to answer a request. Compared to naMallocTmp, no bookkeeping per
+// allocation is necessary and the memory is reused after a reset.
+//
+// The arena grows in chunks allocated with naMallocPageAligned. Chunks are
+// never freed before the arena itself gets deallocated. After a reset or a
+// rewind, they are simply reused.
+//
+// An arena is not thread safe.
+
+#include "../NABase/NABase.h"
+
+
+
+NA_PROTOTYPE(NAArena);
+
+// A mark denotes a position in the arena. Use naArenaMark to get one and
+// naArenaRewind to free everything which has been allocated since.
+typedef struct NAArenaMark NAArenaMark;
+struct NAArenaMark{
+  void* chunk;
+  void* cur;
+};
+
+// Allocates and deallocates an arena. The chunkByteSize denotes the default
+// byte size of the chunks and is rounded up to a multiple of the memory page
+// size. The value 0 denotes the memory page size. Allocations bigger than a
+// chunk get a chunk of their own.
+NA_API NAArena* naAllocArena(size_t chunkByteSize);
+NA_API void naDeallocArena(NAArena* arena);
+
+// Returns a pointer to byteSize bytes inside the arena. The pointer is
+// aligned to twice the size of an address which suffices for all basic types.
+// Use the aligned variant for stricter alignments. align must be a power of
+// two. Do not free the returned pointers.
+NA_IAPI void* naArenaAlloc(NAArena* arena, size_t byteSize);
+NA_IAPI void* naArenaAllocAligned(NAArena* arena, size_t byteSize, size_t align);
+
+// Returns the current position of the arena. Rewinding to that mark makes
+// all memory allocated after the mark available again. Marks can be nested
+// but a rewind invalidates all marks taken after the given one.
+NA_IAPI NAArenaMark naArenaMark(const NAArena* arena);
+NA_IAPI void naArenaRewind(NAArena* arena, NAArenaMark mark);
+
+// Makes all memory of the arena available again in constant time. All
+// pointers returned before are invalid afterwards.
+NA_IAPI void naResetArena(NAArena* arena);
+
+// Returns the total number of bytes of all chunks of the arena.
+NA_IAPI size_t naGetArenaByteSize(const NAArena* arena);
+
+
+
+// Inline implementations are in a separate file:
+#include "NAArena/NAArenaII.h"
+
+
+
+#ifdef __cplusplus
+  } // extern "C"
+#endif
+#endif // NA_ARENA_INCLUDED
+
+
+
+// This is free and unencumbered software released into the public domain.
+
+// Anyone is free to copy, modify, publish, use, compile, sell, or
+// distribute this software, either in source code form or as a compiled
+// binary, for any purpose, commercial or non-commercial, and by any
+// means.
+
+// In jurisdictions that recognize copyright laws, the author or authors
+// of this software dedicate any and all copyright interest in the
+// software to the public domain. We make this dedication for the benefit
+// of the public at large and to the detriment of our heirs and
+// successors. We intend this dedication to be an overt act of
+// relinquishment in perpetuity of all present and future rights to this
+// software under copyright law.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+
+// For more information, please refer to <http://unlicense.org/>
@@ -0,0 +1,113 @@
+
+#include "../NAArena.h"
+#include "../NAMemory.h"
+
+
+
+// Allocates a new chunk able to store at least byteSize bytes with the given
+// alignment and links it right after the current chunk. Chunks which come
+// after the current one (which happens after a rewind or reset) stay linked
+// behind the new chunk and are reused later on.
+NA_HDEF NA_ArenaChunk* na_AddArenaChunk(NAArena* arena, size_t byteSize, size_t align) {
+  size_t pageSize = naGetSystemMemoryPagesize();
+  size_t chunkByteSize = arena->chunkByteSize;
+  size_t requiredByteSize = sizeof(NA_ArenaChunk) + align + byteSize;
+  if(requiredByteSize > chunkByteSize) {
+    chunkByteSize = (requiredByteSize + pageSize - 1) & ~(pageSize - 1);
+  }
+
+  NA_ArenaChunk* chunk = naMallocPageAligned(chunkByteSize);
+  chunk->end = (NAByte*)chunk + chunkByteSize;
+  arena->byteSize += chunkByteSize;
+
+  if(arena->curChunk) {
+    chunk->next = arena->curChunk->next;
+    arena->curChunk->next = chunk;
+  }else{
+    chunk->next = NA_NULL;
+    arena->firstChunk = chunk;
+  }
+  return chunk;
+}
+
+
+
+NA_DEF NAArena* naAllocArena(size_t chunkByteSize) {
+  NAArena* arena = naAlloc(NAArena);
+
+  size_t pageSize = naGetSystemMemoryPagesize();
+  if(chunkByteSize == 0) {
+    chunkByteSize = pageSize;
+  }
+  arena->chunkByteSize = (chunkByteSize + pageSize - 1) & ~(pageSize - 1);
+  arena->byteSize = 0;
+  arena->curChunk = NA_NULL;
+
+  na_AddArenaChunk(arena, 0, 1);
+  naResetArena(arena);
+  return arena;
+}
+
+
+
+NA_DEF void naDeallocArena(NAArena* arena) {
+  #if NA_DEBUG
+    if(!arena)
+      naCrash("arena is nullptr");
+  #endif
+  NA_ArenaChunk* chunk = arena->firstChunk;
+  while(chunk) {
+    NA_ArenaChunk* next = chunk->next;
+    naFreeAligned(chunk);
+    chunk = next;
+  }
+  naFree(arena);
+}
+
+
+
+// Gets called by naArenaAllocAligned when the current chunk has not enough
+// space left. Moves on to the next chunk if it is big enough, otherwise
+// inserts a new chunk.
+NA_HDEF void* na_AllocArenaChunkSpace(NAArena* arena, size_t byteSize, size_t align) {
+  NA_ArenaChunk* chunk = arena->curChunk->next;
+  NAByte* ptr = NA_NULL;
+  if(chunk) {
+    ptr = (NAByte*)(((size_t)na_GetArenaChunkFirstByte(chunk) + (align - 1)) & ~(align - 1));
+  }
+  if(!chunk || ptr > chunk->end || (size_t)(chunk->end - ptr) < byteSize) {
+    chunk = na_AddArenaChunk(arena, byteSize, align);
+    ptr = (NAByte*)(((size_t)na_GetArenaChunkFirstByte(chunk) + (align - 1)) & ~(align - 1));
+  }
+
+  arena->curChunk = chunk;
+  arena->cur = ptr + byteSize;
+  return ptr;
+}
+
+
+
+// This is free and unencumbered software released into the public domain.
+
+// Anyone is free to copy, modify, publish, use, compile, sell, or
+// distribute this software, either in source code form or as a compiled
+// binary, for any purpose, commercial or non-commercial, and by any
+// means.
+
+// In jurisdictions that recognize copyright laws, the author or authors
+// of this software dedicate any and all copyright interest in the
+// software to the public domain. We make this dedication for the benefit
+// of the public at large and to the detriment of our heirs and
+// successors. We intend this dedication to be an overt act of
+// relinquishment in perpetuity of all present and future rights to this
+// software under copyright law.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+
+// For more information, please refer to <http://unlicense.org/>
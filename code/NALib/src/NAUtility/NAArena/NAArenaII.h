@@ -0,0 +1,131 @@
+
+// This file contains inline implementations of the file NAArena.h
+// Do not include this file directly! It will automatically be included when
+// including "NAArena.h"
+
+
+
+NA_PROTOTYPE(NA_ArenaChunk);
+
+// A chunk is one block of page aligned memory. This header struct is stored
+// in the first bytes of the block, the memory handed out follows afterwards.
+struct NA_ArenaChunk{
+  NA_ArenaChunk* next;
+  NAByte* end;                   // The first byte after the chunk.
+};
+
+struct NAArena{
+  NA_ArenaChunk* firstChunk;
+  NA_ArenaChunk* curChunk;
+  NAByte* cur;                   // The next free byte in the current chunk.
+  size_t chunkByteSize;
+  size_t byteSize;               // Total bytes of all chunks.
+};
+
+#define NA_ARENA_DEFAULT_ALIGN (2 * NA_ADDRESS_BYTES)
+
+NA_HAPI void* na_AllocArenaChunkSpace(NAArena* arena, size_t byteSize, size_t align);
+
+
+
+NA_HIDEF NAByte* na_GetArenaChunkFirstByte(NA_ArenaChunk* chunk) {
+  return (NAByte*)chunk + sizeof(NA_ArenaChunk);
+}
+
+
+
+NA_IDEF void* naArenaAllocAligned(NAArena* arena, size_t byteSize, size_t align) {
+  #if NA_DEBUG
+    if(!arena)
+      naCrash("arena is nullptr");
+    if(!align || (align & (align - 1)))
+      naError("align must be a power of two");
+  #endif
+
+  // Note that aligning might move ptr beyond the end of the chunk.
+  NAByte* ptr = (NAByte*)(((size_t)arena->cur + (align - 1)) & ~(align - 1));
+  if(ptr > arena->curChunk->end || (size_t)(arena->curChunk->end - ptr) < byteSize) {
+    return na_AllocArenaChunkSpace(arena, byteSize, align);
+  }
+  arena->cur = ptr + byteSize;
+  return ptr;
+}
+
+
+
+NA_IDEF void* naArenaAlloc(NAArena* arena, size_t byteSize) {
+  return naArenaAllocAligned(arena, byteSize, NA_ARENA_DEFAULT_ALIGN);
+}
+
+
+
+NA_IDEF NAArenaMark naArenaMark(const NAArena* arena) {
+  #if NA_DEBUG
+    if(!arena)
+      naCrash("arena is nullptr");
+  #endif
+  NAArenaMark mark = {arena->curChunk, arena->cur};
+  return mark;
+}
+
+
+
+NA_IDEF void naArenaRewind(NAArena* arena, NAArenaMark mark) {
+  #if NA_DEBUG
+    if(!arena)
+      naCrash("arena is nullptr");
+    NA_ArenaChunk* chunk = (NA_ArenaChunk*)mark.chunk;
+    if((NAByte*)mark.cur < na_GetArenaChunkFirstByte(chunk) || (NAByte*)mark.cur > chunk->end)
+      naError("mark seems not to belong to this arena");
+  #endif
+  arena->curChunk = (NA_ArenaChunk*)mark.chunk;
+  arena->cur = (NAByte*)mark.cur;
+}
+
+
+
+NA_IDEF void naResetArena(NAArena* arena) {
+  #if NA_DEBUG
+    if(!arena)
+      naCrash("arena is nullptr");
+  #endif
+  arena->curChunk = arena->firstChunk;
+  arena->cur = na_GetArenaChunkFirstByte(arena->firstChunk);
+}
+
+
+
+NA_IDEF size_t naGetArenaByteSize(const NAArena* arena) {
+  #if NA_DEBUG
+    if(!arena)
+      naCrash("arena is nullptr");
+  #endif
+  return arena->byteSize;
+}
+
+
+
+// This is free and unencumbered software released into the public domain.
+
+// Anyone is free to copy, modify, publish, use, compile, sell, or
+// distribute this software, either in source code form or as a compiled
+// binary, for any purpose, commercial or non-commercial, and by any
+// means.
+
+// In jurisdictions that recognize copyright laws, the author or authors
+// of this software dedicate any and all copyright interest in the
+// software to the public domain. We make this dedication for the benefit
+// of the public at large and to the detriment of our heirs and
+// successors. We intend this dedication to be an overt act of
+// relinquishment in perpetuity of all present and future rights to this
+// software under copyright law.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+
+// For more information, please refer to <http://unlicense.org/>
@@ -10,6 +10,7 @@
   #include <time.h>
 //  NA_IDEF void Localtime(struct tm* storage, const time_t* tme) { localtime_s(storage, tme); }
 #elif NA_IS_POSIX
+  #include <time.h>
   #include <sys/time.h>
 //  NA_IDEF void Localtime(struct tm* storage, const time_t* tme) { localtime_r(tme, storage); }
 #else
@@ -129,6 +129,8 @@ NA_IDEF int naRemove(const char* url) {
 }
 
 
+#define NA_FILE_COPY_BUFFER_SIZE 16384
+
 NA_IDEF NABool naCopyFile(const char* dstUrl, const char* srcUrl) {
   #if NA_OS == NA_OS_WINDOWS
     return (CopyFile( (LPCTSTR)(const char*)srcUrl,
@@ -136,23 +138,57 @@ NA_IDEF NABool naCopyFile(const char* dstUrl, const char* srcUrl) {
                       NA_FALSE) != 0);
   #elif NA_OS == NA_OS_MAC_OS_X
     return (copyfile(srcUrl, dstUrl, NULL, COPYFILE_ALL) == 0);
-  #elif NA_OS == NA_OS_FREEBSD
-    int srcFd = open(srcUrl, O_RDONLY);
+  #elif NA_OS == NA_OS_FREEBSD || NA_OS == NA_OS_LINUX
+    NABool success = NA_TRUE;
+    int srcFd = naOpen(srcUrl, NA_FILE_OPEN_FLAGS_READ, 0);
     if(srcFd < 0)
-	    return NA_FALSE;
+      return NA_FALSE;
 
-    int dstFd = open(dstUrl, O_WRONLY|O_CREAT|O_TRUNC);
+    int dstFd = naOpen(dstUrl, NA_FILE_OPEN_FLAGS_WRITE, NA_FILEMODE_DEFAULT);
     if(dstFd < 0) {
-	    close(srcFd);
-	    return NA_FALSE;
+      naClose(srcFd);
+      return NA_FALSE;
     }
 
-    int rc = copy_file_range(srcFd, NULL, dstFd, NULL, NA_FILESIZE_MAX, 0);
+    #if NA_OS == NA_OS_FREEBSD
+      // A single call may copy less than requested. 0 denotes the end.
+      while(NA_TRUE) {
+        ssize_t rc = copy_file_range(srcFd, NULL, dstFd, NULL, NA_FILESIZE_MAX, 0);
+        if(rc == 0)
+          break;
+        if(rc < 0) {
+          success = NA_FALSE;
+          break;
+        }
+      }
+    #else
+      // glibc only declares copy_file_range with _GNU_SOURCE which can not
+      // be defined this late. Therefore, Linux copies through a buffer.
+      NAByte buffer[NA_FILE_COPY_BUFFER_SIZE];
+      while(success) {
+        fsize_t readCount = naRead(srcFd, buffer, NA_FILE_COPY_BUFFER_SIZE);
+        if(readCount == 0)
+          break;
+        if(readCount < 0) {
+          success = NA_FALSE;
+          break;
+        }
+        fsize_t writtenCount = 0;
+        while(writtenCount < readCount) {
+          fsize_t rc = naWrite(dstFd, &buffer[writtenCount], readCount - writtenCount);
+          if(rc <= 0) {
+            success = NA_FALSE;
+            break;
+          }
+          writtenCount += rc;
+        }
+      }
+    #endif
 
-    close(dstFd);
-    close(srcFd);
+    naClose(dstFd);
+    naClose(srcFd);
 
-    return !rc;
+    return success;
   #endif
 }
 
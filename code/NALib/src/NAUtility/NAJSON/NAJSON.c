@@ -1,6 +1,7 @@
 
 #include "../NAJSON.h"
 #include "../../NAStruct/NABuffer.h"
+#include "../../NAStruct/NAVector.h"
 #include <ctype.h>
 
 #define NA_JSON_PARSE_STACK_DEPTH 32
@@ -102,8 +103,7 @@ struct NA_JSONPointerObjectRule{
 };
 
 struct NAJSONRuleSet{
-  NAStack ruleStack;
-  NAJSONRule** rules;
+  NAVector rules;
   #if NA_DEBUG
     NABool prepared;
   #endif
@@ -193,8 +193,7 @@ NA_DEF NAJSONRuleSet* naRegisterJSONRuleSet(NAJSONWorker* worker) {
   #endif
 
   NAJSONRuleSet* ruleSet = naAlloc(NAJSONRuleSet);
-  naInitStack(&ruleSet->ruleStack, sizeof(NAJSONRule*), 0, 0);
-  ruleSet->rules = NA_NULL;
+  naInitVector(&ruleSet->rules, sizeof(NAJSONRule*), 0);
   #if NA_DEBUG
     ruleSet->prepared = NA_FALSE;
   #endif
@@ -207,11 +206,8 @@ NA_DEF NAJSONRuleSet* naRegisterJSONRuleSet(NAJSONWorker* worker) {
 }
 
 NA_HDEF void na_DeallocJSONRuleSet(NAJSONRuleSet* ruleSet) {
-  if(ruleSet->rules) {
-    naFree(ruleSet->rules);
-  }
-  naForeachStackpMutable(&ruleSet->ruleStack, (NAMutator)na_DeallocJSONRule);
-  naClearStack(&ruleSet->ruleStack);
+  naForeachVectorpMutable(&ruleSet->rules, (NAMutator)na_DeallocJSONRule);
+  naClearVector(&ruleSet->rules);
   naFree(ruleSet);
 }
 
@@ -236,7 +232,7 @@ NA_DEF void naAddJSONRule(
       naError("The ruleSet is part of a worker which has already been used. Adding more rules results in undefined behaviour.");
   #endif
 
-  NAJSONRule** rulePtr = naPushStack(&ruleSet->ruleStack);
+  NAJSONRule** rulePtr = naPushVector(&ruleSet->rules);
   *rulePtr = rule;
   na_FillJSONString(&rule->key, key);
   #if NA_DEBUG
@@ -558,8 +554,9 @@ NA_DEF NAJSONRule* naNewJSONRulePointerObject(
 
 NA_HDEF const NAJSONRule* na_findJSONRule(const NAJSONRuleSet* ruleSet, NA_JSONDataType type, const NA_JSONString* key) {
   if(ruleSet) {
-    for(size_t i = 0; i < naGetStackCount(&ruleSet->ruleStack); ++i) {
-      const NAJSONRule* rule = ruleSet->rules[i];
+    const NAJSONRule* const* rules = naGetVectorPointerConst(&ruleSet->rules);
+    for(size_t i = 0; i < naGetVectorCount(&ruleSet->rules); ++i) {
+      const NAJSONRule* rule = rules[i];
       if(rule->type == type && na_EqualJSONString(&rule->key, key))
       {
         return rule;
@@ -653,19 +650,12 @@ NA_HAPI void na_WriteJSONObject(NAJSONWorker* worker, void* object, NABufferIter
 
 NA_HAPI void na_PrepareJSONWorker(NAJSONWorker* worker) {
   if(!worker->prepared) {
-    // Prepare all rules for faster access.
+    // The rules are already stored contiguously. Just give back the memory
+    // reserved for further rules.
     NAStackIterator ruleSetIt = naMakeStackMutator(&worker->ruleSetStack);
     while(naIterateStack(&ruleSetIt)) {
       NAJSONRuleSet* ruleSet = naGetStackCurpMutable(&ruleSetIt);
-      if(ruleSet->rules) {
-        naFree(ruleSet->rules);
-        ruleSet->rules = NA_NULL;
-      }
-      size_t ruleCount = naGetStackCount(&ruleSet->ruleStack);
-      if(ruleCount) {
-        ruleSet->rules = naMalloc(ruleCount * sizeof(NAJSONRule*));
-        naDumpStack(&ruleSet->ruleStack, ruleSet->rules);
-      }
+      naShrinkVectorToFit(&ruleSet->rules);
       #if NA_DEBUG
         ruleSet->prepared = NA_TRUE;
       #endif
@@ -1696,14 +1686,15 @@ NA_HDEF void na_WriteJSONRuleSetObject(NAJSONWorker* worker, void* object, NABuf
   NAUTF8Char* lineSeparator = multiLine ? NA_NL : " ";
   if(!multiLine) {indent = "";}
 
-  size_t count = naGetStackCount(&ruleSet->ruleStack);
+  const NAJSONRule* const* rules = naGetVectorPointerConst(&ruleSet->rules);
+  size_t count = naGetVectorCount(&ruleSet->rules);
   for(size_t i = 0; i < count; ++i) {
 
     na_WriteJSONRuleSetElement(
       worker,
-      (NAByte*)object + ruleSet->rules[i]->byteOffset,
+      (NAByte*)object + rules[i]->byteOffset,
       bufIt,
-      ruleSet->rules[i],
+      rules[i],
       indent,
       multiLine);
       
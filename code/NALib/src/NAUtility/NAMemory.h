@@ -83,18 +83,39 @@ NA_IAPI size_t naGetSystemMemoryPagesizeMask(void);
 //                      You always free aligned what you alloced aligned. See
 //                      implementation for more details.
 //
+// naMallocMapped       Maps byteSize bytes of zero-filled memory directly
+//                      from the operating system, aligned to the given bound
+//                      which must be a power of two. When byteSize is at
+//                      least NA_HUGE_PAGE_BYTESIZE, the system is advised to
+//                      back the memory with huge pages, see NAConfiguration.h.
+//                      This is meant for big blocks only as the byteSize is
+//                      rounded up to the memory page size.
+// naFreeMapped         Unmaps a pointer allocated with naMallocMapped. The
+//                      same byteSize must be given.
+//
 // naMallocTmp          Allocates the given number of bytes with malloc and
 //                      returns it as a mutable void pointer but is owned by
 //                      the runtime system and will be freed automatically
-//                      during a call to naCollectGarbage. Do not expect the
-//                      content of such pointers to be valid for a long time
-//                      and never call naFree or free on them manually!
+//                      during a call to naCollectGarbage or
+//                      naCollectThreadGarbage in the same thread. Do not
+//                      expect the content of such pointers to be valid for
+//                      a long time and never call naFree or free on them
+//                      manually!
 //                      Beware: Only positive byte counts are allowed.
 // naNew                This is a macro replicating something like the new
 //                      operator known from C++. But it is dependent on a
 //                      custom runtime system described further below.
 // naDelete             Deletes a pointer created with naNew by properly
 //                      calling the correct destructor.
+// naNewBatch           Allocates count spaces of the given type at once and
+//                      stores the pointers in outArray which must provide
+//                      room for count pointers. Whole pool parts are carved
+//                      up at once which is much faster than calling naNew
+//                      count times.
+// naDeleteBatch        Deletes count pointers created with naNew or
+//                      naNewBatch. The pointers may be of different types.
+//                      All destructors are called first, then the spaces
+//                      are given back to the runtime in one go.
 //
 // Authors note:
 // Having only a handful allocation function helps detecting basic memory
@@ -111,10 +132,15 @@ NA_IAPI void        naFree             (void* ptr);
 NA_IAPI void*       naMallocAligned    (size_t byteSize, size_t align);
 NA_IAPI void*       naMallocPageAligned(size_t byteSize);
 NA_IAPI void        naFreeAligned      (void* ptr);
+
+NA_API  void*       naMallocMapped     (size_t byteSize, size_t align);
+NA_API  void        naFreeMapped       (void* ptr, size_t byteSize);
       
 NA_API  void*       naMallocTmp        (size_t byteSize);
 #define             naNew              (type)
 NA_API  void        naDelete           (void* pointer);
+#define             naNewBatch         (type, count, outArray)
+NA_API  void        naDeleteBatch      (void** pointers, size_t count);
       
 NA_API  void*       naRetain           (void* pointer);
 NA_API  void        naRelease          (void* pointer);
@@ -384,17 +410,118 @@ NA_IAPI       void* naGetPointerMutable(      NAPointer* pointer);
 //
 // Additionally, you can call naCollectGarbage to collect all temporary memory
 // which had been allocated with naMallocTmp.
+//
+// Temporary memory is collected per thread: Every thread has its own list of
+// pointers allocated with naMallocTmp and naCollectGarbage only frees the
+// ones of the calling thread. Additionally, it releases empty pool parts
+// exceeding the retention limits described below.
+//
+// naCollectThreadGarbage just frees the temporary memory of the calling
+// thread. It is cheap and can be called by any thread, for example after
+// every message processed in a worker thread. When a thread ends, all its
+// temporary memory is freed by naFlushRuntimeThreadCache.
+//
+// When the temporary memory of a thread exceeds its auto collect limit, it is
+// collected automatically during the next call to naMallocTmp in that thread.
+// The limit initially is NA_GARBAGE_TMP_AUTOCOLLECT_LIMIT, see
+// NAConfiguration.h. 0 means no automatic collection.
+//
+// naGetRuntimeGarbageByteSize returns the number of temporary bytes of the
+// calling thread.
+//
+// naStartRuntime uses NA_POOLPART_BYTESIZE as the byte size of the pool
+// parts. With naStartRuntimeWithPartSize, you can choose the size when
+// starting the runtime instead. It must be a power of two and 0 denotes the
+// memory page size. Parts of at least NA_HUGE_PAGE_BYTESIZE are mapped with
+// naMallocMapped and hence can be backed by huge pages which reduces TLB
+// misses when working with millions of small objects.
 
 NA_API  void   naStartRuntime(void);
+NA_API  void   naStartRuntimeWithPartSize(size_t partByteSize);
 NA_API  void   naStopRuntime(void);
 NA_IAPI NABool naIsRuntimeRunning(void);
 
 NA_API  void   naCollectGarbage(void);
-NA_IAPI size_t naGetRuntimeGarbageByteSize(void);
+NA_API  void   naCollectThreadGarbage(void);
+NA_API  void   naSetThreadGarbageAutoCollectLimit(size_t byteSize);
+NA_API  size_t naGetRuntimeGarbageByteSize(void);
 
 NA_IAPI size_t naGetRuntimeMemoryPageSize(void);
 NA_IAPI size_t naGetRuntimePoolPartSize(void);
 
+// Empty pool parts are retained by the runtime to be recycled instead of
+// being freed and allocated over and over again. With the following function,
+// you can define how many empty parts shall be retained per type and how many
+// bytes of empty parts shall be retained in total. Empty parts exceeding these
+// limits are released during the next call to naCollectGarbage. The default
+// values are defined in NAConfiguration.h
+//
+// The counters return how many parts have been allocated, how many empty
+// parts have been recycled instead of allocating a new one and how many
+// parts have been released since the start of the runtime.
+NA_API  void   naSetRuntimePartRetention(size_t partCount, size_t byteSize);
+NA_IAPI size_t naGetRuntimeRetainedPartCount(void);
+NA_IAPI size_t naGetRuntimePartAllocationCount(void);
+NA_IAPI size_t naGetRuntimePartRecycleCount(void);
+NA_IAPI size_t naGetRuntimePartReleaseCount(void);
+
+// Statistics of one runtime type. The values are a snapshot at the time of
+// calling naGetRuntimeTypeStats. When thread caches are in use, other threads
+// may allocate and delete while the snapshot is taken, making liveCount,
+// allocationCount and usedByteSize approximate:
+// typeId            A dense index given to every type when it is used for
+//                   the first time since the runtime has started. The ids
+//                   start at 0 and stay the same until the runtime stops.
+// typeName          The name given to NA_RUNTIME_TYPE.
+// typeSize          The bytes used per space, including the reference count
+//                   and the padding for alignment.
+// liveCount         The number of objects currently alive.
+// maxLiveCount      The highest number of spaces ever in use since the type
+//                   has been registered. When thread caches are in use, this
+//                   includes the spaces cached by threads.
+// allocationCount   The cumulative number of naNew or naCreate calls.
+// partCount         The number of pool parts currently allocated.
+// emptyPartCount    The number of empty pool parts retained for recycling.
+// reservedByteSize  The number of bytes of all pool parts of this type.
+// usedByteSize      The number of bytes used by objects currently alive.
+typedef struct NARuntimeTypeStats NARuntimeTypeStats;
+struct NARuntimeTypeStats{
+  size_t typeId;
+  const char* typeName;
+  size_t typeSize;
+  size_t liveCount;
+  size_t maxLiveCount;
+  size_t allocationCount;
+  size_t partCount;
+  size_t emptyPartCount;
+  size_t reservedByteSize;
+  size_t usedByteSize;
+};
+
+// Fills the given array with the statistics of the registered runtime types,
+// at most maxCount of them. Returns the total number of registered types.
+// The array is ordered by the type id, meaning stats[typeId] belongs to the
+// type with that id.
+// A type is registered as soon as it has been allocated with naNew the first
+// time. Call this function with NA_NULL and 0 to just get the count.
+//
+// Have a look at naWriteBufferRuntimeTypeStats in NABuffer.h to write the
+// statistics as CSV or JSON.
+NA_API  size_t naGetRuntimeTypeStats(NARuntimeTypeStats* stats, size_t maxCount);
+
+// A thread should call this function before it ends. It frees all temporary
+// memory of the thread allocated with naMallocTmp. Additionally, when
+// NA_RUNTIME_USE_THREAD_CACHES is set to 1, every thread caches free spaces
+// of runtime types which are given back to the shared pool. Calling this
+// function multiple times is fine. See NAConfiguration.h
+//
+// When a thread having temporary memory or a thread cache ends, this is done
+// automatically and the cache itself is freed, except for the main thread
+// and on systems where NA_THREAD_LOCAL_DESTRUCTORS is 0, like 32 bit
+// Windows. There, call this function explicitly before a thread ends. The
+// empty cache then stays allocated until the runtime stops.
+NA_API  void   naFlushRuntimeThreadCache(void);
+
 // In order to work with specific types, each type trying to use the runtime
 // system needs to register itself to the runtime system upon compile time.
 // This is achieved by defining a very specific variable of type NATypeInfo.
@@ -403,6 +530,16 @@ NA_IAPI size_t naGetRuntimePoolPartSize(void);
 
 #define NA_RUNTIME_TYPE(typeName, destructor, refCounting)
 
+// By default, the objects of a type are stored one after the other, only
+// aligned to the size of an address. If your type needs a stricter alignment,
+// for example because it contains SIMD vectors or because it shall fill a
+// whole cache line (see NA_CACHE_LINE_BYTESIZE in NAConfiguration.h), use
+// the following macro. The align must be a power of two. Every pointer
+// returned by naNew or naCreate will then be a multiple of align. Note that
+// each object is padded to a multiple of align.
+
+#define NA_RUNTIME_TYPE_ALIGNED(typeName, destructor, refCounting, align)
+
 // But note that this macro results in a variable definition and hence must be
 // written in an implementation file (.c). Also, the type must not be opaque
 // and the destructor must be declared before this macro.
@@ -0,0 +1,114 @@
+
+#include "../NAMemory.h"
+
+#if NA_OS == NA_OS_WINDOWS
+  #include <Windows.h>
+#else
+  #include <sys/mman.h>
+#endif
+
+
+
+NA_DEF void* naMallocMapped(size_t byteSize, size_t align) {
+  #if NA_DEBUG
+    if(byteSize == NA_ZERO_s)
+      naCrash("size is zero.");
+    if(!align || (align & (align - 1)))
+      naError("align must be a power of two");
+  #endif
+
+  size_t pageSize = naGetSystemMemoryPagesize();
+  byteSize = (byteSize + pageSize - 1) & ~(pageSize - 1);
+  if(align < pageSize) {
+    align = pageSize;
+  }
+
+  void* ptr;
+
+  #if NA_OS == NA_OS_WINDOWS
+    // VirtualAlloc can not align to arbitrary bounds. Therefore, we reserve
+    // enough address space to find an aligned address within, release it and
+    // immediately allocate at the aligned address. Another thread might take
+    // the address in the meantime, hence the loop.
+    ptr = NA_NULL;
+    while(!ptr) {
+      void* reserved = VirtualAlloc(NA_NULL, byteSize + align, MEM_RESERVE, PAGE_NOACCESS);
+      if(!reserved)
+        break;
+      size_t alignedAddress = ((size_t)reserved + (align - 1)) & ~(align - 1);
+      VirtualFree(reserved, 0, MEM_RELEASE);
+      ptr = VirtualAlloc((void*)alignedAddress, byteSize, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+    }
+  #else
+    // We map more than necessary and unmap the unaligned front and the
+    // remaining back.
+    size_t mapByteSize = byteSize + align - pageSize;
+    NAByte* mapped = mmap(NA_NULL, mapByteSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0);
+    if(mapped == MAP_FAILED) {
+      ptr = NA_NULL;
+    }else{
+      NAByte* aligned = (NAByte*)(((size_t)mapped + (align - 1)) & ~(align - 1));
+      size_t frontByteSize = (size_t)(aligned - mapped);
+      size_t backByteSize = mapByteSize - frontByteSize - byteSize;
+      if(frontByteSize) {
+        munmap(mapped, frontByteSize);
+      }
+      if(backByteSize) {
+        munmap(aligned + byteSize, backByteSize);
+      }
+      ptr = aligned;
+
+      #if NA_USE_HUGE_PAGES == 1 && defined MADV_HUGEPAGE
+        if(byteSize >= NA_HUGE_PAGE_BYTESIZE) {
+          madvise(ptr, byteSize, MADV_HUGEPAGE);
+        }
+      #endif
+    }
+  #endif
+
+  #if NA_DEBUG
+    if(!ptr)
+      naCrash("Out of memory");
+  #endif
+
+  return ptr;
+}
+
+
+
+NA_DEF void naFreeMapped(void* ptr, size_t byteSize) {
+  #if NA_OS == NA_OS_WINDOWS
+    NA_UNUSED(byteSize);
+    VirtualFree(ptr, 0, MEM_RELEASE);
+  #else
+    size_t pageSize = naGetSystemMemoryPagesize();
+    munmap(ptr, (byteSize + pageSize - 1) & ~(pageSize - 1));
+  #endif
+}
+
+
+
+// This is free and unencumbered software released into the public domain.
+
+// Anyone is free to copy, modify, publish, use, compile, sell, or
+// distribute this software, either in source code form or as a compiled
+// binary, for any purpose, commercial or non-commercial, and by any
+// means.
+
+// In jurisdictions that recognize copyright laws, the author or authors
+// of this software dedicate any and all copyright interest in the
+// software to the public domain. We make this dedication for the benefit
+// of the public at large and to the detriment of our heirs and
+// successors. We intend this dedication to be an overt act of
+// relinquishment in perpetuity of all present and future rights to this
+// software under copyright law.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+
+// For more information, please refer to <http://unlicense.org/>
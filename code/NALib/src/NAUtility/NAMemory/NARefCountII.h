@@ -32,10 +32,56 @@ struct NARefCount{
 
 #define NA_REFCOUNT_DUMMY_VALUE (uint32)0xaaaaaaaa
 
+NA_HIDEF size_t na_GetRefCountCount(const NARefCount* refCount) {
+  #if NA_ATOMIC_REFCOUNT == 1
+    #if NA_ADDRESS_BITS == 64
+      return (size_t)naAtomicLoadi64((const int64*)&refCount->count, NA_MEMORY_ORDER_RELAXED);
+    #else
+      return (size_t)naAtomicLoadi32((const int32*)&refCount->count, NA_MEMORY_ORDER_RELAXED);
+    #endif
+  #else
+    return refCount->count;
+  #endif
+}
 
 
-NA_HIDEF size_t na_GetRefCountCount(const NARefCount* refCount) {
-  return refCount->count;
+
+// Increments the count. When NA_ATOMIC_REFCOUNT is 1, this is a relaxed
+// atomic increment: The thread retaining already holds a reference, so no
+// ordering with other memory accesses is needed.
+NA_HIDEF void na_IncRefCountCount(NARefCount* refCount) {
+  #if NA_ATOMIC_REFCOUNT == 1
+    #if NA_ADDRESS_BITS == 64
+      naAtomicAddi64((int64*)&refCount->count, 1, NA_MEMORY_ORDER_RELAXED);
+    #else
+      naAtomicAddi32((int32*)&refCount->count, 1, NA_MEMORY_ORDER_RELAXED);
+    #endif
+  #else
+    refCount->count++;
+  #endif
+}
+
+
+
+// Decrements the count and returns true if it has reached zero. When
+// NA_ATOMIC_REFCOUNT is 1, the decrement has release semantics such that all
+// accesses to the object by this thread happen before the object gets
+// destructed by another thread. The thread reaching zero issues an acquire
+// fence before returning.
+NA_HIDEF NABool na_DecRefCountCount(NARefCount* refCount) {
+  #if NA_ATOMIC_REFCOUNT == 1
+    #if NA_ADDRESS_BITS == 64
+      NABool reachedZero = naAtomicAddi64((int64*)&refCount->count, -1, NA_MEMORY_ORDER_RELEASE) == 1;
+    #else
+      NABool reachedZero = naAtomicAddi32((int32*)&refCount->count, -1, NA_MEMORY_ORDER_RELEASE) == 1;
+    #endif
+    if(reachedZero)
+      naAtomicFence(NA_MEMORY_ORDER_ACQUIRE);
+    return reachedZero;
+  #else
+    refCount->count--;
+    return refCount->count == NA_ZERO_s;
+  #endif
 }
 
 
@@ -51,7 +97,7 @@ NA_IDEF NARefCount* naInitRefCount(NARefCount* refCount) {
 
 
 NA_IDEF NABool naIsRefCountZero(NARefCount* refCount) {
-  return refCount->count == 0;
+  return na_GetRefCountCount(refCount) == 0;
 }
 
 
@@ -66,19 +112,22 @@ NA_IDEF NARefCount* naRetainRefCount(NARefCount* refCount) {
       // The next test can detect some erroneous behaviour in the code. Note
       // however that most likely the true cause of the error did occur long
       // before reaching here.
-      if(refCount->count == NA_ZERO_s)
+      if(na_GetRefCountCount(refCount) == NA_ZERO_s)
         naError("Retaining NARefCount with a count of 0");
-      if(refCount->count == NA_MAX_s)
+      if(na_GetRefCountCount(refCount) == NA_MAX_s)
         naError("Reference count overflow");
     }
   #endif
-  refCount->count++;
+  na_IncRefCountCount(refCount);
   return refCount;
 }
 
 
 
-NA_IDEF void naReleaseRefCount(NARefCount* refCount, void* data, NAMutator destructor) {
+// Releases the refCount and returns true if it reached zero. Use this return
+// value instead of reading the count afterwards: When the count is atomic,
+// another thread might have released the object in the meantime.
+NA_HIDEF NABool na_ReleaseRefCount(NARefCount* refCount, void* data, NAMutator destructor) {
   #if NA_DEBUG
     if(!refCount)
       naCrash("refCount is nullptr");
@@ -87,7 +136,7 @@ NA_IDEF void naReleaseRefCount(NARefCount* refCount, void* data, NAMutator destr
     // The next test can detect some erroneous behaviour in the code. Note
     // however that most likely the true cause of the error did occur long
     // before reaching here.
-    if(refCount->count == NA_ZERO_s)
+    if(na_GetRefCountCount(refCount) == NA_ZERO_s)
       naError("Releasing NARefCount with a count of 0");
   #endif
   // Note that the author decided to always count to zero, even if it is clear
@@ -95,9 +144,9 @@ NA_IDEF void naReleaseRefCount(NARefCount* refCount, void* data, NAMutator destr
   // nirvana. But often times in debugging, when retaining and releasing is not
   // done correctly, an NARefCount is released too often. When refCount is 0
   // and NA_DEBUG is 1, this can be detected!
-  refCount->count--;
+  NABool isZero = na_DecRefCountCount(refCount);
 
-  if(refCount->count == NA_ZERO_s) {
+  if(isZero) {
     // Call the destructor on the data if available.
     if(destructor)
       destructor(data);
@@ -108,6 +157,13 @@ NA_IDEF void naReleaseRefCount(NARefCount* refCount, void* data, NAMutator destr
   // care of detecting and collecting unused objects. In C and C++, no such
   // mechanisms exist and must be implemented manually. NARuntime is a small
   // example of such a system.
+  return isZero;
+}
+
+
+
+NA_IDEF void naReleaseRefCount(NARefCount* refCount, void* data, NAMutator destructor) {
+  na_ReleaseRefCount(refCount, data, destructor);
 }
 
 
@@ -1,6 +1,8 @@
 
 #include "../NAMemory.h"
 #include "../NABinaryData.h"
+#include "../../NAMath/NAMathOperators.h"
+#include "../NAThreading.h"
 
 #if NA_DEBUG
   #include "stdio.h"
@@ -19,10 +21,11 @@
 //
 // Most importantly, NA_TypeInfo stores a pointer "curPart". This
 // pointer points to an allocated memory block with a byteSize defined in
-// NAConfiguration.h with NA_POOLPART_BYTESIZE. That size and a corresponding
-// address mask is stored in the global NARuntime struct na_Runtime.
+// NAConfiguration.h with NA_POOLPART_BYTESIZE or given when starting the
+// runtime. That size and a corresponding address mask is stored in the global
+// NARuntime struct na_Runtime.
 //
-// Each of these memory blocks is allocated aligned to NA_POOLPART_BYTESIZE and
+// Each of these memory blocks is allocated aligned to its byteSize and
 // hence AND'ing an arbitrary address within that block with the address mask
 // returns the address of the first byte of the memory block.
 //
@@ -75,9 +78,13 @@
 // in the list right after the current part hence making the part available for
 // new allocations as soon as the current part is filled.
 //
-// Upon deleting spaces, a part may become completely empty. If that is the
-// case, the part gets automatically deallocated, hence freeing all of the
-// memory.
+// Upon deleting spaces, a part may become completely empty. Such a part stays
+// in the list and is recycled as soon as new spaces are needed. But only a
+// limited number of empty parts is retained. See NA_RUNTIME_RETAINED_PART_COUNT
+// in NAConfiguration.h. The runtime allows twice the number of empty parts to
+// be retained and only releases the ones above the limit during the next call
+// to naCollectGarbage. This prevents a type from allocating and freeing the
+// same part over and over again when its object count oscillates.
 
 // /////////////
 // Garbage collection:
@@ -92,6 +99,31 @@
 // When you call naCollectGarbage or if you stop the Runtime, that memory
 // will be completely erased.
 
+// /////////////
+// Thread caches:
+//
+// When NA_RUNTIME_USE_THREAD_CACHES is set to 1, the pool parts described
+// above are shared by all threads and guarded by one single mutex. To not
+// lock that mutex for every naNew and naDelete, each thread owns an
+// NA_ThreadCache which stores one NA_Magazine per runtime type. A magazine is
+// nothing more than a small stack of free spaces taken from the pool parts.
+//
+// naNew pops a space from the magazine of the current thread. Only if the
+// magazine is empty, the mutex gets locked and the magazine is refilled with
+// half of its capacity at once. naDelete pushes the space onto the magazine
+// and only if the magazine is full, the mutex gets locked and half of the
+// spaces are ejected back into their pool parts.
+//
+// Note that a space does not need to go back to the magazine of the thread it
+// was created in. Every space knows its part by the address mask, hence a
+// space deleted in another thread simply travels back to its part the next
+// time the magazine of the deleting thread overflows.
+//
+// The magazines of a thread are stored in an array indexed by the type id
+// which every type gets when it is added to the type registry. All thread
+// caches are linked together in na_Runtime such that they can be cleaned up
+// when the runtime stops.
+
 
 
 // This structure is stored in the first bytes of every part block.
@@ -119,9 +151,16 @@ struct NA_TypeInfo{
   size_t            typeSize;
   NAMutator         destructor;
   NABool            refCounting;
-  #if NA_DEBUG
-    const char*     typeName;
-  #endif
+  const char*       typeName;
+  size_t            typeAlign;
+  size_t            typeId;         // Index in the type registry
+  size_t            spaceSize;      // typeSize including padding
+  size_t            spaceOffset;    // Offset of the first space in a part
+  size_t            emptyPartCount;
+  size_t            partCount;
+  size_t            usedSpaceCount;
+  size_t            maxUsedSpaceCount;
+  size_t            allocationCount;
 };
 
 
@@ -130,12 +169,26 @@ struct NA_TypeInfo{
 // first two entries of the NAMallocGarbage struct.
 #define NA_MALLOC_GARBAGE_POINTER_COUNT (NA_POOLPART_BYTESIZE / NA_ADDRESS_BYTES - 2)
 
+NA_PROTOTYPE(NAMallocGarbage);
 struct NAMallocGarbage{
   NAMallocGarbage* next;
   size_t cur;
   void* pointers[NA_MALLOC_GARBAGE_POINTER_COUNT];
 };
 
+// Every thread has its own list of temporary pointers allocated with
+// naMallocTmp. Therefore, no locking is needed and every thread collects its
+// garbage independently. Note that the pointers are allocated with plain
+// naMalloc and hence, the garbage stays valid even if the runtime restarts.
+NA_PROTOTYPE(NA_ThreadGarbage);
+struct NA_ThreadGarbage{
+  NAMallocGarbage* mallocGarbage;
+  size_t byteCount;
+  size_t autoCollectLimit;
+};
+
+NA_THREAD_LOCAL NA_ThreadGarbage na_ThreadGarbage = {NA_NULL, 0, NA_GARBAGE_TMP_AUTOCOLLECT_LIMIT};
+
 
 
 // The global runtime variable.
@@ -143,6 +196,60 @@ NARuntime* na_Runtime = NA_NULL;
 
 
 
+#if NA_RUNTIME_USE_THREAD_CACHES == 1
+
+  NA_PROTOTYPE(NA_Magazine);
+  struct NA_Magazine{
+    NA_TypeInfo* typeInfo;
+    size_t count;
+    size_t allocationCount;
+    void* spaces[NA_RUNTIME_THREAD_CACHE_COUNT];
+  };
+
+  struct NA_ThreadCache{
+    NA_ThreadCache* nextCache;
+    size_t magazineCapacity;
+    NA_Magazine** magazines;     // Indexed by the type id.
+  };
+
+  #if NA_RUNTIME_THREAD_CACHE_COUNT < 2
+    #error "Thread cache count must at least be 2"
+  #endif
+
+  // The counts of a magazine are only changed by the thread owning it but
+  // naGetRuntimeTypeStats reads them from other threads. Therefore, the
+  // owner publishes every change with a relaxed atomic store.
+  NA_HIDEF size_t na_LoadMagazineCount(const size_t* count) {
+    #if NA_ADDRESS_BITS == 64
+      return (size_t)naAtomicLoadi64((const int64*)count, NA_MEMORY_ORDER_RELAXED);
+    #else
+      return (size_t)naAtomicLoadi32((const int32*)count, NA_MEMORY_ORDER_RELAXED);
+    #endif
+  }
+
+  NA_HIDEF void na_StoreMagazineCount(size_t* count, size_t value) {
+    #if NA_ADDRESS_BITS == 64
+      naAtomicStorei64((int64*)count, (int64)value, NA_MEMORY_ORDER_RELAXED);
+    #else
+      naAtomicStorei32((int32*)count, (int32)value, NA_MEMORY_ORDER_RELAXED);
+    #endif
+  }
+
+  // The initial number of magazine slots of a thread cache. The array grows
+  // when a type with a bigger id is used.
+  #define NA_THREAD_CACHE_INITIAL_CAPACITY 16
+
+  // Every start of the runtime increases the generation. A thread whose cache
+  // has a different generation uses a cache which has been freed already when
+  // the runtime had been stopped.
+  size_t na_RuntimeGeneration = 0;
+  NA_THREAD_LOCAL NA_ThreadCache* na_ThreadCache = NA_NULL;
+  NA_THREAD_LOCAL size_t na_ThreadCacheGeneration = 0;
+
+#endif
+
+
+
 // Security check: The pool byteSize must be big enough to store one struct
 // of NA_PoolPart. Note that byteSize 0 has the meaning of using the
 // memory page size.
@@ -152,19 +259,80 @@ NARuntime* na_Runtime = NA_NULL;
 
 
 
-// Registers a runtime type. Adds the typeInfo to the typeInfos found
-// in na_Runtime. Note that when aggressive cleanup is turned on, any type
-// which had been registered previously had already been unregistered.
-NA_HIDEF void na_RegisterTypeInfo(NA_TypeInfo* typeInfo) {
-  NA_TypeInfo** newinfos;
+// The typeId of a type is assigned while the pool mutex is locked but read
+// without a lock by na_FindThreadCacheMagazine. Therefore, it is published
+// with a release store.
+NA_HIDEF void na_StoreTypeInfoId(NA_TypeInfo* typeInfo, size_t typeId) {
+  #if NA_ADDRESS_BITS == 64
+    naAtomicStorei64((int64*)&typeInfo->typeId, (int64)typeId, NA_MEMORY_ORDER_RELEASE);
+  #else
+    naAtomicStorei32((int32*)&typeInfo->typeId, (int32)typeId, NA_MEMORY_ORDER_RELEASE);
+  #endif
+}
+
+NA_HIDEF size_t na_LoadTypeInfoId(const NA_TypeInfo* typeInfo) {
+  #if NA_ADDRESS_BITS == 64
+    return (size_t)naAtomicLoadi64((const int64*)&typeInfo->typeId, NA_MEMORY_ORDER_ACQUIRE);
+  #else
+    return (size_t)naAtomicLoadi32((const int32*)&typeInfo->typeId, NA_MEMORY_ORDER_ACQUIRE);
+  #endif
+}
+
+
+
+// The initial capacity of the type registry.
+#define NA_TYPE_REGISTRY_INITIAL_CAPACITY 32
+
+// Returns whether the given type is known to the type registry. Every type
+// keeps its id for as long as the runtime is running, even if it gets
+// unregistered due to NA_MEMORY_POOL_AGGRESSIVE_CLEANUP. The typeId field is
+// zero-initialized which is why the registry entry itself is checked.
+NA_HIDEF NABool na_IsTypeInfoKnown(const NA_TypeInfo* typeInfo) {
+  return typeInfo->typeId < na_Runtime->typeInfoCount
+    && na_Runtime->typeInfos[typeInfo->typeId] == typeInfo;
+}
+
+
+
+// Adds the typeInfo to the typeInfos found in na_Runtime and assigns the next
+// free type id, if the type does not already have one. The registry doubles
+// its capacity when full. When thread caches are in use, the pool mutex must
+// be locked.
+NA_HIDEF void na_AddTypeInfoToRegistry(NA_TypeInfo* typeInfo) {
+  if(na_IsTypeInfoKnown(typeInfo))
+    return;
+
+  if(na_Runtime->typeInfoCount == na_Runtime->typeInfoCapacity) {
+    size_t newCapacity = na_Runtime->typeInfoCapacity
+      ? 2 * na_Runtime->typeInfoCapacity
+      : NA_TYPE_REGISTRY_INITIAL_CAPACITY;
+    NA_TypeInfo** newinfos = naMalloc(sizeof(NA_TypeInfo*) * newCapacity);
+    if(na_Runtime->typeInfos) {
+      naCopyn(newinfos, na_Runtime->typeInfos, sizeof(NA_TypeInfo*) * na_Runtime->typeInfoCount);
+      naFree(na_Runtime->typeInfos);
+    }
+    na_Runtime->typeInfos = newinfos;
+    na_Runtime->typeInfoCapacity = newCapacity;
+  }
+
+  na_Runtime->typeInfos[na_Runtime->typeInfoCount] = typeInfo;
+  na_StoreTypeInfoId(typeInfo, na_Runtime->typeInfoCount);
+  na_Runtime->typeInfoCount++;
+}
+
+
 
+// Registers a runtime type which is about to get its first part. Note that
+// when aggressive cleanup is turned on, any type which had been registered
+// previously had already been unregistered.
+NA_HIDEF void na_RegisterTypeInfo(NA_TypeInfo* typeInfo) {
   #if NA_DEBUG
     if(typeInfo->curPart)
       naError("Newly registered type should have nullptr as current part.");
     if(typeInfo->typeSize < NA_ADDRESS_BYTES)
       naError("Size of type is too small");
-    if(typeInfo->typeSize > (na_Runtime->partSize - sizeof(NA_PoolPart)))
-      naError("Size of type is too big");
+    if(typeInfo->typeAlign & (typeInfo->typeAlign - 1))
+      naError("Alignment of type must be a power of two");
   #endif
 
   // As this is the first time, the runtime type gets used, we correct the
@@ -173,52 +341,41 @@ NA_HIDEF void na_RegisterTypeInfo(NA_TypeInfo* typeInfo) {
     typeInfo->typeSize += sizeof(NARefCount);
   }
 
-  // We enlarge the na_Runtime info array by one. Yes, this is very bad
-  // performance, but this code is usually called rather seldomly. If you
-  // experience here a lot of memory allocations, you might want to check if
-  // NA_MEMORY_POOL_AGGRESSIVE_CLEANUP is set to 1 and set it back to 0.
-  newinfos = naMalloc(sizeof(NA_TypeInfo*) * (na_Runtime->typeInfoCount + NA_ONE_s));
-
-  // We copy all previous infos to the newly allocated memory block.
-  if(na_Runtime->typeInfos) {
-    naCopyn(newinfos, na_Runtime->typeInfos, sizeof(NA_TypeInfo*) * na_Runtime->typeInfoCount);
+  // We compute where the spaces are located in a part. Without a specific
+  // alignment, they follow the NA_PoolPart header one after the other.
+  // Otherwise, the space size is padded to a multiple of the alignment and
+  // the first space is placed such that the pointer returned to the user,
+  // which is behind the reference count, if any, is aligned.
+  if(typeInfo->typeAlign > 1) {
+    size_t alignMask = typeInfo->typeAlign - 1;
+    size_t headerSize = typeInfo->refCounting ? sizeof(NARefCount) : 0;
+    typeInfo->spaceSize = (typeInfo->typeSize + alignMask) & ~alignMask;
+    typeInfo->spaceOffset = ((sizeof(NA_PoolPart) + headerSize + alignMask) & ~alignMask) - headerSize;
+  }else{
+    typeInfo->spaceSize = typeInfo->typeSize;
+    typeInfo->spaceOffset = sizeof(NA_PoolPart);
   }
 
-  // We add the new typeInfo as a pointer to the na_Runtime infos.
-  newinfos[na_Runtime->typeInfoCount] = typeInfo;
-  na_Runtime->typeInfoCount++;
+  #if NA_DEBUG
+    if(typeInfo->spaceOffset + typeInfo->spaceSize > na_Runtime->partSize)
+      naError("Size of type is too big");
+  #endif
 
-  // We cleanup the old infos and set the new ones to be valid.
-  naFree(na_Runtime->typeInfos);
-  na_Runtime->typeInfos = newinfos;
+  // The bookkeeping and the statistics start anew.
+  typeInfo->emptyPartCount = 0;
+  typeInfo->partCount = 0;
+  typeInfo->usedSpaceCount = 0;
+  typeInfo->maxUsedSpaceCount = 0;
+  typeInfo->allocationCount = 0;
+
+  na_AddTypeInfoToRegistry(typeInfo);
 }
 
 
 
+// Unregisters a runtime type which has no parts anymore. The type stays in
+// the registry and keeps its id.
 NA_HIDEF void na_UnregisterTypeInfo(NA_TypeInfo* typeInfo) {
-  NA_TypeInfo** newinfos = NA_NULL;
-  if(na_Runtime->typeInfoCount > 1) {
-    newinfos = naMalloc(sizeof(NA_TypeInfo*) * (na_Runtime->typeInfoCount - NA_ONE_s));
-
-    // We shrink the info array by one by omitting the one entry which equals
-    // the given parameter. Again, just like na_RegisterTypeInfo, this is not
-    // very fast, but does the job. See comment there.
-    size_t oldIndex = 0;
-    for(size_t i = 0; i < (na_Runtime->typeInfoCount - NA_ONE_s); ++i) {
-      if(na_Runtime->typeInfos[i] == typeInfo) {
-        oldIndex++;
-      }
-      newinfos[i] = na_Runtime->typeInfos[oldIndex];
-      oldIndex++;
-    }
-  }
-
-  na_Runtime->typeInfoCount--;
-
-  // We cleanup the old infos and set the new ones to be valid.
-  naFree(na_Runtime->typeInfos);
-  na_Runtime->typeInfos = newinfos;
-
   // We restore the original typeSize in case NA_MEMORY_POOL_AGGRESSIVE_CLEANUP
   // is set to 1 which means, the type might get re-registered.
   if(typeInfo->refCounting) {
@@ -230,6 +387,8 @@ NA_HIDEF void na_UnregisterTypeInfo(NA_TypeInfo* typeInfo) {
 
 NA_HDEF size_t na_GetTypeInfoAllocatedCount(NA_TypeInfo* typeInfo) {
   NA_PoolPart* firstpart = typeInfo->curPart;
+  if(!firstpart)
+    return 0;
   NA_PoolPart* curPart = firstpart->nextPart;
   size_t totalCount = firstpart->usedCount;
   while(curPart != firstpart) {
@@ -254,6 +413,24 @@ NA_HIDEF void na_AttachPoolPartAfterCurPoolPart(NA_TypeInfo* typeInfo, NA_PoolPa
   part->nextPart->prevPart = part;
 }
 
+// Allocates and frees the memory of a part. Big parts are mapped directly
+// from the system such that they can be backed by huge pages.
+NA_HIDEF NA_PoolPart* na_AllocPoolPartMemory() {
+  if(na_Runtime->mappedParts) {
+    return (NA_PoolPart*)naMallocMapped(na_Runtime->partSize, na_Runtime->partSize);
+  }else{
+    return (NA_PoolPart*)naMallocAligned(na_Runtime->partSize, na_Runtime->partSize);
+  }
+}
+
+NA_HIDEF void na_FreePoolPartMemory(NA_PoolPart* part) {
+  if(na_Runtime->mappedParts) {
+    naFreeMapped(part, na_Runtime->partSize);
+  }else{
+    naFreeAligned(part);
+  }
+}
+
 // This function gets called when no part has any more space.
 // A new part is created and added to the list at the current position.
 NA_HIDEF void na_EnhancePool(NA_TypeInfo* typeInfo) {
@@ -261,7 +438,7 @@ NA_HIDEF void na_EnhancePool(NA_TypeInfo* typeInfo) {
 
   // We create a new part with the size of a full part but we type it as
   // NA_PoolPart to access the first bytes.
-  part = (NA_PoolPart*)naMallocAligned(na_Runtime->partSize, na_Runtime->partSize);
+  part = na_AllocPoolPartMemory();
   #if NA_DEBUG
     if(!typeInfo)
       naCrash("typeInfo is null");
@@ -271,9 +448,12 @@ NA_HIDEF void na_EnhancePool(NA_TypeInfo* typeInfo) {
       naError("pool part badly aligned");
   #endif
 
+  na_Runtime->partAllocationCount++;
+  typeInfo->partCount++;
+
   // We initialize the basic fields of part.
   part->typeInfo = typeInfo;
-  part->maxCount = ((na_Runtime->partSize - sizeof(NA_PoolPart)) / typeInfo->typeSize);
+  part->maxCount = ((na_Runtime->partSize - typeInfo->spaceOffset) / typeInfo->spaceSize);
   part->usedCount = 0;
   part->everUsedCount = 0;
 
@@ -283,9 +463,9 @@ NA_HIDEF void na_EnhancePool(NA_TypeInfo* typeInfo) {
   // addresses. But this turned out to use quite some computing power and
   // hence this new method with the everUsedCount was created. Way better now.
 
-  // We set the pointer to the first available space to the first byte right
-  // after the NA_PoolPart.
-  part->firstUnused = (void*)(((NAByte*)part) + sizeof(NA_PoolPart));
+  // We set the pointer to the first available space which usually is the
+  // first byte right after the NA_PoolPart.
+  part->firstUnused = (void*)(((NAByte*)part) + typeInfo->spaceOffset);
 
   // If we are in debug mode, we also set the dummy variable for a consistency
   // check.
@@ -308,18 +488,10 @@ NA_HIDEF void na_EnhancePool(NA_TypeInfo* typeInfo) {
 
 
 
-NA_DEF void* na_NewStructInternal(NATypeInfo* info) {
-  #if NA_DEBUG
-    if(!naIsRuntimeRunning())
-      naCrash("Runtime not running. Use naStartRuntime()");
-    if(!info)
-      naCrash("Given type identifier is nullptr. Do not call na_NewStruct directly. Use the naNew macro.");
-    if(info->typeSize == 0)
-      naError("Type size is zero. Is the type void?");
-  #endif
-
-  NA_TypeInfo* typeInfo = (NA_TypeInfo*)info;
-
+// Makes sure the current part of the given type has at least one free space
+// and returns it. When thread caches are in use, the pool mutex must be
+// locked.
+NA_HIDEF NA_PoolPart* na_GetPoolPartWithSpace(NA_TypeInfo* typeInfo) {
   // If there is no current part, create a first one.
   // This happends either upon first naNew of this type ever or when aggressive
   // memory cleanup is activated. See Configuration.h
@@ -349,23 +521,33 @@ NA_DEF void* na_NewStructInternal(NATypeInfo* info) {
       naCrash("Still no space after creating new space.");
   #endif
 
+  // If the part had been used before but is empty, it is a retained part
+  // which gets recycled now.
+  if(!typeInfo->curPart->usedCount && typeInfo->curPart->everUsedCount) {
+    typeInfo->emptyPartCount--;
+    na_Runtime->retainedPartCount--;
+    na_Runtime->partRecycleCount++;
+  }
+
+  return typeInfo->curPart;
+}
+
+
+
+// Takes the next free space out of the pool parts of the given type. When
+// thread caches are in use, the pool mutex must be locked.
+NA_HIDEF void* na_TakePoolPartObject(NA_TypeInfo* typeInfo) {
+  na_GetPoolPartWithSpace(typeInfo);
+
   // We get the pointer to the first currently unused space.
   void* pointer = typeInfo->curPart->firstUnused;
-  void* retPointer = pointer;
-  
-  // In case this is a reference counting type, initialize the refCounter
-  // and set the retPointer to the correct position.
-  if(typeInfo->refCounting) {
-    naInitRefCount(pointer);
-    retPointer = (NAByte*)pointer + sizeof(NARefCount);
-  }
 
   // We find out which will be the next pointer to return.
   if(typeInfo->curPart->usedCount == typeInfo->curPart->everUsedCount) {
     // The current space has not been used ever and is de facto the one unused
     // space with the lowest address in this part. Use the next address one
-    // typeSize ahead for the next space.
-    typeInfo->curPart->firstUnused = (NAByte*)(typeInfo->curPart->firstUnused) + typeInfo->typeSize;
+    // spaceSize ahead for the next space.
+    typeInfo->curPart->firstUnused = (NAByte*)(typeInfo->curPart->firstUnused) + typeInfo->spaceSize;
 
     // Increase the number of ever used spaces in this part.
     typeInfo->curPart->everUsedCount++;
@@ -377,11 +559,19 @@ NA_DEF void* na_NewStructInternal(NATypeInfo* info) {
     // NARefCount structure which still is useful for error checking. So one
     // can still detect if the programmer erroneously wants to retain or
     // release the pointer.
-    typeInfo->curPart->firstUnused = *((void**)retPointer);
+    if(typeInfo->refCounting) {
+      typeInfo->curPart->firstUnused = *((void**)((NAByte*)pointer + sizeof(NARefCount)));
+    }else{
+      typeInfo->curPart->firstUnused = *((void**)pointer);
+    }
   }
 
-  // Increase the number of spaces used in this part.
+  // Increase the number of spaces used in this part and in total.
   typeInfo->curPart->usedCount++;
+  typeInfo->usedSpaceCount++;
+  if(typeInfo->usedSpaceCount > typeInfo->maxUsedSpaceCount) {
+    typeInfo->maxUsedSpaceCount = typeInfo->usedSpaceCount;
+  }
 
   #if NA_DEBUG
     #if defined NA_SYSTEM_SIZEINT_NOT_ADDRESS_SIZE
@@ -392,7 +582,224 @@ NA_DEF void* na_NewStructInternal(NATypeInfo* info) {
     #endif
   #endif
 
-  return retPointer;
+  return pointer;
+}
+
+
+
+// Takes count free spaces out of the pool parts of the given type and stores
+// them in outArray. Each part is carved up at once: First, all recycled
+// spaces of the free list are taken, then the never used spaces are handed
+// out one spaceSize after the other. When thread caches are in use, the pool
+// mutex must be locked.
+NA_HIDEF void na_TakePoolPartObjects(NA_TypeInfo* typeInfo, size_t count, void** outArray) {
+  while(count) {
+    NA_PoolPart* part = na_GetPoolPartWithSpace(typeInfo);
+    size_t takeCount = naMins(count, part->maxCount - part->usedCount);
+    size_t recycledCount = naMins(takeCount, part->everUsedCount - part->usedCount);
+    size_t i;
+
+    // Take the spaces of the free list. The last entry of the list points to
+    // the first never used space.
+    if(typeInfo->refCounting) {
+      for(i = 0; i < recycledCount; ++i) {
+        outArray[i] = part->firstUnused;
+        part->firstUnused = *((void**)((NAByte*)part->firstUnused + sizeof(NARefCount)));
+      }
+    }else{
+      for(i = 0; i < recycledCount; ++i) {
+        outArray[i] = part->firstUnused;
+        part->firstUnused = *((void**)part->firstUnused);
+      }
+    }
+
+    // Take the never used spaces.
+    NAByte* unused = part->firstUnused;
+    for(; i < takeCount; ++i) {
+      outArray[i] = unused;
+      unused += typeInfo->spaceSize;
+    }
+    part->firstUnused = unused;
+    part->everUsedCount += takeCount - recycledCount;
+
+    part->usedCount += takeCount;
+    typeInfo->usedSpaceCount += takeCount;
+    if(typeInfo->usedSpaceCount > typeInfo->maxUsedSpaceCount) {
+      typeInfo->maxUsedSpaceCount = typeInfo->usedSpaceCount;
+    }
+
+    outArray += takeCount;
+    count -= takeCount;
+  }
+}
+
+
+
+#if NA_RUNTIME_USE_THREAD_CACHES == 1
+
+  // Enlarges the magazine array of the given cache such that it can store
+  // the magazine of the given type id. The pool mutex must be locked.
+  NA_HIDEF void na_GrowThreadCache(NA_ThreadCache* cache, size_t typeId) {
+    size_t newCapacity = naMaxs(2 * cache->magazineCapacity, typeId + NA_ONE_s);
+    NA_Magazine** newMagazines = naMalloc(newCapacity * sizeof(NA_Magazine*));
+    naCopyn(newMagazines, cache->magazines, cache->magazineCapacity * sizeof(NA_Magazine*));
+    naZeron(&newMagazines[cache->magazineCapacity], (newCapacity - cache->magazineCapacity) * sizeof(NA_Magazine*));
+    naFree(cache->magazines);
+    cache->magazines = newMagazines;
+    cache->magazineCapacity = newCapacity;
+  }
+
+
+
+  NA_HIDEF NA_ThreadCache* na_CreateThreadCache() {
+    NA_ThreadCache* cache = naAlloc(NA_ThreadCache);
+    cache->magazineCapacity = NA_THREAD_CACHE_INITIAL_CAPACITY;
+    cache->magazines = naMalloc(cache->magazineCapacity * sizeof(NA_Magazine*));
+    naZeron(cache->magazines, cache->magazineCapacity * sizeof(NA_Magazine*));
+
+    naLockMutex(na_Runtime->poolMutex);
+      cache->nextCache = na_Runtime->threadCaches;
+      na_Runtime->threadCaches = cache;
+    naUnlockMutex(na_Runtime->poolMutex);
+
+    na_ThreadCache = cache;
+    na_ThreadCacheGeneration = na_RuntimeGeneration;
+    #if NA_THREAD_LOCAL_DESTRUCTORS == 1
+      naSetThreadLocal(na_Runtime->endingThreadLocal, cache);
+    #endif
+    return cache;
+  }
+
+
+
+  // Returns the magazine of the given cache for the given type or NA_NULL if
+  // there is none. Note that the typeId of a type might not be valid yet,
+  // hence the typeInfo of the magazine is compared as well.
+  NA_HIDEF NA_Magazine* na_FindThreadCacheMagazine(const NA_ThreadCache* cache, const NA_TypeInfo* typeInfo) {
+    size_t typeId = na_LoadTypeInfoId(typeInfo);
+    if(typeId < cache->magazineCapacity) {
+      NA_Magazine* magazine = cache->magazines[typeId];
+      if(magazine && magazine->typeInfo == typeInfo)
+        return magazine;
+    }
+    return NA_NULL;
+  }
+
+
+
+  // Returns the magazine of the current thread for the given type. Creates
+  // the thread cache and the magazine if necessary.
+  NA_HIDEF NA_Magazine* na_GetThreadMagazine(NA_TypeInfo* typeInfo) {
+    NA_ThreadCache* cache = na_ThreadCache;
+    if(!cache || na_ThreadCacheGeneration != na_RuntimeGeneration) {
+      cache = na_CreateThreadCache();
+    }
+
+    NA_Magazine* magazine = na_FindThreadCacheMagazine(cache, typeInfo);
+    if(magazine)
+      return magazine;
+
+    // No magazine found for this type. Make sure the type has an id and
+    // create a new magazine at that index. This happens while the pool mutex
+    // is locked as naGetRuntimeTypeStats reads the magazines of all threads.
+    magazine = naAlloc(NA_Magazine);
+    magazine->typeInfo = typeInfo;
+    magazine->count = 0;
+    magazine->allocationCount = 0;
+    naLockMutex(na_Runtime->poolMutex);
+      na_AddTypeInfoToRegistry(typeInfo);
+      if(typeInfo->typeId >= cache->magazineCapacity) {
+        na_GrowThreadCache(cache, typeInfo->typeId);
+      }
+      cache->magazines[typeInfo->typeId] = magazine;
+    naUnlockMutex(na_Runtime->poolMutex);
+    return magazine;
+  }
+
+
+
+  // Forward declaration. See below.
+  NA_HIDEF void na_EjectPoolPartObject(NA_PoolPart* part, void* pointer);
+
+
+
+  // Ejects the topmost count spaces of the magazine back into their parts.
+  // The pool mutex must be locked.
+  NA_HIDEF void na_FlushMagazine(NA_Magazine* magazine, size_t count) {
+    while(count) {
+      na_StoreMagazineCount(&magazine->count, magazine->count - 1);
+      void* pointer = magazine->spaces[magazine->count];
+      na_EjectPoolPartObject((NA_PoolPart*)((size_t)pointer & na_Runtime->partSizeMask), pointer);
+      count--;
+    }
+  }
+
+
+
+  // Ejects all spaces of all magazines of the given cache. The pool mutex
+  // must be locked.
+  NA_HIDEF void na_FlushThreadCache(NA_ThreadCache* cache) {
+    for(size_t i = 0; i < cache->magazineCapacity; ++i) {
+      if(cache->magazines[i]) {
+        na_FlushMagazine(cache->magazines[i], cache->magazines[i]->count);
+      }
+    }
+  }
+
+
+
+  NA_HIDEF void na_DeallocThreadCache(NA_ThreadCache* cache) {
+    for(size_t i = 0; i < cache->magazineCapacity; ++i) {
+      if(cache->magazines[i]) {
+        naFree(cache->magazines[i]);
+      }
+    }
+    naFree(cache->magazines);
+    naFree(cache);
+  }
+
+#endif
+
+
+
+NA_DEF void* na_NewStructInternal(NATypeInfo* info) {
+  #if NA_DEBUG
+    if(!naIsRuntimeRunning())
+      naCrash("Runtime not running. Use naStartRuntime()");
+    if(!info)
+      naCrash("Given type identifier is nullptr. Do not call na_NewStruct directly. Use the naNew macro.");
+    if(info->typeSize == 0)
+      naError("Type size is zero. Is the type void?");
+  #endif
+
+  NA_TypeInfo* typeInfo = (NA_TypeInfo*)info;
+
+  #if NA_RUNTIME_USE_THREAD_CACHES == 1
+    NA_Magazine* magazine = na_GetThreadMagazine(typeInfo);
+    if(!magazine->count) {
+      // The magazine is empty. Refill half of it from the shared pool.
+      naLockMutex(na_Runtime->poolMutex);
+        while(magazine->count < NA_RUNTIME_THREAD_CACHE_COUNT / 2) {
+          magazine->spaces[magazine->count] = na_TakePoolPartObject(typeInfo);
+          na_StoreMagazineCount(&magazine->count, magazine->count + 1);
+        }
+      naUnlockMutex(na_Runtime->poolMutex);
+    }
+    na_StoreMagazineCount(&magazine->count, magazine->count - 1);
+    na_StoreMagazineCount(&magazine->allocationCount, magazine->allocationCount + 1);
+    void* pointer = magazine->spaces[magazine->count];
+  #else
+    void* pointer = na_TakePoolPartObject(typeInfo);
+    typeInfo->allocationCount++;
+  #endif
+
+  // In case this is a reference counting type, initialize the refCounter
+  // and return the pointer to the actual content.
+  if(typeInfo->refCounting) {
+    naInitRefCount(pointer);
+    return (NAByte*)pointer + sizeof(NARefCount);
+  }
+  return pointer;
 }
 
 
@@ -420,6 +827,134 @@ NA_DEF void* na_CreateStruct(NATypeInfo* info) {
 
 
 
+NA_DEF void na_NewStructBatch(NATypeInfo* info, size_t count, void** outArray) {
+  #if NA_DEBUG
+    if(!naIsRuntimeRunning())
+      naCrash("Runtime not running. Use naStartRuntime()");
+    if(!info)
+      naCrash("Given type identifier is nullptr. Do not call na_NewStructBatch directly. Use the naNewBatch macro.");
+    if(!outArray && count)
+      naCrash("outArray is nullptr");
+    if(info->typeSize == 0)
+      naError("Type size is zero. Is the type void?");
+    if(info->refCounting)
+      naError("Do not use naNewBatch for reference-counting types.");
+  #endif
+
+  NA_TypeInfo* typeInfo = (NA_TypeInfo*)info;
+
+  // The batch bypasses the thread cache and takes the spaces directly from
+  // the shared pool.
+  #if NA_RUNTIME_USE_THREAD_CACHES == 1
+    naLockMutex(na_Runtime->poolMutex);
+  #endif
+
+  na_TakePoolPartObjects(typeInfo, count, outArray);
+  typeInfo->allocationCount += count;
+
+  #if NA_RUNTIME_USE_THREAD_CACHES == 1
+    naUnlockMutex(na_Runtime->poolMutex);
+  #endif
+}
+
+
+
+// Returns whether an additional empty part of the given type can be retained
+// without immediately releasing it. Parts are retained up to twice the limits
+// and trimmed down to the limits in naCollectGarbage.
+NA_HIDEF NABool na_IsEmptyPoolPartRetainable(const NA_TypeInfo* typeInfo) {
+  size_t maxCount = na_Runtime->maxRetainedPartCount;
+  size_t maxByteSize = na_Runtime->maxRetainedPartByteSize;
+  size_t retainedByteSize = na_Runtime->retainedPartCount * na_Runtime->partSize;
+  return (typeInfo->emptyPartCount <= maxCount || typeInfo->emptyPartCount - maxCount <= maxCount)
+    && (retainedByteSize <= maxByteSize || retainedByteSize - maxByteSize <= maxByteSize);
+}
+
+
+
+// Releases the given empty part. If it is the last part of its type, it is
+// only released when NA_MEMORY_POOL_AGGRESSIVE_CLEANUP is set to 1.
+NA_HIDEF void na_ReleaseEmptyPoolPart(NA_PoolPart* part) {
+  NA_TypeInfo* typeInfo = part->typeInfo;
+
+  #if NA_DEBUG
+    if(part->usedCount)
+      naError("Part is not empty.");
+  #endif
+
+  if(part->nextPart == part) {
+    #if NA_MEMORY_POOL_AGGRESSIVE_CLEANUP == 1
+      // If this part is the last part of the pool and the cleanup is set to
+      // aggressive, we shrink it away and unregister the type.
+      typeInfo->emptyPartCount--;
+      na_Runtime->retainedPartCount--;
+      na_Runtime->partReleaseCount++;
+      typeInfo->partCount--;
+      na_FreePoolPartMemory(part);
+      typeInfo->curPart = NA_NULL;
+      na_UnregisterTypeInfo(typeInfo);
+    #endif
+  }else{
+    // There are other parts in the pool. If the empty part is the one which
+    // is the current part of the pool, we move to the next part.
+    if(typeInfo->curPart == part) {
+      typeInfo->curPart = part->nextPart;
+    }
+
+    // We unlink the part from the list.
+    part->prevPart->nextPart = part->nextPart;
+    part->nextPart->prevPart = part->prevPart;
+    // And delete its memory.
+    typeInfo->emptyPartCount--;
+    na_Runtime->retainedPartCount--;
+    na_Runtime->partReleaseCount++;
+    typeInfo->partCount--;
+    na_FreePoolPartMemory(part);
+  }
+}
+
+
+
+// Releases empty parts of the given type until at most keepCount of them
+// remain. The last part of a type is only released when cleaning up
+// aggressively.
+NA_HIDEF void na_TrimEmptyPoolParts(NA_TypeInfo* typeInfo, size_t keepCount) {
+  while(typeInfo->curPart && typeInfo->emptyPartCount > keepCount) {
+    NA_PoolPart* emptyPart = NA_NULL;
+    NA_PoolPart* part = typeInfo->curPart;
+    do{
+      if(!part->usedCount && (part->nextPart != part || NA_MEMORY_POOL_AGGRESSIVE_CLEANUP == 1)) {
+        emptyPart = part;
+        break;
+      }
+      part = part->nextPart;
+    }while(part != typeInfo->curPart);
+
+    if(!emptyPart)
+      break;
+    na_ReleaseEmptyPoolPart(emptyPart);
+  }
+}
+
+
+
+// Releases all empty parts exceeding the retention limits.
+NA_HIDEF void na_TrimAllEmptyPoolParts() {
+  for(size_t i = na_Runtime->typeInfoCount; i > 0; --i) {
+    na_TrimEmptyPoolParts(na_Runtime->typeInfos[i - 1], na_Runtime->maxRetainedPartCount);
+  }
+  for(size_t i = na_Runtime->typeInfoCount; i > 0; --i) {
+    size_t retainedByteSize = na_Runtime->retainedPartCount * na_Runtime->partSize;
+    if(retainedByteSize <= na_Runtime->maxRetainedPartByteSize)
+      break;
+    NA_TypeInfo* typeInfo = na_Runtime->typeInfos[i - 1];
+    size_t excessCount = (retainedByteSize - na_Runtime->maxRetainedPartByteSize + na_Runtime->partSize - NA_ONE_s) / na_Runtime->partSize;
+    na_TrimEmptyPoolParts(typeInfo, (typeInfo->emptyPartCount > excessCount) ? typeInfo->emptyPartCount - excessCount : 0);
+  }
+}
+
+
+
 NA_HIDEF void na_EjectPoolPartObject(NA_PoolPart* part, void* pointer) {
   // The memory at pointer is expected to be erased and hence garbage.
 
@@ -452,44 +987,42 @@ NA_HIDEF void na_EjectPoolPartObject(NA_PoolPart* part, void* pointer) {
     na_AttachPoolPartAfterCurPoolPart(part->typeInfo, part);
   }
 
-  // We reduce the number of used spaces in this part.
+  // We reduce the number of used spaces in this part and in total.
   part->usedCount--;
+  part->typeInfo->usedSpaceCount--;
 
-  // If no more spaces are in use, we can shrink that part away.
+  // If no more spaces are in use, the part is retained or released.
   if(!part->usedCount) {
-    if(part->nextPart == part) {
-      #if NA_MEMORY_POOL_AGGRESSIVE_CLEANUP == 1
-        // If this part is the last part of the pool and the cleanup is set to
-        // aggressive, we shrink it away and unregister the type.
-        NA_TypeInfo* typeInfo = part->typeInfo;
-        naFreeAligned(part);
-        typeInfo->curPart = NA_NULL;
-        na_UnregisterTypeInfo(typeInfo);
-      #endif
-    }else{
-      // There are other parts in the pool. If the empty part is the one which
-      // is the current part of the pool, we move to the next part.
-      if(part->typeInfo->curPart == part) {
-        part->typeInfo->curPart = part->nextPart;
-      }
-
-      // Now, one could think of checking whether there are more parts with
-      // free space available and keep the part if there is absolutely none
-      // available. But that would become a bit of a list nightmare and would
-      // destroy the simplicity of the current approach. Still, might be an
-      // idea.
-
-      // We unlink the part from the list.
-      part->prevPart->nextPart = part->nextPart;
-      part->nextPart->prevPart = part->prevPart;
-      // And delete its memory.
-      naFreeAligned(part);
+    part->typeInfo->emptyPartCount++;
+    na_Runtime->retainedPartCount++;
+    if(!na_IsEmptyPoolPartRetainable(part->typeInfo)) {
+      na_ReleaseEmptyPoolPart(part);
     }
   }
 }
 
 
 
+// Gives the space at pointer back to the runtime. When thread caches are in
+// use, the space is put into the magazine of the current thread first.
+NA_HIDEF void na_GiveBackPoolPartObject(NA_PoolPart* part, void* pointer) {
+  #if NA_RUNTIME_USE_THREAD_CACHES == 1
+    NA_Magazine* magazine = na_GetThreadMagazine(part->typeInfo);
+    if(magazine->count == NA_RUNTIME_THREAD_CACHE_COUNT) {
+      // The magazine is full. Flush half of it back to the shared pool.
+      naLockMutex(na_Runtime->poolMutex);
+        na_FlushMagazine(magazine, NA_RUNTIME_THREAD_CACHE_COUNT / 2);
+      naUnlockMutex(na_Runtime->poolMutex);
+    }
+    magazine->spaces[magazine->count] = pointer;
+    na_StoreMagazineCount(&magazine->count, magazine->count + 1);
+  #else
+    na_EjectPoolPartObject(part, pointer);
+  #endif
+}
+
+
+
 NA_DEF void naDelete(void* pointer) {
   NA_PoolPart* part;
 
@@ -521,7 +1054,56 @@ NA_DEF void naDelete(void* pointer) {
       part->typeInfo->destructor(pointer);
     }
 
-    na_EjectPoolPartObject(part, pointer);
+    na_GiveBackPoolPartObject(part, pointer);
+
+  #endif
+}
+
+
+
+NA_DEF void naDeleteBatch(void** pointers, size_t count) {
+  #if NA_DEBUG
+    if(!naIsRuntimeRunning())
+      naCrash("Runtime not running. Use naStartRuntime()");
+    if(!pointers && count)
+      naCrash("pointers is nullptr");
+  #endif
+
+  #if defined NA_SYSTEM_SIZEINT_NOT_ADDRESS_SIZE
+    NA_UNUSED(pointers);
+    NA_UNUSED(count);
+  #else
+
+    // First, erase the contents of all spaces with their destructors.
+    for(size_t i = 0; i < count; ++i) {
+      NA_PoolPart* part = (NA_PoolPart*)((size_t)pointers[i] & na_Runtime->partSizeMask);
+      #if NA_DEBUG
+        if(!pointers[i])
+          naError("Deleting nullptr. Use a guard.");
+        if(part->dummy != part)
+          naError("Pointer seems not to be from a pool.");
+        if(part->typeInfo->refCounting)
+          naError("Pointer belongs to a reference-counting entity. Use naRelease instead of naDeleteBatch!");
+      #endif
+      if(part->typeInfo->destructor) {
+        part->typeInfo->destructor(pointers[i]);
+      }
+    }
+
+    // Then, give all spaces back to the shared pool at once. The batch
+    // bypasses the thread cache.
+    #if NA_RUNTIME_USE_THREAD_CACHES == 1
+      naLockMutex(na_Runtime->poolMutex);
+    #endif
+
+    for(size_t i = 0; i < count; ++i) {
+      NA_PoolPart* part = (NA_PoolPart*)((size_t)pointers[i] & na_Runtime->partSizeMask);
+      na_EjectPoolPartObject(part, pointers[i]);
+    }
+
+    #if NA_RUNTIME_USE_THREAD_CACHES == 1
+      naUnlockMutex(na_Runtime->poolMutex);
+    #endif
 
   #endif
 }
@@ -587,13 +1169,12 @@ NA_DEF void naRelease(void* pointer) {
 
     // Release the space and delete it with the destructor if refCount is zero.
     NARefCount* refCount = (NARefCount*)((NAByte*)pointer - sizeof(NARefCount));
-    naReleaseRefCount(refCount, pointer, part->typeInfo->destructor);
-    // Note: The following test could also be achieved by using a special
-    // mutator function in the previous naReleaseRefCount call. But this would
-    // always cause a function call, even for types without a destructor.
-    // Therefore, we do this here:
-    if(!na_GetRefCountCount(refCount)) {
-      na_EjectPoolPartObject(part, refCount);
+    // Note: Giving back the space could also be achieved by using a special
+    // mutator function in the following call. But this would always cause a
+    // function call, even for types without a destructor. Therefore, we use
+    // the returned value.
+    if(na_ReleaseRefCount(refCount, pointer, part->typeInfo->destructor)) {
+      na_GiveBackPoolPartObject(part, refCount);
     }
 
   #endif
@@ -621,9 +1202,15 @@ NA_HIDEF void na_EnhanceMallocGarbage() {
   if(!newGarbage)
     naCrash("No garbage memory allocated");
 #endif
-  newGarbage->next = na_Runtime->mallocGarbage;
+  // The first garbage of a thread makes sure it is freed when the thread
+  // ends.
+  #if NA_THREAD_LOCAL_DESTRUCTORS == 1
+    if(!na_ThreadGarbage.mallocGarbage)
+      naSetThreadLocal(na_Runtime->endingThreadLocal, &na_ThreadGarbage);
+  #endif
+  newGarbage->next = na_ThreadGarbage.mallocGarbage;
   newGarbage->cur = 0;
-  na_Runtime->mallocGarbage = newGarbage;
+  na_ThreadGarbage.mallocGarbage = newGarbage;
 }
 
 
@@ -634,27 +1221,25 @@ NA_DEF void* naMallocTmp(size_t byteSize) {
     naCrash("Runtime not running. Use naStartRuntime()");
 #endif
 
-#if NA_GARBAGE_TMP_AUTOCOLLECT_LIMIT != 0
-  if(na_Runtime->totalMallocGarbageByteCount > (size_t)NA_GARBAGE_TMP_AUTOCOLLECT_LIMIT) {
-    naCollectGarbage();
+  if(na_ThreadGarbage.autoCollectLimit && na_ThreadGarbage.byteCount > na_ThreadGarbage.autoCollectLimit) {
+    naCollectThreadGarbage();
   }
-#endif
 
-  na_Runtime->totalMallocGarbageByteCount += byteSize;
+  na_ThreadGarbage.byteCount += byteSize;
   void* newPtr = naMalloc(byteSize);
 
-  if(!na_Runtime->mallocGarbage || (na_Runtime->mallocGarbage->cur == NA_MALLOC_GARBAGE_POINTER_COUNT)) {
+  if(!na_ThreadGarbage.mallocGarbage || (na_ThreadGarbage.mallocGarbage->cur == NA_MALLOC_GARBAGE_POINTER_COUNT)) {
     na_EnhanceMallocGarbage();
   }
 
 #if NA_DEBUG
-  if(!na_Runtime->mallocGarbage)
+  if(!na_ThreadGarbage.mallocGarbage)
     naCrash("Garbage struct is nullptr");
-  if(na_Runtime->mallocGarbage->cur >= NA_MALLOC_GARBAGE_POINTER_COUNT)
+  if(na_ThreadGarbage.mallocGarbage->cur >= NA_MALLOC_GARBAGE_POINTER_COUNT)
     naCrash("Buffer overrun.");
 #endif
 
-  NAMallocGarbage* garbage = na_Runtime->mallocGarbage;
+  NAMallocGarbage* garbage = na_ThreadGarbage.mallocGarbage;
   garbage->pointers[garbage->cur] = newPtr;
   garbage->cur++;
   return newPtr;
@@ -662,47 +1247,206 @@ NA_DEF void* naMallocTmp(size_t byteSize) {
 
 
 
-NA_DEF void naCollectGarbage() {
-#if NA_DEBUG
-  if(!naIsRuntimeRunning())
-    naCrash("Runtime not running. Use naStartRuntime()");
-#endif
-  while(na_Runtime->mallocGarbage) {
-    void** ptr = na_Runtime->mallocGarbage->pointers;
-    for(size_t i = 0; i < na_Runtime->mallocGarbage->cur; ++i) {
+NA_DEF void naCollectThreadGarbage() {
+  while(na_ThreadGarbage.mallocGarbage) {
+    void** ptr = na_ThreadGarbage.mallocGarbage->pointers;
+    for(size_t i = 0; i < na_ThreadGarbage.mallocGarbage->cur; ++i) {
       naFree(*ptr);
       ptr++;
     }
-    NAMallocGarbage* nextGarbage = na_Runtime->mallocGarbage->next;
+    NAMallocGarbage* nextGarbage = na_ThreadGarbage.mallocGarbage->next;
 
     // If this was the last part, we decide if we want to delete it depending
     // on the aggressive setting.
   #if NA_MEMORY_POOL_AGGRESSIVE_CLEANUP == 1
-    naFree(na_Runtime->mallocGarbage);
-    na_Runtime->mallocGarbage = nextGarbage;
+    naFree(na_ThreadGarbage.mallocGarbage);
+    na_ThreadGarbage.mallocGarbage = nextGarbage;
   #else
     if(nextGarbage) {
-      naFree(na_Runtime->mallocGarbage);
-      na_Runtime->mallocGarbage = nextGarbage;
+      naFree(na_ThreadGarbage.mallocGarbage);
+      na_ThreadGarbage.mallocGarbage = nextGarbage;
     }else{
-      if(na_Runtime->mallocGarbage) {
-        na_Runtime->mallocGarbage->cur = 0;
-      }else{
-        #if NA_DEBUG
-          naError("This should not happen but code sanity checks require it.");
-        #endif
-      }
+      na_ThreadGarbage.mallocGarbage->cur = 0;
       break;
     }
   #endif
   }
 
-  na_Runtime->totalMallocGarbageByteCount = 0;
+  na_ThreadGarbage.byteCount = 0;
+}
+
+
+
+// Collects the garbage of the current thread and frees the garbage list
+// completely.
+NA_HIDEF void na_ClearThreadGarbage() {
+  naCollectThreadGarbage();
+  #if NA_MEMORY_POOL_AGGRESSIVE_CLEANUP == 0
+    if(na_ThreadGarbage.mallocGarbage) {
+      naFree(na_ThreadGarbage.mallocGarbage);
+      na_ThreadGarbage.mallocGarbage = NA_NULL;
+    }
+  #endif
+}
+
+
+
+NA_DEF void naSetThreadGarbageAutoCollectLimit(size_t byteSize) {
+  na_ThreadGarbage.autoCollectLimit = byteSize;
+}
+
+
+
+NA_DEF size_t naGetRuntimeGarbageByteSize() {
+  return na_ThreadGarbage.byteCount;
+}
+
+
+
+NA_DEF void naCollectGarbage() {
+#if NA_DEBUG
+  if(!naIsRuntimeRunning())
+    naCrash("Runtime not running. Use naStartRuntime()");
+#endif
+  naCollectThreadGarbage();
+
+  // Empty pool parts above the retention limits are released.
+  #if NA_RUNTIME_USE_THREAD_CACHES == 1
+    naLockMutex(na_Runtime->poolMutex);
+  #endif
+  na_TrimAllEmptyPoolParts();
+  #if NA_RUNTIME_USE_THREAD_CACHES == 1
+    naUnlockMutex(na_Runtime->poolMutex);
+  #endif
+}
+
+
+
+NA_DEF void naSetRuntimePartRetention(size_t partCount, size_t byteSize) {
+  #if NA_DEBUG
+    if(!naIsRuntimeRunning())
+      naCrash("Runtime not running. Use naStartRuntime()");
+  #endif
+  na_Runtime->maxRetainedPartCount = partCount;
+  na_Runtime->maxRetainedPartByteSize = byteSize;
 }
 
 
 
+NA_DEF size_t naGetRuntimeTypeStats(NARuntimeTypeStats* stats, size_t maxCount) {
+  #if NA_DEBUG
+    if(!naIsRuntimeRunning())
+      naCrash("Runtime not running. Use naStartRuntime()");
+    if(maxCount && !stats)
+      naCrash("stats is nullptr");
+  #endif
+
+  #if NA_RUNTIME_USE_THREAD_CACHES == 1
+    naLockMutex(na_Runtime->poolMutex);
+  #endif
+
+  size_t typeCount = na_Runtime->typeInfoCount;
+  for(size_t i = 0; i < typeCount && i < maxCount; ++i) {
+    NA_TypeInfo* typeInfo = na_Runtime->typeInfos[i];
+    size_t liveCount = typeInfo->usedSpaceCount;
+    size_t allocationCount = typeInfo->allocationCount;
+
+    #if NA_RUNTIME_USE_THREAD_CACHES == 1
+      // Spaces cached by threads are used by the pool but not alive. Other
+      // threads may allocate and delete without locking while reading their
+      // counts, hence the values are only approximate.
+      NA_ThreadCache* cache = na_Runtime->threadCaches;
+      while(cache) {
+        NA_Magazine* magazine = na_FindThreadCacheMagazine(cache, typeInfo);
+        if(magazine) {
+          liveCount -= na_LoadMagazineCount(&magazine->count);
+          allocationCount += na_LoadMagazineCount(&magazine->allocationCount);
+        }
+        cache = cache->nextCache;
+      }
+    #endif
+
+    stats[i].typeId = typeInfo->typeId;
+    stats[i].typeName = typeInfo->typeName;
+    stats[i].typeSize = typeInfo->spaceSize;
+    stats[i].liveCount = liveCount;
+    stats[i].maxLiveCount = typeInfo->maxUsedSpaceCount;
+    stats[i].allocationCount = allocationCount;
+    stats[i].partCount = typeInfo->partCount;
+    stats[i].emptyPartCount = typeInfo->emptyPartCount;
+    stats[i].reservedByteSize = typeInfo->partCount * na_Runtime->partSize;
+    stats[i].usedByteSize = liveCount * typeInfo->spaceSize;
+  }
+
+  #if NA_RUNTIME_USE_THREAD_CACHES == 1
+    naUnlockMutex(na_Runtime->poolMutex);
+  #endif
+
+  return typeCount;
+}
+
+
+
+NA_DEF void naFlushRuntimeThreadCache() {
+  #if NA_DEBUG
+    if(!naIsRuntimeRunning())
+      naCrash("Runtime not running. Use naStartRuntime()");
+  #endif
+  na_ClearThreadGarbage();
+  #if NA_RUNTIME_USE_THREAD_CACHES == 1
+    if(na_ThreadCache && na_ThreadCacheGeneration == na_RuntimeGeneration) {
+      naLockMutex(na_Runtime->poolMutex);
+        na_FlushThreadCache(na_ThreadCache);
+      naUnlockMutex(na_Runtime->poolMutex);
+    }
+  #endif
+}
+
+
+
+#if NA_THREAD_LOCAL_DESTRUCTORS == 1
+  // Called by the system when a thread having temporary memory or a thread
+  // cache ends. Other than naFlushRuntimeThreadCache, the cache itself is
+  // removed and freed as the thread will not use it anymore.
+  NA_HDEF void na_FlushEndingThreadCache(void* value) {
+    NA_UNUSED(value);
+    na_ClearThreadGarbage();
+    #if NA_RUNTIME_USE_THREAD_CACHES == 1
+      NA_ThreadCache* cache = na_ThreadCache;
+      if(cache && na_ThreadCacheGeneration == na_RuntimeGeneration) {
+        naLockMutex(na_Runtime->poolMutex);
+          na_FlushThreadCache(cache);
+          // Keep the allocations of this thread in the type statistics.
+          for(size_t i = 0; i < cache->magazineCapacity; ++i) {
+            if(cache->magazines[i]) {
+              cache->magazines[i]->typeInfo->allocationCount += cache->magazines[i]->allocationCount;
+            }
+          }
+          NA_ThreadCache** link = &na_Runtime->threadCaches;
+          while(*link != cache) {
+            link = &(*link)->nextCache;
+          }
+          *link = cache->nextCache;
+          na_DeallocThreadCache(cache);
+        naUnlockMutex(na_Runtime->poolMutex);
+      }
+      na_ThreadCache = NA_NULL;
+    #endif
+  }
+#endif
+
+
+
 NA_DEF void naStartRuntime() {
+  #if(NA_POOLPART_BYTESIZE >= NA_MAX_i32)
+    #error "Pool part byteSize is too large"
+  #endif
+  naStartRuntimeWithPartSize((size_t)NA_POOLPART_BYTESIZE);
+}
+
+
+
+NA_DEF void naStartRuntimeWithPartSize(size_t partByteSize) {
   #if defined NA_SYSTEM_SIZEINT_NOT_ADDRESS_SIZE
     #if NA_DEBUG
       naError("Unable to start runtime on system where no native int is able to store an address.");
@@ -714,35 +1458,65 @@ NA_DEF void naStartRuntime() {
         naCrash("Runtime already running");
       if(sizeof(NA_PoolPart) != (8 * NA_ADDRESS_BYTES))
         naError("NA_PoolPart struct encoding misaligned");
+      if(partByteSize & (partByteSize - 1))
+        naError("Pool part byteSize must be a power of two");
+      if(partByteSize != 0 && partByteSize <= 8 * NA_ADDRESS_BYTES)
+        naError("Pool part byteSize is too small");
     #endif
     na_Runtime = naAlloc(NARuntime);
     na_Runtime->memPageSize = naGetSystemMemoryPagesize();
-    #if(NA_POOLPART_BYTESIZE == 0)
+    if(partByteSize == 0) {
       na_Runtime->partSize = naGetSystemMemoryPagesize();
       na_Runtime->partSizeMask = naGetSystemMemoryPagesizeMask();
-    #elif(NA_POOLPART_BYTESIZE < NA_MAX_i32)
-      na_Runtime->partSize = (size_t)NA_POOLPART_BYTESIZE;
-      na_Runtime->partSizeMask = ~(size_t)(NA_POOLPART_BYTESIZE - NA_ONE_s);
-    #else
-      #error "Pool part byteSize is too large"
-    #endif
-    na_Runtime->mallocGarbage = NA_NULL;
-    na_Runtime->totalMallocGarbageByteCount = 0;
+    }else{
+      na_Runtime->partSize = partByteSize;
+      na_Runtime->partSizeMask = ~(partByteSize - NA_ONE_s);
+    }
+    na_Runtime->mappedParts = na_Runtime->partSize >= NA_HUGE_PAGE_BYTESIZE;
     na_Runtime->typeInfoCount = 0;
+    na_Runtime->typeInfoCapacity = 0;
     na_Runtime->typeInfos = NA_NULL;
+    na_Runtime->maxRetainedPartCount = NA_RUNTIME_RETAINED_PART_COUNT;
+    na_Runtime->maxRetainedPartByteSize = NA_RUNTIME_RETAINED_PART_BYTESIZE;
+    na_Runtime->retainedPartCount = 0;
+    na_Runtime->partAllocationCount = 0;
+    na_Runtime->partRecycleCount = 0;
+    na_Runtime->partReleaseCount = 0;
+    #if NA_THREAD_LOCAL_DESTRUCTORS == 1
+      na_Runtime->endingThreadLocal = naMakeThreadLocal(na_FlushEndingThreadCache);
+    #endif
+    #if NA_RUNTIME_USE_THREAD_CACHES == 1
+      na_Runtime->poolMutex = naMakeMutex();
+      naSetMutexName(na_Runtime->poolMutex, "NARuntime pool");
+      na_Runtime->threadCaches = NA_NULL;
+      na_RuntimeGeneration++;
+    #endif
   #endif
 }
 
 
 
 NA_DEF void naStopRuntime() {
-  // First, we collect the garbage
+  // First, we collect the garbage of this thread. Other threads should have
+  // called naCollectThreadGarbage before.
   naCollectGarbage();
-  #if NA_MEMORY_POOL_AGGRESSIVE_CLEANUP == 0
-    if(na_Runtime->mallocGarbage) {
-      naFree(na_Runtime->mallocGarbage);
-      na_Runtime->mallocGarbage = NA_NULL;
+  na_ClearThreadGarbage();
+
+  // All spaces still cached by any thread are given back to their parts and
+  // the caches are erased. Other threads must not use naNew or naDelete
+  // anymore at this point.
+  #if NA_RUNTIME_USE_THREAD_CACHES == 1
+    while(na_Runtime->threadCaches) {
+      NA_ThreadCache* nextCache = na_Runtime->threadCaches->nextCache;
+      na_FlushThreadCache(na_Runtime->threadCaches);
+      na_DeallocThreadCache(na_Runtime->threadCaches);
+      na_Runtime->threadCaches = nextCache;
     }
+    na_ThreadCache = NA_NULL;
+  #endif
+  #if NA_THREAD_LOCAL_DESTRUCTORS == 1
+    naSetThreadLocal(na_Runtime->endingThreadLocal, NA_NULL);
+    naClearThreadLocal(na_Runtime->endingThreadLocal);
   #endif
 
   // Then, we detect, if there are any memory leaks.
@@ -768,17 +1542,15 @@ NA_DEF void naStopRuntime() {
 
   // Go through all remaining registered types and completely erase them
   // from memory.
-  while(na_Runtime->typeInfos) {
-    NA_PoolPart* firstpart;
-    NA_PoolPart* curPart;
-    NA_PoolPart* nextPart;
+  for(size_t i = 0; i < na_Runtime->typeInfoCount; ++i) {
+    NA_TypeInfo* typeInfo = na_Runtime->typeInfos[i];
+    NA_PoolPart* firstpart = typeInfo->curPart;
+    NA_PoolPart* curPart = firstpart;
 
     // Free all parts.
-    firstpart = na_Runtime->typeInfos[0]->curPart;
-    curPart = firstpart;
     while(curPart) {
-      nextPart = curPart->nextPart;
-      naFreeAligned(curPart);
+      NA_PoolPart* nextPart = curPart->nextPart;
+      na_FreePoolPartMemory(curPart);
       
       if(nextPart == firstpart)
         break;
@@ -787,9 +1559,16 @@ NA_DEF void naStopRuntime() {
     }
 
     // Finally, unregister the type.
-    na_Runtime->typeInfos[0]->curPart = NA_NULL;
-    na_UnregisterTypeInfo(na_Runtime->typeInfos[0]);
+    if(firstpart) {
+      typeInfo->curPart = NA_NULL;
+      na_UnregisterTypeInfo(typeInfo);
+    }
   }
+  naFree(na_Runtime->typeInfos);
+
+  #if NA_RUNTIME_USE_THREAD_CACHES == 1
+    naClearMutex(na_Runtime->poolMutex);
+  #endif
 
   naFree(na_Runtime);
   na_Runtime = NA_NULL;
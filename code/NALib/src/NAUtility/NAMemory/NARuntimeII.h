@@ -12,9 +12,18 @@ struct NATypeInfo{
   size_t            typeSize;
   NAMutator         destructor;
   NABool            refCounting;
-  #if NA_DEBUG
-    const char*     typeName;
-  #endif
+  const char*       typeName;
+  size_t            typeAlign;      // 0 for no specific alignment.
+  // The following fields are bookkeeping of the runtime and are initialized
+  // with zero by NA_RUNTIME_TYPE. When adding a field, add a zero there too.
+  size_t            typeId;
+  size_t            spaceSize;
+  size_t            spaceOffset;
+  size_t            emptyPartCount;
+  size_t            partCount;
+  size_t            usedSpaceCount;
+  size_t            maxUsedSpaceCount;
+  size_t            allocationCount;
 };
 
 
@@ -22,22 +31,19 @@ struct NATypeInfo{
 // This is the runtime type macro which actually creates a global variable
 // called na_MyStruct_Typeinfo (for whatever MyStruct is) storing all values.
 #undef NA_RUNTIME_TYPE
-#if NA_DEBUG
-  #define NA_RUNTIME_TYPE(typeName, destructor, refCounting)\
-    NATypeInfo na_ ## typeName ## TypeInfo =\
-    {NA_NULL,\
-    sizeof(typeName),\
-    (NAMutator)destructor,\
-    refCounting,\
-    #typeName}
-#else
-  #define NA_RUNTIME_TYPE(typeName, destructor, refCounting)\
-    NATypeInfo na_ ## typeName ## TypeInfo =\
-    {NA_NULL,\
-    sizeof(typeName),\
-    (NAMutator)destructor,\
-    refCounting}
-#endif
+#define NA_RUNTIME_TYPE(typeName, destructor, refCounting)\
+  NA_RUNTIME_TYPE_ALIGNED(typeName, destructor, refCounting, 0)
+
+#undef NA_RUNTIME_TYPE_ALIGNED
+#define NA_RUNTIME_TYPE_ALIGNED(typeName, destructor, refCounting, align)\
+  NATypeInfo na_ ## typeName ## TypeInfo =\
+  {NA_NULL,\
+  sizeof(typeName),\
+  (NAMutator)destructor,\
+  refCounting,\
+  #typeName,\
+  align,\
+  0, 0, 0, 0, 0, 0, 0, 0}
 
 
 
@@ -53,6 +59,11 @@ struct NATypeInfo{
 // If you experience an error here with naNew: Have you marked your type
 // with NA_RUNTIME_TYPE? See NA_RUNTIME_TYPE below.
 
+#undef naNewBatch
+#define naNewBatch(typeName, count, outArray) na_NewStructBatch(&na_ ## typeName ## TypeInfo, count, (void**)(outArray))
+// If you experience an error here with naNewBatch: Have you marked your type
+// with NA_RUNTIME_TYPE? See NA_RUNTIME_TYPE below.
+
 #undef naCreate
 #define naCreate(typeName) ((typeName*)na_CreateStruct(&na_ ## typeName ## TypeInfo))
 // If you experience an error here with naCreate: Have you marked your type
@@ -60,11 +71,12 @@ struct NATypeInfo{
 
 NA_API void* na_NewStruct(NATypeInfo* info);
 NA_API void* na_CreateStruct(NATypeInfo* info);
+NA_API void na_NewStructBatch(NATypeInfo* info, size_t count, void** outArray);
 
 
 
 NA_PROTOTYPE(NA_TypeInfo);
-NA_PROTOTYPE(NAMallocGarbage);
+NA_PROTOTYPE(NA_ThreadCache);
 NA_PROTOTYPE(NARuntime);
 
 // The runtime struct stores base informations about the runtime.
@@ -72,10 +84,24 @@ struct NARuntime{
   size_t memPageSize;
   size_t partSize;
   size_t partSizeMask;
-  NAMallocGarbage* mallocGarbage;
-  size_t totalMallocGarbageByteCount;
+  NABool mappedParts;              // Parts allocated with naMallocMapped.
   size_t typeInfoCount;
-  NA_TypeInfo** typeInfos;
+  size_t typeInfoCapacity;
+  NA_TypeInfo** typeInfos;         // Indexed by the type id.
+  size_t maxRetainedPartCount;     // Max empty parts retained per type.
+  size_t maxRetainedPartByteSize;  // Max bytes of empty parts of all types.
+  size_t retainedPartCount;        // Number of empty parts of all types.
+  size_t partAllocationCount;
+  size_t partRecycleCount;
+  size_t partReleaseCount;
+  void* endingThreadLocal;         // An NAThreadLocal flushing and
+                                   // freeing the thread cache when a
+                                   // thread ends. Unused if
+                                   // NA_THREAD_LOCAL_DESTRUCTORS is 0.
+  #if NA_RUNTIME_USE_THREAD_CACHES == 1
+    void* poolMutex;               // An NAMutex guarding all pool parts.
+    NA_ThreadCache* threadCaches;  // The caches of all threads.
+  #endif
 };
 
 extern NARuntime* na_Runtime;
@@ -88,32 +114,63 @@ NA_IDEF NABool naIsRuntimeRunning() {
 
 
 
-NA_IDEF size_t naGetRuntimeGarbageByteSize() {
+
+NA_IDEF size_t naGetRuntimeMemoryPageSize() {
   #if NA_DEBUG
     if(!naIsRuntimeRunning())
       naCrash("Runtime not running. Use naStartRuntime()");
   #endif
-  return na_Runtime->totalMallocGarbageByteCount;
+  return na_Runtime->memPageSize;
 }
 
 
 
-NA_IDEF size_t naGetRuntimeMemoryPageSize() {
+NA_IDEF size_t naGetRuntimePoolPartSize() {
   #if NA_DEBUG
     if(!naIsRuntimeRunning())
       naCrash("Runtime not running. Use naStartRuntime()");
   #endif
-  return na_Runtime->memPageSize;
+  return na_Runtime->partSize;
 }
 
 
 
-NA_IDEF size_t naGetRuntimePoolPartSize() {
+NA_IDEF size_t naGetRuntimeRetainedPartCount() {
   #if NA_DEBUG
     if(!naIsRuntimeRunning())
       naCrash("Runtime not running. Use naStartRuntime()");
   #endif
-  return na_Runtime->partSize;
+  return na_Runtime->retainedPartCount;
+}
+
+
+
+NA_IDEF size_t naGetRuntimePartAllocationCount() {
+  #if NA_DEBUG
+    if(!naIsRuntimeRunning())
+      naCrash("Runtime not running. Use naStartRuntime()");
+  #endif
+  return na_Runtime->partAllocationCount;
+}
+
+
+
+NA_IDEF size_t naGetRuntimePartRecycleCount() {
+  #if NA_DEBUG
+    if(!naIsRuntimeRunning())
+      naCrash("Runtime not running. Use naStartRuntime()");
+  #endif
+  return na_Runtime->partRecycleCount;
+}
+
+
+
+NA_IDEF size_t naGetRuntimePartReleaseCount() {
+  #if NA_DEBUG
+    if(!naIsRuntimeRunning())
+      naCrash("Runtime not running. Use naStartRuntime()");
+  #endif
+  return na_Runtime->partReleaseCount;
 }
 
 
@@ -0,0 +1,280 @@
+#ifndef NA_TASK_POOL_INCLUDED
+#define NA_TASK_POOL_INCLUDED
+#ifdef __cplusplus
+  extern "C"{
+#endif
+
+
+
+// An NATaskPool is a fixed set of worker threads executing small tasks. A
+// task is simply a function with an argument. Instead of creating a new
+// NAThread for every piece of work to do in parallel, you submit the work to
+// a pool and the workers take care of it. This way, the number of threads
+// stays at the number of cores, no matter how many tasks are submitted.
+//
+// Every worker has its own double ended queue (a Chase-Lev deque) of tasks.
+// Tasks submitted from within a running task are pushed to the deque of the
+// current worker which executes them last-in-first-out. Workers running out
+// of tasks steal the oldest tasks of other workers. Tasks submitted from
+// threads outside the pool are put into a shared queue which all workers
+// look into.
+//
+// To wait for a set of tasks, use an NAWaitGroup. A thread awaiting a group
+// or the whole pool does not sleep idly but helps executing tasks until all
+// tasks in question are done. Therefore, it is safe to await a group from
+// within a task.
+//
+// The order in which tasks are executed is unspecified. Tasks must not wait
+// for each other by other means than wait groups, for example with mutexes or
+// alarms, as this may lead to all workers waiting.
+
+#include "../NABase/NABase.h"
+#include "../NAStruct/NAArray.h"
+
+
+
+NA_PROTOTYPE(NATaskPool);
+NA_PROTOTYPE(NAWaitGroup);
+
+// Allocates and deallocates a task pool. If workerCount is 0, one worker per
+// available processor core is created. Deallocating waits until all
+// submitted tasks are done.
+NA_API NATaskPool* naAllocTaskPool(size_t workerCount);
+NA_API void naDeallocTaskPool(NATaskPool* pool);
+
+// Returns the number of worker threads of the pool.
+NA_API size_t naGetTaskPoolWorkerCount(const NATaskPool* pool);
+
+// Returns the number of processor cores available to this process.
+NA_API size_t naGetProcessorCount(void);
+
+// Submits a task to the pool. The task will be called with arg as its only
+// argument on one of the worker threads. The Group variant additionally
+// registers the task in the given wait group. Tasks can be submitted from any
+// thread, including the workers themselves.
+NA_API void naSubmitTask(NATaskPool* pool, NAMutator task, void* arg);
+NA_API void naSubmitGroupTask(
+  NATaskPool* pool,
+  NAWaitGroup* group,
+  NAMutator task,
+  void* arg);
+
+// Waits until all tasks submitted to the pool so far are done. The calling
+// thread helps executing tasks while waiting. Do not call this from within a
+// task as the pool would wait for that very task. Use a wait group instead.
+NA_API void naAwaitTaskPool(NATaskPool* pool);
+
+// Allocates and deallocates a wait group. A group must not have any pending
+// tasks when being deallocated.
+NA_API NAWaitGroup* naAllocWaitGroup(void);
+NA_API void naDeallocWaitGroup(NAWaitGroup* group);
+
+// Waits until all tasks submitted with the given group are done. The calling
+// thread helps executing tasks of the pool while waiting. A group can be
+// reused after having been awaited.
+NA_API void naAwaitWaitGroup(NATaskPool* pool, NAWaitGroup* group);
+
+// Returns the number of tasks of the group which are not done yet.
+NA_API size_t naGetWaitGroupCount(const NAWaitGroup* group);
+
+// Returns the index of the worker of the given pool the calling thread is.
+// For any thread which is not a worker of this pool, the worker count is
+// returned. Therefore, arrays with workerCount + 1 elements can be used to
+// store data per thread, for example partial results.
+NA_API size_t naGetCurrentTaskPoolWorkerIndex(const NATaskPool* pool);
+
+
+
+// ///////////////////////////////////
+// Parallel loops
+//
+// The following functions distribute the indices of a range [begin, end)
+// onto the default task pool. The range is split in halves recursively until
+// the pieces contain at most grainSize indices. The halves not being worked
+// on are offered to other workers, hence idle workers steal big pieces of
+// work and busy ones keep on splitting only what they process themselves.
+// If grainSize is 0, a grain size is chosen such that every thread gets a
+// few pieces. Ranges not bigger than the grain size are processed directly
+// by the calling thread without involving the pool at all.
+//
+// The calling thread takes part in the work and the functions return when
+// the whole range has been processed. The callbacks are called in no
+// particular order and concurrently, so they must only write to data which
+// belongs to their own subrange.
+
+typedef void(*NAParallelForCallback)(
+  size_t begin,
+  size_t end,
+  void* userData);
+typedef void(*NAParallelReduceCallback)(
+  size_t begin,
+  size_t end,
+  void* partial,
+  void* userData);
+typedef void(*NAParallelJoinCallback)(
+  void* result,
+  const void* partial,
+  void* userData);
+
+// Returns the task pool used by the parallel loops. It is created with one
+// worker less than there are processor cores at the first call. Stopping
+// deallocates it, the next call will create a new one.
+NA_API NATaskPool* naGetDefaultTaskPool(void);
+NA_API void naStopDefaultTaskPool(void);
+
+// Calls callback for disjoint subranges covering [begin, end).
+NA_API void naParallelFor(
+  size_t begin,
+  size_t end,
+  size_t grainSize,
+  NAParallelForCallback callback,
+  void* userData);
+
+// Like naParallelFor but with a partial result per thread: When called,
+// result must contain the neutral element of the reduction (for example 0
+// for a sum) with a size of resultByteSize bytes. Every thread gets its own
+// copy of it as a partial which it accumulates the results of its subranges
+// into with the reduce callback. At the end, all partials are joined into
+// result with the join callback, one after the other on the calling thread.
+// The reduce callback must not await other tasks while its partial is in an
+// intermediate state as the thread may process another subrange meanwhile.
+NA_API void naParallelReduce(
+  size_t begin,
+  size_t end,
+  size_t grainSize,
+  void* result,
+  size_t resultByteSize,
+  NAParallelReduceCallback callback,
+  NAParallelJoinCallback join,
+  void* userData);
+
+// Same as naForeachArrayConst and its siblings in NAArray.h but the elements
+// are distributed onto multiple threads using naParallelFor. The accessor or
+// mutator is called for all elements in no particular order and
+// concurrently. Use these only if the calls are independent of each other
+// and costly enough to be worth it.
+NA_API void naForeachArrayConstParallel   (NAArray* array, NAAccessor accessor);
+NA_API void naForeachArrayMutableParallel (NAArray* array, NAMutator  mutator);
+NA_API void naForeachArraypConstParallel  (NAArray* array, NAAccessor accessor);
+NA_API void naForeachArraypMutableParallel(NAArray* array, NAMutator  mutator);
+
+
+
+// ///////////////////////////////////
+// Futures
+//
+// An NAFuture is the result of some work which will be available at some
+// point in the future. Either submit a task returning the result with
+// naSubmitFutureTask or allocate a future yourself and fulfill it whenever
+// the result is ready, for example in a thread waiting for I/O.
+//
+// Any number of threads can await a future. A future can only be fulfilled
+// once and must be fulfilled before being deallocated. Deallocate it only
+// when no other thread awaits it anymore.
+
+NA_PROTOTYPE(NAFuture);
+
+typedef void*(*NAFutureCallback)(void* arg);
+
+// Allocates and deallocates a future to be fulfilled by naFulfillFuture.
+NA_API NAFuture* naAllocFuture(void);
+NA_API void naDeallocFuture(NAFuture* future);
+
+// Submits a task to the pool and returns a future which will be fulfilled
+// with the return value of the task. Deallocate it after it is done.
+NA_API NAFuture* naSubmitFutureTask(
+  NATaskPool* pool,
+  NAFutureCallback task,
+  void* arg);
+
+// Stores the result in the future and wakes up all threads awaiting it.
+NA_API void naFulfillFuture(NAFuture* future, void* result);
+
+// Waits until the future is fulfilled or until the timeout occurs. Returns
+// NA_TRUE if fulfilled or NA_FALSE if the timeout occured. As with
+// naAwaitAlarm, a maxWaitTime of exactly 0 waits indefinitely. When a
+// worker of the pool the future has been submitted to waits indefinitely,
+// it helps executing tasks meanwhile.
+NA_API NABool naAwaitFuture(NAFuture* future, double maxWaitTime);
+
+// Returns whether the future has been fulfilled without waiting.
+NA_API NABool naIsFutureDone(const NAFuture* future);
+
+// Returns the result of a fulfilled future.
+NA_API void* naGetFutureResult(const NAFuture* future);
+
+
+
+// ///////////////////////////////////
+// Task graphs
+//
+// A task graph is a set of tasks with dependencies between them. When the
+// graph runs, every task is submitted to the pool as soon as all tasks it
+// depends on are done. Independent tasks run in parallel. For example, to
+// load many images, every image can be a chain of reading, decoding and
+// converting, all chains running side by side.
+//
+// Build the graph first, then run it. A graph can be run again after having
+// been awaited. It must not contain cycles. While running, no nodes or
+// dependencies must be added.
+
+NA_PROTOTYPE(NATaskGraph);
+NA_PROTOTYPE(NATaskNode);
+
+// Allocates and deallocates a graph whose tasks will run in the given pool.
+// Deallocating a running graph is not allowed.
+NA_API NATaskGraph* naAllocTaskGraph(NATaskPool* pool);
+NA_API void naDeallocTaskGraph(NATaskGraph* graph);
+
+// Adds a task to the graph. The returned node is owned by the graph.
+NA_API NATaskNode* naAddTaskGraphNode(
+  NATaskGraph* graph,
+  NAMutator task,
+  void* arg);
+
+// Declares that the task of node must not start before the task of
+// dependency is done. Both must be nodes of the same graph.
+NA_API void naAddTaskGraphDependency(
+  NATaskNode* node,
+  NATaskNode* dependency);
+
+// Starts all tasks without dependencies and returns immediately.
+NA_API void naRunTaskGraph(NATaskGraph* graph);
+
+// Waits until all tasks of the graph are done. The calling thread helps
+// executing tasks meanwhile.
+NA_API void naAwaitTaskGraph(NATaskGraph* graph);
+
+
+
+#ifdef __cplusplus
+  } // extern "C"
+#endif
+#endif // NA_TASK_POOL_INCLUDED
+
+
+
+// This is free and unencumbered software released into the public domain.
+
+// Anyone is free to copy, modify, publish, use, compile, sell, or
+// distribute this software, either in source code form or as a compiled
+// binary, for any purpose, commercial or non-commercial, and by any
+// means.
+
+// In jurisdictions that recognize copyright laws, the author or authors
+// of this software dedicate any and all copyright interest in the
+// software to the public domain. We make this dedication for the benefit
+// of the public at large and to the detriment of our heirs and
+// successors. We intend this dedication to be an overt act of
+// relinquishment in perpetuity of all present and future rights to this
+// software under copyright law.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+
+// For more information, please refer to <http://unlicense.org/>
@@ -0,0 +1,1193 @@
+
+#include "../NATaskPool.h"
+#include "../NAMemory.h"
+#include "../NAThreading.h"
+#include "../NABinaryData.h"
+#include "../../NAMath/NAMathOperators.h"
+
+#if NA_OS == NA_OS_WINDOWS
+  #include <windows.h>
+#else
+  #include <unistd.h>
+#endif
+
+
+
+// The atomic operations needed by the deques and counters. Loads acquire,
+// stores release and everything else is sequentially consistent.
+#define na_LoadTaskPoolInt(ptr)          naAtomicLoadi64((ptr), NA_MEMORY_ORDER_ACQUIRE)
+#define na_StoreTaskPoolInt(ptr, value)  naAtomicStorei64((ptr), (value), NA_MEMORY_ORDER_RELEASE)
+#define na_AddTaskPoolInt(ptr, value)    naAtomicAddi64((ptr), (value), NA_MEMORY_ORDER_ACQ_REL)
+#define na_LoadTaskPoolPtr(ptr)          naAtomicLoadPtr((void* const*)(ptr), NA_MEMORY_ORDER_ACQUIRE)
+#define na_StoreTaskPoolPtr(ptr, value)  naAtomicStorePtr((void**)(ptr), (value), NA_MEMORY_ORDER_RELEASE)
+#define na_TaskPoolFence()               naAtomicFence(NA_MEMORY_ORDER_SEQ_CST)
+
+NA_HIDEF NABool na_CompareExchangeTaskPoolInt(int64* ptr, int64 expected, int64 desired) {
+  return naAtomicCompareExchangei64(ptr, &expected, desired, NA_MEMORY_ORDER_SEQ_CST);
+}
+NA_HIDEF NABool na_CompareExchangeTaskPoolPtr(void** ptr, void* expected, void* desired) {
+  return naAtomicCompareExchangePtr(ptr, &expected, desired, NA_MEMORY_ORDER_SEQ_CST);
+}
+
+
+
+// The initial number of tasks a deque can store. Deques grow when full.
+#define NA_TASK_DEQUE_INITIAL_CAPACITY 256
+
+// A thread awaiting a wait group or a future whose remaining tasks are
+// executed by other workers sleeps until it gets woken up or until a timeout
+// occurs to look for new tasks and to check again. The timeout starts with
+// the minimum and doubles up to the maximum, both in seconds.
+#define NA_TASK_AWAIT_MIN_INTERVAL .00001
+#define NA_TASK_AWAIT_MAX_INTERVAL .001
+
+// When choosing the grain size automatically, the range is split into this
+// many pieces per thread.
+#define NA_PARALLEL_PIECES_PER_THREAD 4
+
+
+
+typedef struct NA_Task NA_Task;
+struct NA_Task{
+  NAMutator function;
+  void* arg;
+  NAWaitGroup* group;
+  NA_Task* next;              // Used in the shared queue.
+};
+
+typedef struct NA_TaskArray NA_TaskArray;
+struct NA_TaskArray{
+  int64 capacity;             // Always a power of two.
+  NA_TaskArray* prev;         // Older arrays are kept until the pool dies.
+  NA_Task** tasks;
+};
+
+// A Chase-Lev deque. Only the owning worker pushes and takes at the bottom,
+// all other threads steal at the top.
+typedef struct NA_TaskDeque NA_TaskDeque;
+struct NA_TaskDeque{
+  int64 top;
+  int64 bottom;
+  NA_TaskArray* array;
+};
+
+typedef struct NA_TaskWorker NA_TaskWorker;
+struct NA_TaskWorker{
+  NATaskPool* pool;
+  size_t index;
+  uint32 randomState;
+  NA_TaskDeque deque;
+  NAThread thread;
+};
+
+struct NAWaitGroup{
+  int64 count;
+};
+
+struct NATaskPool{
+  size_t workerCount;
+  NA_TaskWorker* workers;
+
+  NASpinMutex sharedMutex;    // Protects the shared queue.
+  NA_Task* sharedFirst;
+  NA_Task* sharedLast;
+  int64 sharedCount;
+
+  NAWaitGroup allTasks;       // Counts all tasks not done yet.
+  int64 sleepingCount;
+  NAAlarm wakeAlarm;
+  int64 stop;
+};
+
+struct NAFuture{
+  NATaskPool* pool;           // The pool running the callback, if any.
+  NAFutureCallback callback;
+  void* arg;
+  void* result;
+  int64 state;                // One of the NA_FUTURE_ constants below.
+  int64 refCount;             // The owner and the fulfilling thread.
+  NAAlarm alarm;
+};
+
+#define NA_FUTURE_PENDING   0
+#define NA_FUTURE_DONE      1   // The result is available.
+
+typedef struct NA_TaskEdge NA_TaskEdge;
+struct NA_TaskEdge{
+  NATaskNode* node;           // The node depending on the owner of the edge.
+  NA_TaskEdge* next;
+};
+
+struct NATaskNode{
+  NATaskGraph* graph;
+  NAMutator task;
+  void* arg;
+  size_t dependencyCount;
+  int64 pendingCount;         // Dependencies not done yet while running.
+  NA_TaskEdge* firstDependent;
+  NATaskNode* next;
+};
+
+struct NATaskGraph{
+  NATaskPool* pool;
+  NAWaitGroup* group;         // Counts the submitted tasks not done yet.
+  NATaskNode* firstNode;
+  NATaskNode* lastNode;
+  size_t nodeCount;
+};
+
+// The shared state of one call to naParallelFor or naParallelReduce.
+typedef struct NA_ParallelLoop NA_ParallelLoop;
+struct NA_ParallelLoop{
+  NATaskPool* pool;
+  NAWaitGroup* group;
+  size_t grainSize;
+  NAParallelForCallback forCallback;
+  NAParallelReduceCallback reduceCallback;
+  NAByte* partials;           // One per thread, each on its own cache lines.
+  size_t partialStride;
+  const void* owner;          // Identifies the thread which called the loop.
+  NAMutex foreignMutex;       // Protects the partial of foreign threads.
+  void* userData;
+};
+
+typedef struct NA_ParallelRange NA_ParallelRange;
+struct NA_ParallelRange{
+  NA_ParallelLoop* loop;
+  size_t begin;
+  size_t end;
+};
+
+// The worker the current thread is, if any.
+NA_THREAD_LOCAL NA_TaskWorker* na_CurrentTaskWorker = NA_NULL;
+
+// The pool used by the parallel loops.
+NATaskPool* na_DefaultTaskPool = NA_NULL;
+
+
+
+NA_HDEF NA_TaskArray* na_AllocTaskArray(int64 capacity, NA_TaskArray* prev) {
+  NA_TaskArray* array = naAlloc(NA_TaskArray);
+  array->capacity = capacity;
+  array->prev = prev;
+  array->tasks = naMalloc((size_t)capacity * sizeof(NA_Task*));
+  return array;
+}
+
+
+
+NA_HDEF void na_InitTaskDeque(NA_TaskDeque* deque) {
+  deque->top = 0;
+  deque->bottom = 0;
+  deque->array = na_AllocTaskArray(NA_TASK_DEQUE_INITIAL_CAPACITY, NA_NULL);
+}
+
+
+
+NA_HDEF void na_ClearTaskDeque(NA_TaskDeque* deque) {
+  NA_TaskArray* array = deque->array;
+  while(array) {
+    NA_TaskArray* prev = array->prev;
+    naFree(array->tasks);
+    naFree(array);
+    array = prev;
+  }
+}
+
+
+
+// Only to be called by the owner of the deque.
+NA_HDEF void na_PushTaskDeque(NA_TaskDeque* deque, NA_Task* task) {
+  int64 bottom = deque->bottom;
+  int64 top = na_LoadTaskPoolInt(&deque->top);
+  NA_TaskArray* array = deque->array;
+
+  if(bottom - top > array->capacity - 1) {
+    // The deque is full. Copy all tasks into an array of double the size.
+    // Thieves may still read from the old array, therefore it is kept.
+    NA_TaskArray* newArray = na_AllocTaskArray(array->capacity * 2, array);
+    int64 i;
+    for(i = top; i < bottom; ++i) {
+      newArray->tasks[i & (newArray->capacity - 1)] = array->tasks[i & (array->capacity - 1)];
+    }
+    na_StoreTaskPoolPtr(&deque->array, newArray);
+    array = newArray;
+  }
+
+  array->tasks[bottom & (array->capacity - 1)] = task;
+  na_StoreTaskPoolInt(&deque->bottom, bottom + 1);
+}
+
+
+
+// Only to be called by the owner of the deque. Returns NA_NULL if empty.
+NA_HDEF NA_Task* na_TakeTaskDeque(NA_TaskDeque* deque) {
+  int64 bottom = deque->bottom - 1;
+  NA_TaskArray* array = deque->array;
+  int64 top;
+  NA_Task* task;
+
+  na_StoreTaskPoolInt(&deque->bottom, bottom);
+  na_TaskPoolFence();
+  top = na_LoadTaskPoolInt(&deque->top);
+
+  if(top > bottom) {
+    // The deque was empty.
+    na_StoreTaskPoolInt(&deque->bottom, bottom + 1);
+    return NA_NULL;
+  }
+
+  task = array->tasks[bottom & (array->capacity - 1)];
+  if(top == bottom) {
+    // This is the last task. Race against the thieves for it.
+    if(!na_CompareExchangeTaskPoolInt(&deque->top, top, top + 1))
+      task = NA_NULL;
+    na_StoreTaskPoolInt(&deque->bottom, bottom + 1);
+  }
+  return task;
+}
+
+
+
+// Can be called by any thread. Returns NA_NULL if empty or if the race for
+// the task has been lost.
+NA_HDEF NA_Task* na_StealTaskDeque(NA_TaskDeque* deque) {
+  int64 top = na_LoadTaskPoolInt(&deque->top);
+  int64 bottom;
+  na_TaskPoolFence();
+  bottom = na_LoadTaskPoolInt(&deque->bottom);
+
+  if(top < bottom) {
+    NA_TaskArray* array = na_LoadTaskPoolPtr(&deque->array);
+    NA_Task* task = array->tasks[top & (array->capacity - 1)];
+    if(na_CompareExchangeTaskPoolInt(&deque->top, top, top + 1))
+      return task;
+  }
+  return NA_NULL;
+}
+
+
+
+NA_HDEF NA_Task* na_TakeSharedTask(NATaskPool* pool) {
+  NA_Task* task = NA_NULL;
+  if(na_LoadTaskPoolInt(&pool->sharedCount) == 0)
+    return NA_NULL;
+
+  naLockSpinMutex(pool->sharedMutex);
+    if(pool->sharedFirst) {
+      task = pool->sharedFirst;
+      pool->sharedFirst = task->next;
+      if(!pool->sharedFirst)
+        pool->sharedLast = NA_NULL;
+      na_AddTaskPoolInt(&pool->sharedCount, -1);
+    }
+  naUnlockSpinMutex(pool->sharedMutex);
+  return task;
+}
+
+
+
+// Looks for a task in the following order: The deque of the current worker,
+// the shared queue and the deques of the other workers, starting at a random
+// one.
+NA_HDEF NA_Task* na_FindTask(NATaskPool* pool, NA_TaskWorker* worker) {
+  NA_Task* task = NA_NULL;
+  size_t start;
+  size_t i;
+
+  if(worker) {
+    task = na_TakeTaskDeque(&worker->deque);
+    if(task)
+      return task;
+  }
+
+  task = na_TakeSharedTask(pool);
+  if(task)
+    return task;
+
+  if(worker) {
+    // xorshift
+    worker->randomState ^= worker->randomState << 13;
+    worker->randomState ^= worker->randomState >> 17;
+    worker->randomState ^= worker->randomState << 5;
+    start = worker->randomState % pool->workerCount;
+  }else{
+    start = 0;
+  }
+
+  for(i = 0; i < pool->workerCount; ++i) {
+    NA_TaskWorker* victim = &pool->workers[(start + i) % pool->workerCount];
+    if(victim == worker)
+      continue;
+    task = na_StealTaskDeque(&victim->deque);
+    if(task)
+      return task;
+  }
+  return NA_NULL;
+}
+
+
+
+NA_HDEF void na_RunTask(NATaskPool* pool, NA_Task* task) {
+  NAWaitGroup* group = task->group;
+  task->function(task->arg);
+  naFree(task);
+
+  if(group)
+    na_AddTaskPoolInt(&group->count, -1);
+  na_AddTaskPoolInt(&pool->allTasks.count, -1);
+}
+
+
+
+NA_HDEF void na_RunTaskPoolWorker(void* arg) {
+  NA_TaskWorker* worker = (NA_TaskWorker*)arg;
+  NATaskPool* pool = worker->pool;
+  na_CurrentTaskWorker = worker;
+
+  while(!na_LoadTaskPoolInt(&pool->stop)) {
+    NA_Task* task = na_FindTask(pool, worker);
+    if(task) {
+      na_RunTask(pool, task);
+    }else{
+      // Announce to be sleeping and take a ticket before the final check
+      // such that a submitting thread either sees us sleeping and its
+      // trigger is not lost or we see its task.
+      int32 ticket;
+      na_AddTaskPoolInt(&pool->sleepingCount, 1);
+      ticket = naGetAlarmTicket(pool->wakeAlarm);
+      task = na_FindTask(pool, worker);
+      if(task) {
+        na_AddTaskPoolInt(&pool->sleepingCount, -1);
+        na_RunTask(pool, task);
+      }else{
+        if(!na_LoadTaskPoolInt(&pool->stop))
+          naAwaitAlarmTicket(pool->wakeAlarm, ticket, 0);
+        na_AddTaskPoolInt(&pool->sleepingCount, -1);
+      }
+    }
+  }
+
+  // Triggers may be merged when nobody consumed them yet. Pass the stop
+  // signal on to make sure all workers wake up.
+  naTriggerAlarm(pool->wakeAlarm);
+
+  if(naIsRuntimeRunning())
+    naFlushRuntimeThreadCache();
+  na_CurrentTaskWorker = NA_NULL;
+}
+
+
+
+NA_DEF size_t naGetProcessorCount() {
+  #if NA_OS == NA_OS_WINDOWS
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (size_t)info.dwNumberOfProcessors;
+  #else
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return (count > 0) ? (size_t)count : 1;
+  #endif
+}
+
+
+
+NA_DEF NATaskPool* naAllocTaskPool(size_t workerCount) {
+  NATaskPool* pool = naAlloc(NATaskPool);
+  size_t i;
+
+  if(workerCount == 0)
+    workerCount = naGetProcessorCount();
+
+  pool->workerCount = workerCount;
+  pool->workers = naMalloc(workerCount * sizeof(NA_TaskWorker));
+  pool->sharedMutex = naMakeSpinMutex();
+  pool->sharedFirst = NA_NULL;
+  pool->sharedLast = NA_NULL;
+  pool->sharedCount = 0;
+  pool->allTasks.count = 0;
+  pool->sleepingCount = 0;
+  pool->wakeAlarm = naMakeAlarm();
+  pool->stop = 0;
+
+  for(i = 0; i < workerCount; ++i) {
+    NA_TaskWorker* worker = &pool->workers[i];
+    worker->pool = pool;
+    worker->index = i;
+    worker->randomState = (uint32)(i * 2654435761u + 1);
+    na_InitTaskDeque(&worker->deque);
+    worker->thread = naMakeThread("NATaskPool worker", na_RunTaskPoolWorker, worker);
+  }
+  for(i = 0; i < workerCount; ++i) {
+    naRunThread(pool->workers[i].thread);
+  }
+
+  return pool;
+}
+
+
+
+NA_DEF void naDeallocTaskPool(NATaskPool* pool) {
+  size_t i;
+  naAwaitTaskPool(pool);
+
+  na_StoreTaskPoolInt(&pool->stop, 1);
+  for(i = 0; i < pool->workerCount; ++i) {
+    naTriggerAlarm(pool->wakeAlarm);
+  }
+  for(i = 0; i < pool->workerCount; ++i) {
+    naAwaitThread(pool->workers[i].thread);
+    naClearThread(pool->workers[i].thread);
+    na_ClearTaskDeque(&pool->workers[i].deque);
+  }
+
+  naClearAlarm(pool->wakeAlarm);
+  naClearSpinMutex(pool->sharedMutex);
+  naFree(pool->workers);
+  naFree(pool);
+}
+
+
+
+NA_DEF size_t naGetTaskPoolWorkerCount(const NATaskPool* pool) {
+  return pool->workerCount;
+}
+
+
+
+NA_DEF void naSubmitGroupTask(
+  NATaskPool* pool,
+  NAWaitGroup* group,
+  NAMutator task,
+  void* arg)
+{
+  NA_TaskWorker* worker = na_CurrentTaskWorker;
+  NA_Task* newTask;
+
+  #if NA_DEBUG
+    if(!task)
+      naError("task is nullptr");
+  #endif
+
+  if(group)
+    na_AddTaskPoolInt(&group->count, 1);
+  na_AddTaskPoolInt(&pool->allTasks.count, 1);
+
+  newTask = naAlloc(NA_Task);
+  newTask->function = task;
+  newTask->arg = arg;
+  newTask->group = group;
+  newTask->next = NA_NULL;
+
+  if(worker && worker->pool == pool) {
+    na_PushTaskDeque(&worker->deque, newTask);
+  }else{
+    naLockSpinMutex(pool->sharedMutex);
+      if(pool->sharedLast) {
+        pool->sharedLast->next = newTask;
+      }else{
+        pool->sharedFirst = newTask;
+      }
+      pool->sharedLast = newTask;
+      na_AddTaskPoolInt(&pool->sharedCount, 1);
+    naUnlockSpinMutex(pool->sharedMutex);
+  }
+
+  na_TaskPoolFence();
+  if(na_LoadTaskPoolInt(&pool->sleepingCount) > 0)
+    naTriggerAlarm(pool->wakeAlarm);
+}
+
+
+
+NA_DEF void naSubmitTask(NATaskPool* pool, NAMutator task, void* arg) {
+  naSubmitGroupTask(pool, NA_NULL, task, arg);
+}
+
+
+
+NA_DEF NAWaitGroup* naAllocWaitGroup() {
+  NAWaitGroup* group = naAlloc(NAWaitGroup);
+  group->count = 0;
+  return group;
+}
+
+
+
+NA_DEF void naDeallocWaitGroup(NAWaitGroup* group) {
+  #if NA_DEBUG
+    if(na_LoadTaskPoolInt(&group->count) != 0)
+      naError("Wait group still has pending tasks.");
+  #endif
+  naFree(group);
+}
+
+
+
+NA_DEF void naAwaitWaitGroup(NATaskPool* pool, NAWaitGroup* group) {
+  NA_TaskWorker* worker = na_CurrentTaskWorker;
+  if(worker && worker->pool != pool)
+    worker = NA_NULL;
+
+  double waitTime = NA_TASK_AWAIT_MIN_INTERVAL;
+  while(na_LoadTaskPoolInt(&group->count) != 0) {
+    NA_Task* task = na_FindTask(pool, worker);
+    if(!task) {
+      // The remaining tasks are being executed by other workers. Sleep like
+      // an idle worker such that new tasks wake us up but check the group
+      // again after a timeout as completed tasks do not trigger anything.
+      int32 ticket;
+      na_AddTaskPoolInt(&pool->sleepingCount, 1);
+      ticket = naGetAlarmTicket(pool->wakeAlarm);
+      task = na_FindTask(pool, worker);
+      if(!task && na_LoadTaskPoolInt(&group->count) != 0) {
+        naAwaitAlarmTicket(pool->wakeAlarm, ticket, waitTime);
+        waitTime = naMin(waitTime * 2., NA_TASK_AWAIT_MAX_INTERVAL);
+      }
+      na_AddTaskPoolInt(&pool->sleepingCount, -1);
+    }
+    if(task) {
+      na_RunTask(pool, task);
+      waitTime = NA_TASK_AWAIT_MIN_INTERVAL;
+    }
+  }
+}
+
+
+
+NA_DEF void naAwaitTaskPool(NATaskPool* pool) {
+  naAwaitWaitGroup(pool, &pool->allTasks);
+}
+
+
+
+NA_DEF size_t naGetWaitGroupCount(const NAWaitGroup* group) {
+  return (size_t)na_LoadTaskPoolInt((int64*)&group->count);
+}
+
+
+
+NA_DEF size_t naGetCurrentTaskPoolWorkerIndex(const NATaskPool* pool) {
+  NA_TaskWorker* worker = na_CurrentTaskWorker;
+  if(worker && worker->pool == pool)
+    return worker->index;
+  return pool->workerCount;
+}
+
+
+
+NA_DEF NATaskPool* naGetDefaultTaskPool() {
+  NATaskPool* pool = na_LoadTaskPoolPtr(&na_DefaultTaskPool);
+  if(!pool) {
+    // Several threads may get here at once. Only one of them wins.
+    size_t processorCount = naGetProcessorCount();
+    NATaskPool* newPool = naAllocTaskPool(processorCount > 1 ? processorCount - 1 : 1);
+    if(na_CompareExchangeTaskPoolPtr((void**)&na_DefaultTaskPool, NA_NULL, newPool)) {
+      pool = newPool;
+    }else{
+      naDeallocTaskPool(newPool);
+      pool = na_LoadTaskPoolPtr(&na_DefaultTaskPool);
+    }
+  }
+  return pool;
+}
+
+
+
+NA_DEF void naStopDefaultTaskPool() {
+  NATaskPool* pool = na_LoadTaskPoolPtr(&na_DefaultTaskPool);
+  if(pool && na_CompareExchangeTaskPoolPtr((void**)&na_DefaultTaskPool, pool, NA_NULL))
+    naDeallocTaskPool(pool);
+}
+
+
+
+// Splits off the upper half of the range as a new task as long as it is
+// bigger than the grain size and processes the remaining lower part.
+NA_HDEF void na_RunParallelRange(void* arg) {
+  NA_ParallelRange* range = (NA_ParallelRange*)arg;
+  NA_ParallelLoop* loop = range->loop;
+  size_t begin = range->begin;
+  size_t end = range->end;
+  naFree(range);
+
+  while(end - begin > loop->grainSize) {
+    size_t middle = begin + (end - begin) / 2;
+    NA_ParallelRange* upper = naAlloc(NA_ParallelRange);
+    upper->loop = loop;
+    upper->begin = middle;
+    upper->end = end;
+    naSubmitGroupTask(loop->pool, loop->group, na_RunParallelRange, upper);
+    end = middle;
+  }
+
+  if(loop->forCallback) {
+    loop->forCallback(begin, end, loop->userData);
+  }else{
+    size_t index = naGetCurrentTaskPoolWorkerIndex(loop->pool);
+    if(index == loop->pool->workerCount && &na_CurrentTaskWorker != loop->owner) {
+      // This is neither a worker nor the calling thread but some other thread
+      // helping while awaiting its own tasks. All such threads share the last
+      // partial.
+      naLockMutex(loop->foreignMutex);
+        loop->reduceCallback(begin, end, loop->partials + (index + 1) * loop->partialStride, loop->userData);
+      naUnlockMutex(loop->foreignMutex);
+    }else{
+      loop->reduceCallback(begin, end, loop->partials + index * loop->partialStride, loop->userData);
+    }
+  }
+}
+
+
+
+NA_HDEF void na_RunParallelLoop(NA_ParallelLoop* loop, size_t begin, size_t end) {
+  NA_ParallelRange* range = naAlloc(NA_ParallelRange);
+  range->loop = loop;
+  range->begin = begin;
+  range->end = end;
+
+  loop->group = naAllocWaitGroup();
+  na_RunParallelRange(range);
+  naAwaitWaitGroup(loop->pool, loop->group);
+  naDeallocWaitGroup(loop->group);
+}
+
+
+
+NA_HDEF size_t na_GetParallelGrainSize(NATaskPool* pool, size_t count, size_t grainSize) {
+  if(grainSize == 0) {
+    size_t pieceCount = (naGetTaskPoolWorkerCount(pool) + 1) * NA_PARALLEL_PIECES_PER_THREAD;
+    grainSize = (count + pieceCount - 1) / pieceCount;
+  }
+  return grainSize;
+}
+
+
+
+NA_DEF void naParallelFor(
+  size_t begin,
+  size_t end,
+  size_t grainSize,
+  NAParallelForCallback callback,
+  void* userData)
+{
+  NA_ParallelLoop loop;
+
+  #if NA_DEBUG
+    if(!callback)
+      naCrash("callback is nullptr");
+    if(begin > end)
+      naError("begin is greater than end");
+  #endif
+  if(begin >= end)
+    return;
+  if(grainSize && end - begin <= grainSize) {
+    callback(begin, end, userData);
+    return;
+  }
+
+  loop.pool = naGetDefaultTaskPool();
+  loop.grainSize = na_GetParallelGrainSize(loop.pool, end - begin, grainSize);
+  loop.forCallback = callback;
+  loop.reduceCallback = NA_NULL;
+  loop.partials = NA_NULL;
+  loop.partialStride = 0;
+  loop.owner = NA_NULL;
+  loop.foreignMutex = NA_NULL;
+  loop.userData = userData;
+  na_RunParallelLoop(&loop, begin, end);
+}
+
+
+
+NA_DEF void naParallelReduce(
+  size_t begin,
+  size_t end,
+  size_t grainSize,
+  void* result,
+  size_t resultByteSize,
+  NAParallelReduceCallback callback,
+  NAParallelJoinCallback join,
+  void* userData)
+{
+  NA_ParallelLoop loop;
+  size_t threadCount;
+  size_t i;
+
+  #if NA_DEBUG
+    if(!callback)
+      naCrash("callback is nullptr");
+    if(!join)
+      naCrash("join is nullptr");
+    if(!result)
+      naCrash("result is nullptr");
+    if(begin > end)
+      naError("begin is greater than end");
+  #endif
+  if(begin >= end)
+    return;
+  if(grainSize && end - begin <= grainSize) {
+    // The result itself serves as the only partial.
+    callback(begin, end, result, userData);
+    return;
+  }
+
+  loop.pool = naGetDefaultTaskPool();
+  loop.grainSize = na_GetParallelGrainSize(loop.pool, end - begin, grainSize);
+  loop.forCallback = NA_NULL;
+  loop.reduceCallback = callback;
+  loop.partialStride = (resultByteSize + NA_CACHE_LINE_BYTESIZE - 1) & ~(size_t)(NA_CACHE_LINE_BYTESIZE - 1);
+  if(loop.partialStride == 0)
+    loop.partialStride = NA_CACHE_LINE_BYTESIZE;
+  loop.owner = &na_CurrentTaskWorker;
+  loop.foreignMutex = naMakeMutex();
+  naSetMutexName(loop.foreignMutex, "naParallelReduce foreign partial");
+  loop.userData = userData;
+
+  // One partial per worker, one for the calling thread and one for all other
+  // threads.
+  threadCount = naGetTaskPoolWorkerCount(loop.pool) + 2;
+  loop.partials = naMallocAligned(threadCount * loop.partialStride, NA_CACHE_LINE_BYTESIZE);
+  for(i = 0; i < threadCount; ++i) {
+    naCopyn(loop.partials + i * loop.partialStride, result, resultByteSize);
+  }
+
+  na_RunParallelLoop(&loop, begin, end);
+
+  for(i = 0; i < threadCount; ++i) {
+    join(result, loop.partials + i * loop.partialStride, userData);
+  }
+  naFreeAligned(loop.partials);
+  naClearMutex(loop.foreignMutex);
+}
+
+
+
+typedef struct NA_ArrayForeachContext NA_ArrayForeachContext;
+struct NA_ArrayForeachContext{
+  NAByte* ptr;
+  size_t typeSize;
+  NAAccessor accessor;
+  NAMutator mutator;
+};
+
+
+
+NA_HDEF void na_ForeachArrayRange(size_t begin, size_t end, void* userData) {
+  const NA_ArrayForeachContext* context = (const NA_ArrayForeachContext*)userData;
+  NAByte* ptr = context->ptr + begin * context->typeSize;
+  while(begin < end) {
+    if(context->accessor) {
+      context->accessor(ptr);
+    }else{
+      context->mutator(ptr);
+    }
+    ptr += context->typeSize;
+    begin++;
+  }
+}
+
+
+
+NA_HDEF void na_ForeachArraypRange(size_t begin, size_t end, void* userData) {
+  const NA_ArrayForeachContext* context = (const NA_ArrayForeachContext*)userData;
+  NAByte* ptr = context->ptr + begin * context->typeSize;
+  while(begin < end) {
+    if(context->accessor) {
+      context->accessor(*((const void**)ptr));
+    }else{
+      context->mutator(*((void**)ptr));
+    }
+    ptr += context->typeSize;
+    begin++;
+  }
+}
+
+
+
+NA_HDEF void na_ForeachArrayParallel(
+  NAArray* array,
+  NAAccessor accessor,
+  NAMutator mutator,
+  NAParallelForCallback callback)
+{
+  size_t count = naGetArrayCount(array);
+  if(!count)
+    return;
+
+  NA_ArrayForeachContext context;
+  context.ptr = (NAByte*)naGetArrayPointerMutable(array);
+  context.typeSize = naGetArrayTypeSize(array);
+  context.accessor = accessor;
+  context.mutator = mutator;
+  naParallelFor(0, count, 0, callback, &context);
+}
+
+
+
+NA_DEF void naForeachArrayConstParallel(NAArray* array, NAAccessor accessor) {
+  #if NA_DEBUG
+    if(!accessor)
+      naCrash("Accessor is nullptr");
+  #endif
+  na_ForeachArrayParallel(array, accessor, NA_NULL, na_ForeachArrayRange);
+}
+
+
+
+NA_DEF void naForeachArrayMutableParallel(NAArray* array, NAMutator mutator) {
+  #if NA_DEBUG
+    if(!mutator)
+      naCrash("Mutator is nullptr");
+  #endif
+  na_ForeachArrayParallel(array, NA_NULL, mutator, na_ForeachArrayRange);
+}
+
+
+
+NA_DEF void naForeachArraypConstParallel(NAArray* array, NAAccessor accessor) {
+  #if NA_DEBUG
+    if(!accessor)
+      naCrash("Accessor is nullptr");
+  #endif
+  na_ForeachArrayParallel(array, accessor, NA_NULL, na_ForeachArraypRange);
+}
+
+
+
+NA_DEF void naForeachArraypMutableParallel(NAArray* array, NAMutator mutator) {
+  #if NA_DEBUG
+    if(!mutator)
+      naCrash("Mutator is nullptr");
+  #endif
+  na_ForeachArrayParallel(array, NA_NULL, mutator, na_ForeachArraypRange);
+}
+
+
+
+// ///////////////////////////////////
+// Futures
+// ///////////////////////////////////
+
+NA_HDEF void na_RunFutureTask(void* arg) {
+  NAFuture* future = (NAFuture*)arg;
+  naFulfillFuture(future, future->callback(future->arg));
+}
+
+
+
+NA_DEF NAFuture* naAllocFuture() {
+  NAFuture* future = naAlloc(NAFuture);
+  future->pool = NA_NULL;
+  future->callback = NA_NULL;
+  future->arg = NA_NULL;
+  future->result = NA_NULL;
+  future->state = NA_FUTURE_PENDING;
+  future->refCount = 2;
+  future->alarm = naMakeAlarm();
+  return future;
+}
+
+
+
+// The fulfilling thread might still be about to trigger the alarm when the
+// owner deallocates the future. Therefore, whoever is last frees it.
+NA_HDEF void na_ReleaseFuture(NAFuture* future) {
+  if(na_AddTaskPoolInt(&future->refCount, -1) == 1) {
+    naClearAlarm(future->alarm);
+    naFree(future);
+  }
+}
+
+
+
+NA_DEF void naDeallocFuture(NAFuture* future) {
+  #if NA_DEBUG
+    if(!naIsFutureDone(future))
+      naError("Future has not been fulfilled yet.");
+  #endif
+  na_ReleaseFuture(future);
+}
+
+
+
+NA_DEF NAFuture* naSubmitFutureTask(NATaskPool* pool, NAFutureCallback task, void* arg) {
+  NAFuture* future = naAllocFuture();
+  #if NA_DEBUG
+    if(!task)
+      naError("task is nullptr");
+  #endif
+  future->pool = pool;
+  future->callback = task;
+  future->arg = arg;
+  naSubmitTask(pool, na_RunFutureTask, future);
+  return future;
+}
+
+
+
+NA_DEF void naFulfillFuture(NAFuture* future, void* result) {
+  #if NA_DEBUG
+    if(naIsFutureDone(future))
+      naError("Future has already been fulfilled.");
+  #endif
+  future->result = result;
+  na_StoreTaskPoolInt(&future->state, NA_FUTURE_DONE);
+  naTriggerAlarm(future->alarm);
+  na_ReleaseFuture(future);
+}
+
+
+
+NA_DEF NABool naAwaitFuture(NAFuture* future, double maxWaitTime) {
+  NA_TaskWorker* worker = na_CurrentTaskWorker;
+  int64 startTime;
+
+  #if NA_DEBUG
+    if(maxWaitTime < 0.)
+      naError("maxWaitTime is negative. Beware of the zero!");
+  #endif
+
+  if(naIsFutureDone(future))
+    return NA_TRUE;
+
+  // Workers must not block the pool while waiting for a task of it. They
+  // sleep until the future is fulfilled but look for new tasks after a
+  // timeout.
+  if(maxWaitTime == 0 && future->pool && worker && worker->pool == future->pool) {
+    double waitTime = NA_TASK_AWAIT_MIN_INTERVAL;
+    while(!naIsFutureDone(future)) {
+      NA_Task* task = na_FindTask(future->pool, worker);
+      if(task) {
+        na_RunTask(future->pool, task);
+        waitTime = NA_TASK_AWAIT_MIN_INTERVAL;
+      }else{
+        int32 ticket = naGetAlarmTicket(future->alarm);
+        if(!naIsFutureDone(future)) {
+          naAwaitAlarmTicket(future->alarm, ticket, waitTime);
+          waitTime = naMin(waitTime * 2., NA_TASK_AWAIT_MAX_INTERVAL);
+        }
+      }
+    }
+    naTriggerAlarm(future->alarm);
+    return NA_TRUE;
+  }
+
+  // Take a ticket before checking the future such that a trigger in between
+  // is not lost. The timeout is measured from the start as the alarm may
+  // also be triggered to pass on the wakeup call.
+  startTime = na_GetMonotonicTime();
+  while(1) {
+    double waitTime = 0.;
+    int32 ticket = naGetAlarmTicket(future->alarm);
+    if(naIsFutureDone(future))
+      break;
+    if(maxWaitTime != 0) {
+      waitTime = maxWaitTime - (double)(na_GetMonotonicTime() - startTime) * 1e-9;
+      if(waitTime <= 0.)
+        return NA_FALSE;
+    }
+    naAwaitAlarmTicket(future->alarm, ticket, waitTime);
+  }
+
+  // Pass the wakeup call on to other threads waiting.
+  naTriggerAlarm(future->alarm);
+  return NA_TRUE;
+}
+
+
+
+NA_DEF NABool naIsFutureDone(const NAFuture* future) {
+  return na_LoadTaskPoolInt((int64*)&future->state) != NA_FUTURE_PENDING;
+}
+
+
+
+NA_DEF void* naGetFutureResult(const NAFuture* future) {
+  #if NA_DEBUG
+    if(!naIsFutureDone(future))
+      naError("Future has not been fulfilled yet.");
+  #endif
+  return future->result;
+}
+
+
+
+// ///////////////////////////////////
+// Task graphs
+// ///////////////////////////////////
+
+NA_DEF NATaskGraph* naAllocTaskGraph(NATaskPool* pool) {
+  NATaskGraph* graph = naAlloc(NATaskGraph);
+  graph->pool = pool;
+  graph->group = naAllocWaitGroup();
+  graph->firstNode = NA_NULL;
+  graph->lastNode = NA_NULL;
+  graph->nodeCount = 0;
+  return graph;
+}
+
+
+
+NA_DEF void naDeallocTaskGraph(NATaskGraph* graph) {
+  NATaskNode* node = graph->firstNode;
+  #if NA_DEBUG
+    if(naGetWaitGroupCount(graph->group))
+      naError("Graph is still running.");
+  #endif
+  while(node) {
+    NATaskNode* nextNode = node->next;
+    NA_TaskEdge* edge = node->firstDependent;
+    while(edge) {
+      NA_TaskEdge* nextEdge = edge->next;
+      naFree(edge);
+      edge = nextEdge;
+    }
+    naFree(node);
+    node = nextNode;
+  }
+  naDeallocWaitGroup(graph->group);
+  naFree(graph);
+}
+
+
+
+NA_DEF NATaskNode* naAddTaskGraphNode(NATaskGraph* graph, NAMutator task, void* arg) {
+  NATaskNode* node = naAlloc(NATaskNode);
+  #if NA_DEBUG
+    if(!task)
+      naError("task is nullptr");
+    if(naGetWaitGroupCount(graph->group))
+      naError("Graph is running.");
+  #endif
+  node->graph = graph;
+  node->task = task;
+  node->arg = arg;
+  node->dependencyCount = 0;
+  node->pendingCount = 0;
+  node->firstDependent = NA_NULL;
+  node->next = NA_NULL;
+  if(graph->lastNode) {
+    graph->lastNode->next = node;
+  }else{
+    graph->firstNode = node;
+  }
+  graph->lastNode = node;
+  graph->nodeCount++;
+  return node;
+}
+
+
+
+NA_DEF void naAddTaskGraphDependency(NATaskNode* node, NATaskNode* dependency) {
+  NA_TaskEdge* edge = naAlloc(NA_TaskEdge);
+  #if NA_DEBUG
+    if(node->graph != dependency->graph)
+      naError("Nodes belong to different graphs.");
+    if(node == dependency)
+      naError("A node can not depend on itself.");
+    if(naGetWaitGroupCount(node->graph->group))
+      naError("Graph is running.");
+  #endif
+  edge->node = node;
+  edge->next = dependency->firstDependent;
+  dependency->firstDependent = edge;
+  node->dependencyCount++;
+}
+
+
+
+// Runs the task of the node and submits all dependents which have no other
+// pending dependencies left.
+NA_HDEF void na_RunTaskNode(void* arg) {
+  NATaskNode* node = (NATaskNode*)arg;
+  NATaskGraph* graph = node->graph;
+  NA_TaskEdge* edge;
+  node->task(node->arg);
+  for(edge = node->firstDependent; edge; edge = edge->next) {
+    if(na_AddTaskPoolInt(&edge->node->pendingCount, -1) == 1)
+      naSubmitGroupTask(graph->pool, graph->group, na_RunTaskNode, edge->node);
+  }
+}
+
+
+
+#if NA_DEBUG
+  // Returns whether all nodes of the graph can be reached when starting at
+  // the nodes without dependencies. If not, there is a cycle.
+  NA_HDEF NABool na_IsTaskGraphAcyclic(NATaskGraph* graph) {
+    NATaskNode** ready = naMalloc(graph->nodeCount * sizeof(NATaskNode*));
+    size_t readyCount = 0;
+    size_t doneCount = 0;
+    NATaskNode* node;
+    for(node = graph->firstNode; node; node = node->next) {
+      node->pendingCount = (int64)node->dependencyCount;
+      if(!node->dependencyCount)
+        ready[readyCount++] = node;
+    }
+    while(doneCount < readyCount) {
+      NA_TaskEdge* edge;
+      for(edge = ready[doneCount]->firstDependent; edge; edge = edge->next) {
+        if(--edge->node->pendingCount == 0)
+          ready[readyCount++] = edge->node;
+      }
+      doneCount++;
+    }
+    naFree(ready);
+    return doneCount == graph->nodeCount;
+  }
+#endif
+
+
+
+NA_DEF void naRunTaskGraph(NATaskGraph* graph) {
+  NATaskNode* node;
+  #if NA_DEBUG
+    if(naGetWaitGroupCount(graph->group))
+      naError("Graph is already running.");
+    if(!na_IsTaskGraphAcyclic(graph))
+      naError("Graph contains a cycle. Some tasks will never run.");
+  #endif
+
+  // All counters must be set before the first task may finish.
+  for(node = graph->firstNode; node; node = node->next) {
+    na_StoreTaskPoolInt(&node->pendingCount, (int64)node->dependencyCount);
+  }
+  for(node = graph->firstNode; node; node = node->next) {
+    if(!node->dependencyCount)
+      naSubmitGroupTask(graph->pool, graph->group, na_RunTaskNode, node);
+  }
+}
+
+
+
+NA_DEF void naAwaitTaskGraph(NATaskGraph* graph) {
+  naAwaitWaitGroup(graph->pool, graph->group);
+}
+
+
+
+// This is free and unencumbered software released into the public domain.
+
+// Anyone is free to copy, modify, publish, use, compile, sell, or
+// distribute this software, either in source code form or as a compiled
+// binary, for any purpose, commercial or non-commercial, and by any
+// means.
+
+// In jurisdictions that recognize copyright laws, the author or authors
+// of this software dedicate any and all copyright interest in the
+// software to the public domain. We make this dedication for the benefit
+// of the public at large and to the detriment of our heirs and
+// successors. We intend this dedication to be an overt act of
+// relinquishment in perpetuity of all present and future rights to this
+// software under copyright law.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+
+// For more information, please refer to <http://unlicense.org/>
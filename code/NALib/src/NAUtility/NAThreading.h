@@ -11,16 +11,19 @@
 // Threading, Sleeping
 //
 // Note that in NALib, on Windows, the native threading functions of WINAPI are
-// used. On Mac, Grand Central Dispatch (GCD) is used. In the future, there
-// might be implementations planned for posix- as well as for C11-Threads. But
-// so far, they are not implemented yet.
+// used. On Mac, Grand Central Dispatch (GCD) is used. On Linux, pthreads are
+// used for threads whereas mutexes and alarms are built directly on futexes.
+// Locking and unlocking an uncontended mutex there does not enter the kernel.
 
 // Threading works differently on many systems and many frameworks. The data
 // structures used are also completely different. Therefore, all datatypes here
 // are declared as void*.
 typedef void* NAThread;
 typedef void* NAMutex;
+typedef void* NARWLock;
+typedef void* NASpinMutex;
 typedef void* NAAlarm;
+typedef void* NAThreadLocal;
 
 
 
@@ -118,6 +121,118 @@ NA_IAPI NABool naTryMutex(NAMutex mutex);
 #endif
 
 
+// //////////////////////////////////
+// Mutex profiling
+//
+// When NA_MUTEX_PROFILING is set to 1 (see NAConfiguration.h), every NAMutex
+// keeps statistics about how it is used: How often it has been locked, how
+// often a thread had to wait because it was locked by someone else, how long
+// threads waited and how long the mutex has been held. This helps finding
+// out which mutex is the bottleneck when threads stall. Give the mutexes a
+// name to recognize them in the statistics.
+//
+// Without profiling, no statistics are collected and names are ignored.
+
+// The number of entries of the hold time histogram.
+#define NA_MUTEX_HOLD_HISTOGRAM_COUNT 20
+
+// The following struct is used to return the statistics of one mutex when
+// calling naGetMutexStats:
+// name            The name given with naSetMutexName or NA_NULL.
+// acquireCount    The number of times the mutex has been locked, either with
+//                 naLockMutex or with a successful naTryMutex.
+// contendedCount  The number of times naLockMutex found the mutex locked and
+//                 had to wait.
+// failedTryCount  The number of times naTryMutex found the mutex locked.
+// totalWaitTime   The sum of all waiting times in naLockMutex in seconds.
+// maxWaitTime     The longest waiting time in naLockMutex in seconds.
+// holdHistogram   Entry i counts how often the mutex has been held for less
+//                 than 2^i microseconds. Entry 0 therefore counts holds of
+//                 less than a microsecond. The last entry counts all holds
+//                 not fitting into the other ones.
+typedef struct NAMutexStats NAMutexStats;
+struct NAMutexStats{
+  const char* name;
+  size_t acquireCount;
+  size_t contendedCount;
+  size_t failedTryCount;
+  double totalWaitTime;
+  double maxWaitTime;
+  size_t holdHistogram[NA_MUTEX_HOLD_HISTOGRAM_COUNT];
+};
+
+// Sets the name of the mutex shown in the statistics. The name will NOT be
+// owned by the mutex and must stay valid as long as the mutex exists.
+NA_IAPI void naSetMutexName(NAMutex mutex, const char* name);
+
+// Fills stats with the statistics of up to maxCount existing mutexes and
+// returns the number of entries written. If stats is NA_NULL, the number
+// of existing mutexes is returned. The values of mutexes being used at the
+// same time may not be consistent with each other. Without profiling, this
+// function always returns 0. Use naWriteBufferMutexStats to write a report
+// into an NABuffer.
+NA_API size_t naGetMutexStats(NAMutexStats* stats, size_t maxCount);
+
+// Sets all counters of all existing mutexes to zero.
+NA_API void naResetMutexStats(void);
+
+
+
+// //////////////////////////////////
+// Reader-writer lock
+//
+// A reader-writer lock can be held by any number of readers at the same time
+// or by one single writer. Use it for data which is read by many threads
+// and only rarely modified. A plain mutex would serialize all the readers.
+//
+// Whether waiting writers are preferred over new readers depends on the
+// system. A thread must not lock the same lock twice, neither shared nor
+// exclusive, and a shared lock can not be upgraded to an exclusive one.
+
+// Create and clear a reader-writer lock.
+NA_IAPI NARWLock naMakeRWLock(void);
+NA_IAPI void naClearRWLock(NARWLock lock);
+
+// Locks and unlocks the lock for reading. Multiple threads can read at once.
+NA_IAPI void naLockRWLockShared(NARWLock lock);
+NA_IAPI void naUnlockRWLockShared(NARWLock lock);
+
+// Locks and unlocks the lock for writing. Waits until all readers are gone.
+NA_IAPI void naLockRWLockExclusive(NARWLock lock);
+NA_IAPI void naUnlockRWLockExclusive(NARWLock lock);
+
+// Tries to lock the lock but returns NA_FALSE immediately if not possible.
+NA_IAPI NABool naTryRWLockShared(NARWLock lock);
+NA_IAPI NABool naTryRWLockExclusive(NARWLock lock);
+
+
+
+// //////////////////////////////////
+// Spin mutex
+//
+// A spin mutex behaves like an NAMutex but a thread finding it locked polls
+// it for a while before going to sleep. This is faster for locks which are
+// only held for a few instructions, like pushing to a queue, as most of the
+// time, the lock is free again before the system could have woken up the
+// thread. The number of polls adapts to how long it took to get the lock the
+// last times and is limited by NA_SPIN_MUTEX_MAX_SPIN_COUNT.
+//
+// Do not hold a spin mutex for long or while waiting for something else.
+
+// Create and clear a spin mutex.
+NA_IAPI NASpinMutex naMakeSpinMutex(void);
+NA_IAPI void naClearSpinMutex(NASpinMutex mutex);
+
+// Locks and unlocks a spin mutex. Waiting threads wait forever.
+NA_IAPI void naLockSpinMutex(NASpinMutex mutex);
+NA_IAPI void naUnlockSpinMutex(NASpinMutex mutex);
+
+// Tries to lock the spin mutex but returns NA_FALSE immediately if not
+// possible.
+NA_IAPI NABool naTrySpinMutex(NASpinMutex mutex);
+
+
+
 // //////////////////////////////////
 // Alarm
 //
@@ -145,6 +260,56 @@ NA_IAPI NABool naAwaitAlarm(NAAlarm alarm, double maxWaitTime);
 // Sends a signal to anyone waiting on that NAAlarm structure.
 NA_IAPI void naTriggerAlarm(NAAlarm alarm);
 
+// If a thread needs to check some condition before going to sleep, a trigger
+// occuring between the check and naAwaitAlarm would get lost. To prevent
+// this, get a ticket before checking the condition and await the alarm with
+// that ticket: If the alarm has been triggered since the ticket has been
+// taken, naAwaitAlarmTicket returns immediately. Note that it may also return
+// due to a trigger before the ticket, so check the condition again.
+NA_IAPI int32 naGetAlarmTicket(NAAlarm alarm);
+NA_IAPI NABool naAwaitAlarmTicket(NAAlarm alarm, int32 ticket, double maxWaitTime);
+
+
+
+// //////////////////////////////////
+// Thread local storage
+//
+// A thread local is a pointer variable of which every thread has its own
+// copy. Use it for data belonging to one thread like caches or scratch
+// buffers, which would otherwise have to be passed through every call.
+//
+// For thread local variables known at compile time, NA_THREAD_LOCAL is
+// simpler and faster. Use the functions here when the variable is created
+// at runtime or when the data needs to be cleaned up when a thread ends.
+// On Windows, fiber local storage is used, otherwise the pthread keys.
+
+// Defined as 1 if thread locals support destructors, 0 otherwise.
+#if(NA_OS == NA_OS_WINDOWS) && (NA_ADDRESS_BITS != 64)
+  #define NA_THREAD_LOCAL_DESTRUCTORS 0
+#else
+  #define NA_THREAD_LOCAL_DESTRUCTORS 1
+#endif
+
+// Creates and clears a thread local. Initially, the value is NA_NULL in
+// every thread. When a thread ends, the destructor is called with the value
+// of that thread, if it is not NA_NULL. Note that the destructors are not
+// called for the main thread ending the process. The destructor can be
+// NA_NULL. The number of thread locals available is limited by the system,
+// expect around a hundred.
+//
+// Clear a thread local only when no other thread uses it anymore. Whether
+// clearing calls the destructor for the remaining values depends on the
+// system, so set the value of the current thread to NA_NULL before.
+//
+// On 32 bit Windows, destructors are not supported and must be NA_NULL. See
+// NA_THREAD_LOCAL_DESTRUCTORS above.
+NA_IAPI NAThreadLocal naMakeThreadLocal(NAMutator destructor);
+NA_IAPI void naClearThreadLocal(NAThreadLocal threadLocal);
+
+// Sets and gets the value of the current thread.
+NA_IAPI void naSetThreadLocal(NAThreadLocal threadLocal, void* value);
+NA_IAPI void* naGetThreadLocal(NAThreadLocal threadLocal);
+
 
 
 
@@ -7,6 +7,7 @@
 // Include this file to automatically include all APIs from the NAUtility
 // folder. You are free to include the files individually though.
 
+#include "NAArena.h"
 #include "NABinaryData.h"
 #include "NADateTime.h"
 #include "NAFile.h"
@@ -14,6 +15,7 @@
 #include "NAKey.h"
 #include "NAMemory.h"
 #include "NAString.h"
+#include "NATaskPool.h"
 #include "NAThreading.h"
 #include "NATranslator.h"
 #include "NAValueHelper.h"
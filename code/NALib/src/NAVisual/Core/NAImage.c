@@ -2,6 +2,7 @@
 #include "../NAColor.h"
 #include "../NAImage.h"
 #include "../../NAMath/NAVectorAlgebra.h"
+#include "../../NAUtility/NATaskPool.h"
 
 
 
@@ -20,6 +21,10 @@ NA_RUNTIME_TYPE(NAImage, na_DestroyImage, NA_TRUE);
   #error "Size of size_t is too small for the NAImage struct"
 #endif
 
+// The approximate number of pixels processed as one piece when an image
+// operation is distributed onto multiple threads.
+#define NA_IMAGE_PARALLEL_PIXEL_COUNT 16384
+
 
 
 // Simplified conversion from and to perceyved space uses the following
@@ -80,6 +85,13 @@ NA_HIDEF size_t na_GetImageDataSize(const NAImage* image) {
 
 
 
+// Returns the number of rows processed as one piece in parallel loops.
+NA_HIDEF size_t na_GetImageRowGrainSize(size_t width) {
+  return (width < NA_IMAGE_PARALLEL_PIXEL_COUNT) ? NA_IMAGE_PARALLEL_PIXEL_COUNT / width : 1;
+}
+
+
+
 NA_DEF NAColor* naGetImageData(const NAImage* image) {
 #if NA_DEBUG
   if(!image)
@@ -142,63 +154,65 @@ NA_HDEF NAImage* naCreateImageCopy(const NAImage* image) {
 
 
 
-NAImage* na_CreateBlendedImage(
-  const NAColor* base,
-  NASizes baseSize,
-  const NAColor* top,
-  NASizes topSize,
-  NABlendMode mode,
-  float factor,
-  NAPosi32 offset)
-{
-  NABool baseIsImage = !naIsSizesEmpty(baseSize);
-  NABool topIsImage = !naIsSizesEmpty(topSize);
-  
-  // First, define the return size and inner rect.
+NA_HDEF void na_ConvertImageRowsToRadiometric(size_t beginY, size_t endY, void* userData) {
+  NAImage* image = (NAImage*)userData;
+  NAColor* ptr = &image->data[beginY * image->width];
+  NAColor* endPtr = &image->data[endY * image->width];
+  while(ptr < endPtr) {
+    na_ConvertToRadiometricRGB(ptr, ptr);
+    ptr++;
+  }
+}
+
+
+
+NA_HDEF NAImage* na_CreateRadiometricImageCopy(const NAImage* image) {
+  NAImage* radioImage = naCreateImageCopy(image);
+  naParallelFor(
+    0,
+    radioImage->height,
+    na_GetImageRowGrainSize(radioImage->width),
+    na_ConvertImageRowsToRadiometric,
+    radioImage);
+  return radioImage;
+}
+
+
+
+typedef struct NA_BlendContext NA_BlendContext;
+struct NA_BlendContext{
+  NAColor* ret;
+  const NAColor* base;
+  const NAColor* top;
+  NASizes baseSize;
+  NASizes topSize;
   NASizei32 retSize;
   NARecti32 innerRect;
-  if(topIsImage && baseIsImage) {
-    retSize = naMakeSizei32((int32)baseSize.width, (int32)baseSize.height);
-    innerRect = naClampRecti32(naMakeRecti32(offset, naMakeSizei32((int32)topSize.width, (int32)topSize.height)), naMakeRecti32(naMakePosi32Zero(), retSize));
-    if(!naIsRecti32Useful(innerRect)) {
-      innerRect = naMakeRecti32Zero();
-    }
-  }else if(topIsImage) {
-    retSize = naMakeSizei32((int32)topSize.width, (int32)topSize.height);
-    innerRect = naMakeRecti32(naMakePosi32Zero(), retSize);
-  }else{
-    retSize = naMakeSizei32((int32)baseSize.width, (int32)baseSize.height);
-    innerRect = naMakeRecti32(naMakePosi32Zero(), retSize);
-  }
-  int32 innerEndY = naIsRecti32Empty(innerRect) ? 0 : naGetRecti32EndY(innerRect);
-  int32 innerEndX = naIsRecti32Empty(innerRect) ? 0 : naGetRecti32EndX(innerRect);
-  
-  // Create the actual image to be filled.
-  NAImage* retImage = naCreateImage(naMakeSizes((size_t)retSize.width, (size_t)retSize.height), NA_NULL);
-  NAColor* ret = naGetImageData(retImage);
-  
-  // In case we have two images, fill up the trivial vertical parts.
-  if(topIsImage && baseIsImage) {
-    // Simply copy the lower part of the base image
-    size_t basePixelCount = (size_t)innerRect.pos.y;
-    if(basePixelCount > 0) {
-      naCopyn(
-        ret,
-        base,
-        (size_t)basePixelCount * (size_t)retSize.width * sizeof(NAColor));
-    }
-    // Simply copy the upper part of the base image
-    int32 topPixelCount = naIsRecti32Empty(innerRect) ? (int32)baseSize.height : (int32)baseSize.height - innerEndY;
-    if(topPixelCount > 0) {
-      naCopyn(
-        &ret[(retSize.height - topPixelCount) * retSize.width],
-        &base[(baseSize.height - (size_t)topPixelCount) * baseSize.width],
-        (size_t)topPixelCount * (size_t)retSize.width * sizeof(NAColor));
-    }
-  }
-  
-  // Go through the inner part vertically.
-  for(int32 y = innerRect.pos.y; y < innerEndY; ++y) {
+  int32 innerEndX;
+  NAPosi32 offset;
+  NABlendMode mode;
+  float factor;
+  NABool baseIsImage;
+  NABool topIsImage;
+};
+
+
+
+NA_HDEF void na_BlendImageRows(size_t beginY, size_t endY, void* userData) {
+  const NA_BlendContext* context = (const NA_BlendContext*)userData;
+  NAColor* ret = context->ret;
+  const NAColor* base = context->base;
+  const NAColor* top = context->top;
+  NASizes baseSize = context->baseSize;
+  NASizes topSize = context->topSize;
+  NASizei32 retSize = context->retSize;
+  NARecti32 innerRect = context->innerRect;
+  int32 innerEndX = context->innerEndX;
+  NAPosi32 offset = context->offset;
+  NABool baseIsImage = context->baseIsImage;
+  NABool topIsImage = context->topIsImage;
+
+  for(int32 y = (int32)beginY; y < (int32)endY; ++y) {
     
     // In case we have two images, fill up the trivial horizontal parts.
     if(topIsImage && baseIsImage) {
@@ -254,12 +268,92 @@ NAImage* na_CreateBlendedImage(
       retPtr,
       basePtr,
       topPtr,
-      factor,
-      mode,
+      context->factor,
+      context->mode,
       (size_t)(innerEndX - innerRect.pos.x),
       baseIsImage,
       topIsImage);
   }
+}
+
+
+
+NAImage* na_CreateBlendedImage(
+  const NAColor* base,
+  NASizes baseSize,
+  const NAColor* top,
+  NASizes topSize,
+  NABlendMode mode,
+  float factor,
+  NAPosi32 offset)
+{
+  NABool baseIsImage = !naIsSizesEmpty(baseSize);
+  NABool topIsImage = !naIsSizesEmpty(topSize);
+  
+  // First, define the return size and inner rect.
+  NASizei32 retSize;
+  NARecti32 innerRect;
+  if(topIsImage && baseIsImage) {
+    retSize = naMakeSizei32((int32)baseSize.width, (int32)baseSize.height);
+    innerRect = naClampRecti32(naMakeRecti32(offset, naMakeSizei32((int32)topSize.width, (int32)topSize.height)), naMakeRecti32(naMakePosi32Zero(), retSize));
+    if(!naIsRecti32Useful(innerRect)) {
+      innerRect = naMakeRecti32Zero();
+    }
+  }else if(topIsImage) {
+    retSize = naMakeSizei32((int32)topSize.width, (int32)topSize.height);
+    innerRect = naMakeRecti32(naMakePosi32Zero(), retSize);
+  }else{
+    retSize = naMakeSizei32((int32)baseSize.width, (int32)baseSize.height);
+    innerRect = naMakeRecti32(naMakePosi32Zero(), retSize);
+  }
+  int32 innerEndY = naIsRecti32Empty(innerRect) ? 0 : naGetRecti32EndY(innerRect);
+  int32 innerEndX = naIsRecti32Empty(innerRect) ? 0 : naGetRecti32EndX(innerRect);
+  
+  // Create the actual image to be filled.
+  NAImage* retImage = naCreateImage(naMakeSizes((size_t)retSize.width, (size_t)retSize.height), NA_NULL);
+  NAColor* ret = naGetImageData(retImage);
+  
+  // In case we have two images, fill up the trivial vertical parts.
+  if(topIsImage && baseIsImage) {
+    // Simply copy the lower part of the base image
+    size_t basePixelCount = (size_t)innerRect.pos.y;
+    if(basePixelCount > 0) {
+      naCopyn(
+        ret,
+        base,
+        (size_t)basePixelCount * (size_t)retSize.width * sizeof(NAColor));
+    }
+    // Simply copy the upper part of the base image
+    int32 topPixelCount = naIsRecti32Empty(innerRect) ? (int32)baseSize.height : (int32)baseSize.height - innerEndY;
+    if(topPixelCount > 0) {
+      naCopyn(
+        &ret[(retSize.height - topPixelCount) * retSize.width],
+        &base[(baseSize.height - (size_t)topPixelCount) * baseSize.width],
+        (size_t)topPixelCount * (size_t)retSize.width * sizeof(NAColor));
+    }
+  }
+  
+  // Go through the inner part vertically.
+  NA_BlendContext context;
+  context.ret = ret;
+  context.base = base;
+  context.top = top;
+  context.baseSize = baseSize;
+  context.topSize = topSize;
+  context.retSize = retSize;
+  context.innerRect = innerRect;
+  context.innerEndX = innerEndX;
+  context.offset = offset;
+  context.mode = mode;
+  context.factor = factor;
+  context.baseIsImage = baseIsImage;
+  context.topIsImage = topIsImage;
+  naParallelFor(
+    (size_t)innerRect.pos.y,
+    (size_t)innerEndY,
+    na_GetImageRowGrainSize((size_t)retSize.width),
+    na_BlendImageRows,
+    &context);
   
   return retImage;
 }
@@ -337,42 +431,29 @@ NA_DEF NAImage* naCreateImageWithApply(const NAColor* ground, const NAImage* top
 
 
 
-NA_DEF NAImage* naCreateImageWithHalfSize(const NAImage* image) {
-  NASizes halfSize;
+typedef struct NA_HalfSizeContext NA_HalfSizeContext;
+struct NA_HalfSizeContext{
+  const NAImage* radioImage;
   NAImage* outImage;
-  NAColor* inPtr1;
-  NAColor* inPtr2;
-  NAColor* inPtr3;
-  NAColor* inPtr4;
+};
+
+
+
+NA_HDEF void na_HalfSizeImageRows(size_t beginY, size_t endY, void* userData) {
+  const NA_HalfSizeContext* context = (const NA_HalfSizeContext*)userData;
+  const NAImage* radioImage = context->radioImage;
+  const NAColor* inPtr1;
+  const NAColor* inPtr2;
+  const NAColor* inPtr3;
+  const NAColor* inPtr4;
   NAColor* outDataPtr;
-  
-#if NA_DEBUG
-  if((image->width % 2) || (image->height % 2))
-    naError("Width or height not divisible by 2");
-#endif
 
-  halfSize = naMakeSizes(image->width / 2, image->height / 2);
-  
-  outImage = naCreateImage(halfSize, NA_NULL);
-  
-  // Create radiometric copy of image.
-  NAImage* radioImage = naCreateImageCopy(image);
-  size_t pixelCount = na_GetImagePixelCount(radioImage);
-  NAColor* inPtr = image->data;
-  NAColor* radioPtr = radioImage->data;
-  for(size_t i = 0; i < pixelCount; ++i) {
-    naFillColorWithCopy(radioPtr, inPtr);
-    na_ConvertToRadiometricRGB(radioPtr, radioPtr);
-    radioPtr++;
-    inPtr++;
-  }
-  
-  inPtr1 = radioImage->data;
+  inPtr1 = radioImage->data + 2 * beginY * radioImage->width;
   inPtr2 = inPtr1 + 1;
-  inPtr3 = radioImage->data + radioImage->width;
+  inPtr3 = inPtr1 + radioImage->width;
   inPtr4 = inPtr3 + 1;
-  outDataPtr = outImage->data;
-  for(uint32 y = 0; y < radioImage->height; y += 2) {
+  outDataPtr = context->outImage->data + beginY * context->outImage->width;
+  for(size_t y = beginY; y < endY; ++y) {
     for(uint32 x = 0; x < radioImage->width; x += 2) {
       outDataPtr->r = inPtr1->r * inPtr1->alpha + inPtr2->r * inPtr2->alpha;
       outDataPtr->g = inPtr1->g * inPtr1->alpha + inPtr2->g * inPtr2->alpha;
@@ -408,6 +489,36 @@ NA_DEF NAImage* naCreateImageWithHalfSize(const NAImage* image) {
     inPtr3 += radioImage->width;
     inPtr4 += radioImage->width;
   }
+}
+
+
+
+NA_DEF NAImage* naCreateImageWithHalfSize(const NAImage* image) {
+  NASizes halfSize;
+  NAImage* outImage;
+  
+#if NA_DEBUG
+  if((image->width % 2) || (image->height % 2))
+    naError("Width or height not divisible by 2");
+#endif
+
+  halfSize = naMakeSizes(image->width / 2, image->height / 2);
+  
+  outImage = naCreateImage(halfSize, NA_NULL);
+  
+  // Create radiometric copy of image.
+  NAImage* radioImage = na_CreateRadiometricImageCopy(image);
+  
+  NA_HalfSizeContext context;
+  context.radioImage = radioImage;
+  context.outImage = outImage;
+  naParallelFor(
+    0,
+    halfSize.height,
+    na_GetImageRowGrainSize(halfSize.width),
+    na_HalfSizeImageRows,
+    &context);
+
   naRelease(radioImage);
   
   return outImage;
@@ -458,6 +569,51 @@ NA_HDEF void naAccumulateResizeLine(
 
 
 
+typedef struct NA_ResizeContext NA_ResizeContext;
+struct NA_ResizeContext{
+  const NAImage* radioImage;
+  NAImage* outImage;
+  const size_t* firstContributions;   // Index into the arrays below per row.
+  const size_t* contributionInY;
+  const float* contributionFactorY;
+  float divisor;
+};
+
+
+
+NA_HDEF void na_ResizeImageRows(size_t beginY, size_t endY, void* userData) {
+  const NA_ResizeContext* context = (const NA_ResizeContext*)userData;
+  NAImage* outImage = context->outImage;
+
+  for(size_t outY = beginY; outY < endY; ++outY) {
+    for(size_t i = context->firstContributions[outY]; i < context->firstContributions[outY + 1]; ++i) {
+      naAccumulateResizeLine(
+        outImage->data,
+        context->radioImage->data,
+        outY,
+        context->contributionInY[i],
+        outImage->width,
+        context->radioImage->width,
+        context->contributionFactorY[i]);
+    }
+
+    // Normalize the output row.
+    NAColor* outPtr = &outImage->data[outY * outImage->width];
+    for(size_t x = 0; x < outImage->width; x += 1) {
+      outPtr->r *= context->divisor;
+      outPtr->g *= context->divisor;
+      outPtr->b *= context->divisor;
+      outPtr->alpha *= context->divisor;
+
+      na_ConvertToPerceptualRGB(outPtr, outPtr);
+
+      outPtr += 1;
+    }
+  }
+}
+
+
+
 NA_DEF NAImage* naCreateImageWithResize(const NAImage* image, NASizes newSize) {
   NAImage* outImage;
   
@@ -470,65 +626,60 @@ NA_DEF NAImage* naCreateImageWithResize(const NAImage* image, NASizes newSize) {
   outImage = naCreateImage(newSize, &blank);
   
   // Create radiometric copy of image.
-  NAImage* radioImage = naCreateImageCopy(image);
-  size_t pixelCount = na_GetImagePixelCount(radioImage);
-  NAColor* inPtr = image->data;
-  NAColor* radioPtr = radioImage->data;
-  for(size_t i = 0; i < pixelCount; ++i) {
-    naFillColorWithCopy(radioPtr, inPtr);
-    na_ConvertToRadiometricRGB(radioPtr, radioPtr);
-    radioPtr++;
-    inPtr++;
-  }
+  NAImage* radioImage = na_CreateRadiometricImageCopy(image);
+
+  // Every input row contributes to at most two output rows. The following
+  // loop collects which input rows contribute by which factor to every
+  // output row such that the output rows can be computed independently.
+  size_t maxContributionCount = (size_t)image->height + newSize.height + 2;
+  size_t* firstContributions = naMalloc((newSize.height + 1) * sizeof(size_t));
+  size_t* contributionInY = naMalloc(maxContributionCount * sizeof(size_t));
+  float* contributionFactorY = naMalloc(maxContributionCount * sizeof(float));
+  size_t contributionCount = 0;
 
   size_t inY = 0;
   float subY = 0.f;
   float factorY = (float)image->height / (float)newSize.height;
   float remainerY = factorY;
   for(size_t outY = 0; outY < newSize.height; outY += 1) {
+    firstContributions[outY] = contributionCount;
     float counterSubY = 1.f - subY;
     while(counterSubY <= remainerY) {
-      naAccumulateResizeLine(
-        outImage->data,
-        radioImage->data,
-        outY,
-        inY,
-        newSize.width,
-        image->width,
-        counterSubY);
+      contributionInY[contributionCount] = inY;
+      contributionFactorY[contributionCount] = counterSubY;
+      contributionCount++;
       remainerY -= counterSubY;
       inY++;
       counterSubY = 1.f;
     }
     subY = 1.f - counterSubY;
     if(inY < (size_t)image->height) {
-      naAccumulateResizeLine(
-        outImage->data,
-        radioImage->data,
-        outY,
-        inY,
-        newSize.width,
-        image->width,
-        remainerY);
+      contributionInY[contributionCount] = inY;
+      contributionFactorY[contributionCount] = remainerY;
+      contributionCount++;
     }
     subY += remainerY;
     remainerY = (outY + 2) * factorY - (inY + subY);
   }
+  firstContributions[newSize.height] = contributionCount;
   
-  // Normalize the whole output image;
-  float divisor = (1.f / factorY) * (float)newSize.width / (float)image->width;
-  NAColor* outPtr = outImage->data;
-  for(size_t i = 0; i < (newSize.width * newSize.height); i += 1) {
-    outPtr->r *= divisor;
-    outPtr->g *= divisor;
-    outPtr->b *= divisor;
-    outPtr->alpha *= divisor;
-
-    na_ConvertToPerceptualRGB(outPtr, outPtr);
-
-    outPtr += 1;
-  }
+  NA_ResizeContext context;
+  context.radioImage = radioImage;
+  context.outImage = outImage;
+  context.firstContributions = firstContributions;
+  context.contributionInY = contributionInY;
+  context.contributionFactorY = contributionFactorY;
+  context.divisor = (1.f / factorY) * (float)newSize.width / (float)image->width;
+  naParallelFor(
+    0,
+    newSize.height,
+    na_GetImageRowGrainSize(newSize.width),
+    na_ResizeImageRows,
+    &context);
   
+  naFree(firstContributions);
+  naFree(contributionInY);
+  naFree(contributionFactorY);
   naRelease(radioImage);
   
   return outImage;
@@ -544,25 +695,32 @@ NA_HDEF void na_DestroyImage(NAImage* image) {
 
 #define NA_RGBA_COLOR_CHANNEL_COUNT 4
 
-NA_DEF void naFillImageWithu8(NAImage* image, const void* data, NABool topToBottom, NAColorBufferType bufferType) {
-  NAColor* imgPtr = image->data;
-  const uint8* u8Ptr;
-  
-  if(topToBottom) {
-    NASizes size = naGetImageSize(image);
-    for(size_t y = 0; y < size.height; y++) {
-      u8Ptr = &((uint8*)data)[(size.height - y - 1) * naGetImageSize(image).width * NA_RGBA_COLOR_CHANNEL_COUNT];
-      for(size_t x = 0; x < size.width; x++) {
-        naFillColorWithSRGBu8v(imgPtr, u8Ptr, bufferType);
-        imgPtr += 1;
-        u8Ptr += NA_RGBA_COLOR_CHANNEL_COUNT;
-      }
-    }
-  }else{
-    u8Ptr = data;
-    size_t pixelCount = na_GetImagePixelCount(image);
-    for(size_t i = 0; i < pixelCount; ++i) {
-      naFillColorWithSRGBu8v(imgPtr, u8Ptr, bufferType);
+typedef struct NA_Imageu8Context NA_Imageu8Context;
+struct NA_Imageu8Context{
+  NAImage* image;
+  void* data;
+  NABool topToBottom;
+  NAColorBufferType bufferType;
+};
+
+
+
+// Returns the pointer to the first byte of the u8 buffer row belonging to
+// the given image row.
+NA_HIDEF uint8* na_GetImageu8Row(const NA_Imageu8Context* context, size_t y) {
+  size_t u8Y = context->topToBottom ? context->image->height - y - 1 : y;
+  return &((uint8*)context->data)[u8Y * context->image->width * NA_RGBA_COLOR_CHANNEL_COUNT];
+}
+
+
+
+NA_HDEF void na_FillImageRowsWithu8(size_t beginY, size_t endY, void* userData) {
+  const NA_Imageu8Context* context = (const NA_Imageu8Context*)userData;
+  NAColor* imgPtr = &context->image->data[beginY * context->image->width];
+  for(size_t y = beginY; y < endY; y++) {
+    const uint8* u8Ptr = na_GetImageu8Row(context, y);
+    for(size_t x = 0; x < context->image->width; x++) {
+      naFillColorWithSRGBu8v(imgPtr, u8Ptr, context->bufferType);
       imgPtr += 1;
       u8Ptr += NA_RGBA_COLOR_CHANNEL_COUNT;
     }
@@ -571,27 +729,49 @@ NA_DEF void naFillImageWithu8(NAImage* image, const void* data, NABool topToBott
 
 
 
-NA_DEF void naConvertImageTou8(const NAImage* image, void* data, NABool topToBottom, NAColorBufferType bufferType) {
-  const NAColor* imgPtr = image->data;
-  uint8* u8Ptr;
-  
-  if(topToBottom) {
-    NASizes size = naGetImageSize(image);
-    for(size_t y = 0; y < size.height; y++) {
-      u8Ptr = &((uint8*)data)[(size.height - y - 1) * naGetImageSize(image).width * NA_RGBA_COLOR_CHANNEL_COUNT];
-      naFillSRGBu8WithColor(u8Ptr, imgPtr, bufferType, size.width);
-      imgPtr += size.width;
-      u8Ptr += size.width * NA_RGBA_COLOR_CHANNEL_COUNT;
-    }
-  }else{
-    u8Ptr = data;
-    size_t pixelCount = na_GetImagePixelCount(image);
-    naFillSRGBu8WithColor(u8Ptr, imgPtr, bufferType, pixelCount);
+NA_DEF void naFillImageWithu8(NAImage* image, const void* data, NABool topToBottom, NAColorBufferType bufferType) {
+  NA_Imageu8Context context;
+  context.image = image;
+  context.data = (void*)data;
+  context.topToBottom = topToBottom;
+  context.bufferType = bufferType;
+  naParallelFor(
+    0,
+    image->height,
+    na_GetImageRowGrainSize(image->width),
+    na_FillImageRowsWithu8,
+    &context);
+}
+
+
+
+NA_HDEF void na_ConvertImageRowsTou8(size_t beginY, size_t endY, void* userData) {
+  const NA_Imageu8Context* context = (const NA_Imageu8Context*)userData;
+  const NAColor* imgPtr = &context->image->data[beginY * context->image->width];
+  for(size_t y = beginY; y < endY; y++) {
+    naFillSRGBu8WithColor(na_GetImageu8Row(context, y), imgPtr, context->bufferType, context->image->width);
+    imgPtr += context->image->width;
   }
 }
 
 
 
+NA_DEF void naConvertImageTou8(const NAImage* image, void* data, NABool topToBottom, NAColorBufferType bufferType) {
+  NA_Imageu8Context context;
+  context.image = (NAImage*)image;
+  context.data = data;
+  context.topToBottom = topToBottom;
+  context.bufferType = bufferType;
+  naParallelFor(
+    0,
+    image->height,
+    na_GetImageRowGrainSize(image->width),
+    na_ConvertImageRowsTou8,
+    &context);
+}
+
+
+
 // This is free and unencumbered software released into the public domain.
 
 // Anyone is free to copy, modify, publish, use, compile, sell, or
@@ -11,9 +11,13 @@
 #define NA_PNG_FLAGS_IHDR_AVAILABLE       0x01
 #define NA_PNG_FLAGS_sRGB_AVAILABLE       0x02
 
+// The approximate number of pixels converted as one piece in parallel.
+#define NA_PNG_PARALLEL_PIXEL_COUNT 16384
+
 
 #include "../../NAStruct/NAList.h"
 #include "../../NAMath/NAVectorAlgebra.h"
+#include "../../NAUtility/NATaskPool.h"
 
 typedef enum{
   NA_PIXEL_UNIT_UNDEFINED,
@@ -824,27 +828,51 @@ NA_DEF size_t naGetPNGPixelDataByteSize(NAPNG* png) {
 
 
 
-NA_DEF NAImage* naCreateImageWithPNG(NAPNG* png) {
-  NAImage* image = naCreateImage(png->size, NA_NULL);
-  NAByte* pngPtr;
+typedef struct NA_PNGImageContext NA_PNGImageContext;
+struct NA_PNGImageContext{
+  NAPNG* png;
+  NAImage* image;
+};
+
+
+
+NA_HDEF void na_FillImageRowsWithPNGTruecolor(size_t beginY, size_t endY, void* userData) {
+  const NA_PNGImageContext* context = (const NA_PNGImageContext*)userData;
+  NAPNG* png = context->png;
+  const NAByte* pngPtr = &png->pixelData[beginY * png->size.width * 3];
   NAColor* colorPtr;
   uint8 inBuf[4];
 
+  inBuf[3] = 255;
+  for(size_t y = beginY; y < endY; y++) {
+    colorPtr = &(naGetImageData(context->image)[(png->size.height - y - 1) * png->size.width]);
+    for(size_t x = 0; x < png->size.width; x++) {
+      inBuf[0] = pngPtr[0];
+      inBuf[1] = pngPtr[1];
+      inBuf[2] = pngPtr[2];
+      naFillColorWithSRGBu8v(colorPtr, inBuf, NA_COLOR_BUFFER_RGB);
+      colorPtr += 1;
+      pngPtr += 3;
+    }
+  }
+}
+
+
+
+NA_DEF NAImage* naCreateImageWithPNG(NAPNG* png) {
+  NAImage* image = naCreateImage(png->size, NA_NULL);
+  NA_PNGImageContext context;
+
   switch(png->colorType) {
   case NA_PNG_COLORTYPE_TRUECOLOR:
-    pngPtr = png->pixelData;
-    inBuf[3] = 255;
-    for(size_t y = 0; y < png->size.height; y++) {
-      colorPtr = &(naGetImageData(image)[(png->size.height - y - 1) * naGetImageSize(image).width]);
-      for(size_t x = 0; x < png->size.width; x++) {
-        inBuf[0] = pngPtr[0];
-        inBuf[1] = pngPtr[1];
-        inBuf[2] = pngPtr[2];
-        naFillColorWithSRGBu8v(colorPtr, inBuf, NA_COLOR_BUFFER_RGB);
-        colorPtr += 1;
-        pngPtr += 3;
-      }
-    }
+    context.png = png;
+    context.image = image;
+    naParallelFor(
+      0,
+      png->size.height,
+      (png->size.width < NA_PNG_PARALLEL_PIXEL_COUNT) ? NA_PNG_PARALLEL_PIXEL_COUNT / png->size.width : 1,
+      na_FillImageRowsWithPNGTruecolor,
+      &context);
     break;
   case NA_PNG_COLORTYPE_TRUECOLOR_ALPHA:
     naFillImageWithu8(image, png->pixelData, NA_TRUE, NA_COLOR_BUFFER_RGBA);
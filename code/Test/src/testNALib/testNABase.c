@@ -27,6 +27,7 @@ void testNADebugging(void);
 void testNAPointerArithmetics(void);
 void testNANumerics(void);
 void testNAFloatingPoint(void);
+void testNAAtomic(void);
 
 void benchmarkNAInt64(void);
 void benchmarkNAInt128(void);
@@ -59,6 +60,7 @@ void testNABase(void) {
   naTestFunction(testNAPointerArithmetics);
   naTestFunction(testNANumerics);
   naTestFunction(testNAFloatingPoint);
+  naTestFunction(testNAAtomic);
 }
 
 void benchmarkNABase(void) {
@@ -0,0 +1,76 @@
+
+#include "NATest.h"
+#include <stdio.h>
+
+
+
+void testNAAtomic(void) {
+  naTestGroup("32 bit") {
+    int32 value = 0;
+    int32 expected = 5;
+    naAtomicStorei32(&value, 3, NA_MEMORY_ORDER_RELEASE);
+    naTest(naAtomicLoadi32(&value, NA_MEMORY_ORDER_ACQUIRE) == 3);
+    naTest(naAtomicAddi32(&value, 4, NA_MEMORY_ORDER_SEQ_CST) == 3);
+    naTest(naAtomicExchangei32(&value, 9, NA_MEMORY_ORDER_ACQ_REL) == 7);
+    naTest(!naAtomicCompareExchangei32(&value, &expected, 1, NA_MEMORY_ORDER_SEQ_CST));
+    naTest(expected == 9);
+    naTest(naAtomicCompareExchangei32(&value, &expected, 1, NA_MEMORY_ORDER_SEQ_CST));
+    naTest(value == 1);
+  }
+
+  #if NA_NATIVE_INT64_IN_USE
+    naTestGroup("64 bit") {
+      int64 value = 0;
+      int64 expected = 0;
+      naAtomicStorei64(&value, 0x100000000LL, NA_MEMORY_ORDER_RELAXED);
+      naTest(naAtomicLoadi64(&value, NA_MEMORY_ORDER_RELAXED) == 0x100000000LL);
+      naTest(naAtomicAddi64(&value, -1, NA_MEMORY_ORDER_RELAXED) == 0x100000000LL);
+      naTest(naAtomicExchangei64(&value, 2, NA_MEMORY_ORDER_RELAXED) == 0xffffffffLL);
+      naTest(!naAtomicCompareExchangei64(&value, &expected, 3, NA_MEMORY_ORDER_SEQ_CST));
+      naTest(expected == 2);
+      naTest(naAtomicCompareExchangei64(&value, &expected, 3, NA_MEMORY_ORDER_SEQ_CST));
+      naTest(value == 3);
+    }
+  #endif
+
+  naTestGroup("Pointer") {
+    int32 a = 0;
+    int32 b = 0;
+    void* ptr = NA_NULL;
+    void* expected = &b;
+    naAtomicStorePtr(&ptr, &a, NA_MEMORY_ORDER_RELEASE);
+    naTest(naAtomicLoadPtr(&ptr, NA_MEMORY_ORDER_ACQUIRE) == &a);
+    naTest(!naAtomicCompareExchangePtr(&ptr, &expected, &b, NA_MEMORY_ORDER_SEQ_CST));
+    naTest(expected == &a);
+    naTest(naAtomicCompareExchangePtr(&ptr, &expected, &b, NA_MEMORY_ORDER_SEQ_CST));
+    naTest(naAtomicExchangePtr(&ptr, NA_NULL, NA_MEMORY_ORDER_SEQ_CST) == &b);
+    naTest(ptr == NA_NULL);
+  }
+}
+
+
+
+// This is free and unencumbered software released into the public domain.
+
+// Anyone is free to copy, modify, publish, use, compile, sell, or
+// distribute this software, either in source code form or as a compiled
+// binary, for any purpose, commercial or non-commercial, and by any
+// means.
+
+// In jurisdictions that recognize copyright laws, the author or authors
+// of this software dedicate any and all copyright interest in the
+// software to the public domain. We make this dedication for the benefit
+// of the public at large and to the detriment of our heirs and
+// successors. We intend this dedication to be an overt act of
+// relinquishment in perpetuity of all present and future rights to this
+// software under copyright law.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+
+// For more information, please refer to <http://unlicense.org/>
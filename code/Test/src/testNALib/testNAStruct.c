@@ -10,12 +10,20 @@ void printNAHeap(void);
 void printNAStack(void);
 void printNATree(void);
 
+void testNAArray(void);
 void testNABuffer(void);
+void testNACircularBuffer(void);
 void testNAHeap(void);
+void testNAList(void);
+void testNAMPSCQueue(void);
 void testNAStack(void);
 void testNATree(void);
+void testNAVector(void);
 
+void benchmarkNAArray(void);
+void benchmarkNAList(void);
 void benchmarkNAStack(void);
+void benchmarkNAVector(void);
 
 void printNAStruct(void) {
   printNABuffer();
@@ -25,14 +33,22 @@ void printNAStruct(void) {
 }
 
 void testNAStruct(void) {
+  naTestFunction(testNAArray);
   naTestFunction(testNABuffer);
+  naTestFunction(testNACircularBuffer);
   naTestFunction(testNAHeap);
+  naTestFunction(testNAList);
+  naTestFunction(testNAMPSCQueue);
   naTestFunction(testNAStack);
   naTestFunction(testNATree);
+  naTestFunction(testNAVector);
 }
 
 void benchmarkNAStruct(void) {
+  benchmarkNAArray();
+  benchmarkNAList();
   benchmarkNAStack();
+  benchmarkNAVector();
 }
 
 // This is free and unencumbered software released into the public domain.
@@ -0,0 +1,199 @@
+#include "NATest.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "NAStruct/NAArray.h"
+
+#define NA_TEST_ARRAY_SORT_COUNT 5000
+#define NA_BENCHMARK_ARRAY_SORT_COUNT 100000
+
+// A simple linear congruential generator such that the tests are
+// reproducible.
+uint64 test_NextArraySortValue(uint64* state) {
+  *state = *state * 6364136223846793005u + 1442695040888963407u;
+  return *state;
+}
+
+int test_CompareArrayi32(const void* a, const void* b) {
+  return (*(const int32*)a > *(const int32*)b) - (*(const int32*)a < *(const int32*)b);
+}
+int test_CompareArrayu64(const void* a, const void* b) {
+  return (*(const uint64*)a > *(const uint64*)b) - (*(const uint64*)a < *(const uint64*)b);
+}
+int test_CompareArrayd(const void* a, const void* b) {
+  return (*(const double*)a > *(const double*)b) - (*(const double*)a < *(const double*)b);
+}
+
+// Sorts the given values with naSortArray as well as with qsort and returns
+// whether the results are equal.
+#define NA_TEST_SORT_ARRAY(type, suffix, compare, values, count)\
+  NAArray array;\
+  type* expected = malloc(count * sizeof(type));\
+  memcpy(expected, values, count * sizeof(type));\
+  qsort(expected, count, sizeof(type), compare);\
+  naInitArrayWithDataMutable(&array, values, sizeof(type), count, NA_NULL);\
+  NA_CONCAT2(naSortArray, suffix)(&array);\
+  NABool equal = count == 0 || memcmp(expected, values, count * sizeof(type)) == 0;\
+  naClearArray(&array);\
+  free(expected);
+
+NABool test_SortArrayi32(size_t count, uint64 seed) {
+  int32* values = malloc(count * sizeof(int32));
+  for(size_t i = 0; i < count; ++i) {
+    values[i] = (int32)test_NextArraySortValue(&seed);
+  }
+  NA_TEST_SORT_ARRAY(int32, i32, test_CompareArrayi32, values, count)
+  free(values);
+  return equal;
+}
+
+NABool test_SortArrayu64(size_t count, uint64 seed) {
+  // Values lying close together like timestamps: Most digits are equal.
+  uint64* values = malloc(count * sizeof(uint64));
+  for(size_t i = 0; i < count; ++i) {
+    values[i] = 1700000000000u + test_NextArraySortValue(&seed) % 100000u;
+  }
+  NA_TEST_SORT_ARRAY(uint64, u64, test_CompareArrayu64, values, count)
+  free(values);
+  return equal;
+}
+
+NABool test_SortArrayd(size_t count, uint64 seed) {
+  double* values = malloc(count * sizeof(double));
+  for(size_t i = 0; i < count; ++i) {
+    values[i] = (double)(int64)test_NextArraySortValue(&seed) / 1e9;
+  }
+  NA_TEST_SORT_ARRAY(double, d, test_CompareArrayd, values, count)
+  free(values);
+  return equal;
+}
+
+void testArraySort() {
+  size_t counts[] = {0, 1, 2, 7, 8, 9, 100, 256, 257, NA_TEST_ARRAY_SORT_COUNT};
+
+  naTestGroup("Integers") {
+    for(size_t i = 0; i < sizeof(counts) / sizeof(counts[0]); ++i) {
+      naTest(test_SortArrayi32(counts[i], i));
+      naTest(test_SortArrayu64(counts[i], i));
+    }
+  }
+
+  naTestGroup("Floating point") {
+    for(size_t i = 0; i < sizeof(counts) / sizeof(counts[0]); ++i) {
+      naTest(test_SortArrayd(counts[i], i));
+    }
+    float values[6] = {1.f, -0.f, -NA_INFINITYf, 0.f, -2.f, NA_INFINITYf};
+    NAArray array;
+    naInitArrayWithDataMutable(&array, values, sizeof(float), 6, NA_NULL);
+    naSortArrayf(&array);
+    naTest(values[0] == -NA_INFINITYf && values[1] == -2.f && values[4] == 1.f && values[5] == NA_INFINITYf);
+    naTest(signbit(values[2]) && !signbit(values[3]));
+    naClearArray(&array);
+  }
+
+  naTestGroup("Wrong type size") {
+    int32 values[2] = {1, 0};
+    NAArray array;
+    naInitArrayWithDataMutable(&array, values, sizeof(int32), 2, NA_NULL);
+    naTestError(naSortArrayd(&array));
+    naClearArray(&array);
+  }
+}
+
+void testArraySortIndices() {
+  naTestGroup("Stable order of equal keys") {
+    uint64 seed = 0;
+    NAArray array;
+    uint32* keys = naMalloc(NA_TEST_ARRAY_SORT_COUNT * sizeof(uint32));
+    uint32* original = naMalloc(NA_TEST_ARRAY_SORT_COUNT * sizeof(uint32));
+    size_t* indices = naMalloc(NA_TEST_ARRAY_SORT_COUNT * sizeof(size_t));
+    for(size_t i = 0; i < NA_TEST_ARRAY_SORT_COUNT; ++i) {
+      keys[i] = (uint32)(test_NextArraySortValue(&seed) % 100);
+    }
+    naCopyn(original, keys, NA_TEST_ARRAY_SORT_COUNT * sizeof(uint32));
+
+    // Once with insertion sort, once with radix sort.
+    for(size_t count = 10; count <= NA_TEST_ARRAY_SORT_COUNT; count *= 500) {
+      NABool stable = NA_TRUE;
+      naInitArrayWithDataConst(&array, keys, sizeof(uint32), count);
+      naSortArrayIndicesu32(&array, indices);
+      for(size_t i = 1; i < count; ++i) {
+        if(keys[indices[i - 1]] > keys[indices[i]]) { stable = NA_FALSE; }
+        if(keys[indices[i - 1]] == keys[indices[i]] && indices[i - 1] > indices[i]) { stable = NA_FALSE; }
+      }
+      naTest(stable);
+      naClearArray(&array);
+    }
+    naTest(memcmp(keys, original, NA_TEST_ARRAY_SORT_COUNT * sizeof(uint32)) == 0);
+    naFree(keys);
+    naFree(original);
+    naFree(indices);
+  }
+
+  naTestGroup("Signed and floating point keys") {
+    int64 keys[5] = {3, -1, 0, -5, 2};
+    double dkeys[4] = {0.5, -0.5, -1.5, 1.5};
+    size_t indices[5];
+    NAArray array;
+    naInitArrayWithDataConst(&array, keys, sizeof(int64), 5);
+    naSortArrayIndicesi64(&array, indices);
+    naTest(indices[0] == 3 && indices[1] == 1 && indices[2] == 2 && indices[3] == 4 && indices[4] == 0);
+    naClearArray(&array);
+    naInitArrayWithDataConst(&array, dkeys, sizeof(double), 4);
+    naSortArrayIndicesd(&array, indices);
+    naTest(indices[0] == 2 && indices[1] == 1 && indices[2] == 0 && indices[3] == 3);
+    naClearArray(&array);
+  }
+}
+
+void testNAArray(void) {
+  naTestFunction(testArraySort);
+  naTestFunction(testArraySortIndices);
+}
+
+void benchmarkNAArray(void) {
+  uint64 seed = 0;
+  NAArray array;
+  double* values = naMalloc(NA_BENCHMARK_ARRAY_SORT_COUNT * sizeof(double));
+  size_t* indices = naMalloc(NA_BENCHMARK_ARRAY_SORT_COUNT * sizeof(size_t));
+  for(size_t i = 0; i < NA_BENCHMARK_ARRAY_SORT_COUNT; ++i) {
+    values[i] = (double)(int64)test_NextArraySortValue(&seed);
+  }
+  naInitArrayWithDataMutable(&array, values, sizeof(double), NA_BENCHMARK_ARRAY_SORT_COUNT, NA_NULL);
+
+  naBenchmark(naSortArrayIndicesd(&array, indices));
+  naBenchmark(naSortArrayd(&array));
+
+  naClearArray(&array);
+  naFree(values);
+  naFree(indices);
+}
+
+
+
+// This is free and unencumbered software released into the public domain.
+
+// Anyone is free to copy, modify, publish, use, compile, sell, or
+// distribute this software, either in source code form or as a compiled
+// binary, for any purpose, commercial or non-commercial, and by any
+// means.
+
+// In jurisdictions that recognize copyright laws, the author or authors
+// of this software dedicate any and all copyright interest in the
+// software to the public domain. We make this dedication for the benefit
+// of the public at large and to the detriment of our heirs and
+// successors. We intend this dedication to be an overt act of
+// relinquishment in perpetuity of all present and future rights to this
+// software under copyright law.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+
+// For more information, please refer to <http://unlicense.org/>
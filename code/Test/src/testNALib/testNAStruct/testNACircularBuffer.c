@@ -0,0 +1,160 @@
+#include "NATest.h"
+#include <stdio.h>
+
+#include "NAStruct/NACircularBuffer.h"
+#include "NAUtility/NAThreading.h"
+
+#define NA_TEST_CIRCULAR_BUFFER_ELEMENT_COUNT 10000
+
+typedef struct TestCircularBufferProducer TestCircularBufferProducer;
+struct TestCircularBufferProducer{
+  NACircularBuffer* buffer;
+  size_t start;
+};
+
+void test_ProduceCircularBufferValues(void* arg) {
+  TestCircularBufferProducer* producer = (TestCircularBufferProducer*)arg;
+  for(size_t i = 1; i <= NA_TEST_CIRCULAR_BUFFER_ELEMENT_COUNT; ++i) {
+    while(!naTryPushCircularBuffer(producer->buffer, (void*)(producer->start + i))) {
+      naAtomicPause();
+    }
+  }
+}
+
+typedef struct TestCircularBufferConsumer TestCircularBufferConsumer;
+struct TestCircularBufferConsumer{
+  NACircularBuffer* buffer;
+  size_t count;
+  size_t sum;
+};
+
+// Pulls exactly count values, never more, such that multiple consumers can
+// share the elements.
+size_t test_ConsumeCircularBufferValues(NACircularBuffer* buffer, size_t count) {
+  size_t sum = 0;
+  size_t received = 0;
+  void* values[7];
+  while(received < count) {
+    size_t maxCount = count - received < 7 ? count - received : 7;
+    size_t pulled = naPullCircularBufferN(buffer, values, maxCount);
+    for(size_t i = 0; i < pulled; ++i) {
+      sum += (size_t)values[i];
+    }
+    received += pulled;
+  }
+  return sum;
+}
+
+void test_ConsumeCircularBufferValuesThread(void* arg) {
+  TestCircularBufferConsumer* consumer = (TestCircularBufferConsumer*)arg;
+  consumer->sum = test_ConsumeCircularBufferValues(consumer->buffer, consumer->count);
+}
+
+void testCircularBufferSerial() {
+  naTestGroup("Serial push and pull") {
+    NACircularBuffer buffer;
+    naInitCircularBuffer(&buffer, 5);
+    naTest(naGetCircularBufferCapacity(&buffer) == 8);
+    for(size_t i = 1; i <= 8; ++i) {
+      naPushCircularBuffer(&buffer, (void*)i);
+    }
+    naTest(naGetCircularBufferCount(&buffer) == 8);
+    naTest(!naTryPushCircularBuffer(&buffer, NA_NULL));
+    naTestError(naPushCircularBuffer(&buffer, NA_NULL));
+    naTest(naPullCircularBuffer(&buffer) == (void*)1);
+    naTest(naPullCircularBuffer(&buffer) == (void*)2);
+    naTest(naGetCircularBufferCount(&buffer) == 6);
+    naClearCircularBuffer(&buffer);
+  }
+
+  naTestGroup("Serial batches") {
+    NACircularBuffer buffer;
+    void* values[6] = {(void*)1, (void*)2, (void*)3, (void*)4, (void*)5, (void*)6};
+    void* result[6];
+    naInitCircularBuffer(&buffer, 4);
+    naTest(naPushCircularBufferN(&buffer, values, 3) == 3);
+    naTest(naPullCircularBufferN(&buffer, result, 2) == 2);
+    naTest(result[0] == (void*)1 && result[1] == (void*)2);
+    naTest(naPushCircularBufferN(&buffer, values, 6) == 3);
+    naTest(naPullCircularBufferN(&buffer, result, 6) == 4);
+    naTest(result[0] == (void*)3 && result[3] == (void*)3);
+    naTest(naPullCircularBufferN(&buffer, result, 6) == 0);
+    naTestError(naPullCircularBuffer(&buffer));
+    naClearCircularBuffer(&buffer);
+  }
+}
+
+void testCircularBufferThreaded() {
+  size_t expectedSum = (size_t)NA_TEST_CIRCULAR_BUFFER_ELEMENT_COUNT * (NA_TEST_CIRCULAR_BUFFER_ELEMENT_COUNT + 1) / 2;
+
+  naTestGroup("Single producer, single consumer") {
+    NACircularBuffer buffer;
+    naInitCircularBufferWithMode(&buffer, 64, NA_CIRCULAR_BUFFER_SPSC);
+    TestCircularBufferProducer producer = {&buffer, 0};
+    NAThread thread = naMakeThread("Producer", test_ProduceCircularBufferValues, &producer);
+    naRunThread(thread);
+    naTest(test_ConsumeCircularBufferValues(&buffer, NA_TEST_CIRCULAR_BUFFER_ELEMENT_COUNT) == expectedSum);
+    naAwaitThread(thread);
+    naClearThread(thread);
+    naTest(naGetCircularBufferCount(&buffer) == 0);
+    naClearCircularBuffer(&buffer);
+  }
+
+  naTestGroup("Multiple producers, multiple consumers") {
+    // The producers push distinct values, together 1 to 2 * count. Each of
+    // the consumers pulls half of them.
+    size_t count = NA_TEST_CIRCULAR_BUFFER_ELEMENT_COUNT;
+    NACircularBuffer buffer;
+    naInitCircularBufferWithMode(&buffer, 64, NA_CIRCULAR_BUFFER_MPMC);
+    TestCircularBufferProducer producers[2] = {{&buffer, 0}, {&buffer, count}};
+    TestCircularBufferConsumer consumers[2] = {{&buffer, count, 0}, {&buffer, count, 0}};
+    NAThread threads[4];
+    for(size_t i = 0; i < 2; ++i) {
+      threads[i] = naMakeThread("Consumer", test_ConsumeCircularBufferValuesThread, &consumers[i]);
+      naRunThread(threads[i]);
+    }
+    for(size_t i = 0; i < 2; ++i) {
+      threads[2 + i] = naMakeThread("Producer", test_ProduceCircularBufferValues, &producers[i]);
+      naRunThread(threads[2 + i]);
+    }
+    for(size_t i = 0; i < 4; ++i) {
+      naAwaitThread(threads[i]);
+      naClearThread(threads[i]);
+    }
+    naTest(consumers[0].sum + consumers[1].sum == count * (2 * count + 1));
+    naTest(naGetCircularBufferCount(&buffer) == 0);
+    naClearCircularBuffer(&buffer);
+  }
+}
+
+void testNACircularBuffer(void) {
+  naTestFunction(testCircularBufferSerial);
+  naTestFunction(testCircularBufferThreaded);
+}
+
+
+
+// This is free and unencumbered software released into the public domain.
+
+// Anyone is free to copy, modify, publish, use, compile, sell, or
+// distribute this software, either in source code form or as a compiled
+// binary, for any purpose, commercial or non-commercial, and by any
+// means.
+
+// In jurisdictions that recognize copyright laws, the author or authors
+// of this software dedicate any and all copyright interest in the
+// software to the public domain. We make this dedication for the benefit
+// of the public at large and to the detriment of our heirs and
+// successors. We intend this dedication to be an overt act of
+// relinquishment in perpetuity of all present and future rights to this
+// software under copyright law.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+
+// For more information, please refer to <http://unlicense.org/>
@@ -0,0 +1,280 @@
+#include "NATest.h"
+#include <stdio.h>
+
+#include "NAStruct/NAList.h"
+
+#define NA_TEST_LIST_COUNT 1000
+
+typedef struct TestListObject TestListObject;
+struct TestListObject{
+  size_t value;
+  NAListElement listElement;
+};
+
+void test_FreeListObject(void* object) {
+  naFree(object);
+}
+
+NABool test_IsListAscending(NAList* list, size_t count) {
+  NABool ascending = NA_TRUE;
+  size_t expected = 0;
+  NAListIterator iter = naMakeListAccessor(list);
+  while(naIterateList(&iter)) {
+    const TestListObject* object = naGetListCurConst(&iter);
+    if(object->value != expected) { ascending = NA_FALSE; }
+    expected++;
+  }
+  naClearListIterator(&iter);
+  return ascending && expected == count;
+}
+
+void testListIntrusive() {
+  naTestGroup("Adding and iterating") {
+    NAList list;
+    TestListObject objects[3] = {{0, {0}}, {1, {0}}, {2, {0}}};
+    naInitListIntrusive(&list, offsetof(TestListObject, listElement));
+    naAddListLastMutable(&list, &objects[1]);
+    naAddListFirstMutable(&list, &objects[0]);
+    naAddListLastMutable(&list, &objects[2]);
+    naTest(naGetListCount(&list) == 3);
+    naTest(test_IsListAscending(&list, 3));
+    naTest(naGetListFirstConst(&list) == &objects[0]);
+    naTest(naRemoveListLastMutable(&list) == &objects[2]);
+    naTestCrash(naAddListLastMutable(&list, NA_NULL));
+    naClearList(&list, NA_NULL);
+  }
+
+  naTestGroup("Iterator modifications") {
+    NAList list;
+    TestListObject objects[4] = {{0, {0}}, {1, {0}}, {2, {0}}, {3, {0}}};
+    naInitListIntrusive(&list, offsetof(TestListObject, listElement));
+    naAddListLastMutable(&list, &objects[0]);
+    naAddListLastMutable(&list, &objects[3]);
+    NAListIterator iter = naMakeListModifier(&list);
+    naLocateListLast(&iter);
+    naAddListBeforeMutable(&iter, &objects[1]);
+    naAddListBeforeMutable(&iter, &objects[2]);
+    naClearListIterator(&iter);
+    naTest(test_IsListAscending(&list, 4));
+    naRemoveListData(&list, &objects[3]);
+    naTest(test_IsListAscending(&list, 3));
+    naClearList(&list, NA_NULL);
+  }
+
+  naTestGroup("Destructing contents") {
+    NAList list;
+    naInitListIntrusive(&list, offsetof(TestListObject, listElement));
+    for(size_t i = 0; i < NA_TEST_LIST_COUNT; ++i) {
+      TestListObject* object = naAlloc(TestListObject);
+      object->value = i;
+      naAddListLastMutable(&list, object);
+    }
+    naTest(test_IsListAscending(&list, NA_TEST_LIST_COUNT));
+    naTestVoid(naClearList(&list, test_FreeListObject));
+  }
+
+  naTestGroup("Moving between lists") {
+    NAList list1;
+    NAList list2;
+    NAList defaultList;
+    TestListObject objects[2] = {{0, {0}}, {1, {0}}};
+    naInitListIntrusive(&list1, offsetof(TestListObject, listElement));
+    naInitListIntrusive(&list2, offsetof(TestListObject, listElement));
+    naInitList(&defaultList);
+    naAddListLastMutable(&list1, &objects[0]);
+    naAddListLastMutable(&list1, &objects[1]);
+    naMoveListFirstToLast(&list1, &list2);
+    naTest(naGetListCount(&list1) == 1 && naGetListFirstConst(&list2) == &objects[0]);
+    naTestError(naMoveListToLast(&list1, &defaultList));
+    naClearList(&list1, NA_NULL);
+    naClearList(&list2, NA_NULL);
+    naClearList(&defaultList, NA_NULL);
+  }
+}
+
+void testListSlab() {
+  naTestGroup("Adding and removing") {
+    NAList list;
+    TestListObject objects[NA_TEST_LIST_COUNT];
+    naInitListWithSlab(&list, 16);
+    for(size_t i = 0; i < NA_TEST_LIST_COUNT; ++i) {
+      objects[i].value = i;
+      naAddListLastConst(&list, &objects[i]);
+    }
+    naTest(test_IsListAscending(&list, NA_TEST_LIST_COUNT));
+    for(size_t i = 0; i < NA_TEST_LIST_COUNT / 2; ++i) {
+      naRemoveListLastConst(&list);
+    }
+    for(size_t i = NA_TEST_LIST_COUNT / 2; i < NA_TEST_LIST_COUNT; ++i) {
+      naAddListLastConst(&list, &objects[i]);
+    }
+    naTest(test_IsListAscending(&list, NA_TEST_LIST_COUNT));
+    naEmptyList(&list, NA_NULL);
+    naTest(naIsListEmpty(&list));
+    naAddListFirstConst(&list, &objects[0]);
+    naTest(test_IsListAscending(&list, 1));
+    naClearList(&list, NA_NULL);
+  }
+
+  naTestGroup("Moving") {
+    NAList list;
+    NAList otherList;
+    TestListObject object = {0, {0}};
+    naInitListWithSlab(&list, 0);
+    naInitListWithSlab(&otherList, 0);
+    naAddListLastConst(&list, &object);
+    naTestError(naMoveListFirstToLast(&list, &otherList));
+    naClearList(&list, NA_NULL);
+    naClearList(&otherList, NA_NULL);
+  }
+}
+
+int test_CompareListObjectTens(const void* a, const void* b) {
+  size_t tensA = ((const TestListObject*)a)->value / 10;
+  size_t tensB = ((const TestListObject*)b)->value / 10;
+  return (tensA > tensB) - (tensA < tensB);
+}
+
+void testListSortAndSplice() {
+  naTestGroup("Sorting") {
+    NAList list;
+    TestListObject objects[NA_TEST_LIST_COUNT];
+    naInitList(&list);
+    naSortList(&list, test_CompareListObjectTens);
+    naTest(naIsListEmpty(&list));
+    // Add the objects by descending tens but ascending ones. Sorting by the
+    // tens only must keep the ones in order as the sort is stable.
+    for(size_t tens = NA_TEST_LIST_COUNT / 10; tens > 0; --tens) {
+      for(size_t ones = 0; ones < 10; ++ones) {
+        size_t value = (tens - 1) * 10 + ones;
+        objects[value].value = value;
+        naAddListLastConst(&list, &objects[value]);
+      }
+    }
+    naSortList(&list, test_CompareListObjectTens);
+    naTest(test_IsListAscending(&list, NA_TEST_LIST_COUNT));
+    naTest(naGetListLastConst(&list) == &objects[NA_TEST_LIST_COUNT - 1]);
+    naTestVoid(naSortList(&list, test_CompareListObjectTens));
+    naTest(test_IsListAscending(&list, NA_TEST_LIST_COUNT));
+    naClearList(&list, NA_NULL);
+  }
+
+  naTestGroup("Splicing between lists") {
+    NAList list1;
+    NAList list2;
+    TestListObject objects[6] = {{0, {0}}, {1, {0}}, {2, {0}}, {3, {0}}, {4, {0}}, {5, {0}}};
+    naInitListIntrusive(&list1, offsetof(TestListObject, listElement));
+    naInitListIntrusive(&list2, offsetof(TestListObject, listElement));
+    naAddListLastMutable(&list1, &objects[1]);
+    naAddListLastMutable(&list1, &objects[2]);
+    naAddListLastMutable(&list1, &objects[3]);
+    naAddListLastMutable(&list2, &objects[0]);
+    naAddListLastMutable(&list2, &objects[4]);
+    naAddListLastMutable(&list2, &objects[5]);
+
+    NAListIterator begin = naMakeListModifier(&list1);
+    NAListIterator end = naMakeListModifier(&list1);
+    NAListIterator dst = naMakeListModifier(&list2);
+    naLocateListFirst(&begin);
+    naLocateListIndex(&dst, 1);
+    naSpliceListRange(&begin, &end, &dst, 3);
+    naTest(naIsListEmpty(&list1));
+    naTest(naIsListAtInitial(&begin));
+    naTest(naGetListCurConst(&dst) == &objects[4]);
+    naTest(test_IsListAscending(&list2, 6));
+    naClearListIterator(&begin);
+    naClearListIterator(&end);
+    naClearListIterator(&dst);
+
+    // Move a part back without giving the count.
+    begin = naMakeListModifier(&list2);
+    end = naMakeListModifier(&list2);
+    dst = naMakeListModifier(&list1);
+    naLocateListIndex(&begin, 2);
+    naLocateListIndex(&end, 4);
+    naSpliceListRange(&begin, &end, &dst, NA_LIST_UNKNOWN_COUNT);
+    naTest(naGetListCount(&list1) == 2 && naGetListCount(&list2) == 4);
+    naTest(naGetListFirstConst(&list1) == &objects[2]);
+    naTest(naGetListCurConst(&begin) == &objects[4]);
+    naClearListIterator(&begin);
+    naClearListIterator(&end);
+    naClearListIterator(&dst);
+
+    naClearList(&list1, NA_NULL);
+    naClearList(&list2, NA_NULL);
+  }
+
+  naTestGroup("Splicing within a list") {
+    NAList list;
+    TestListObject objects[5] = {{0, {0}}, {1, {0}}, {2, {0}}, {3, {0}}, {4, {0}}};
+    naInitList(&list);
+    naAddListLastConst(&list, &objects[3]);
+    naAddListLastConst(&list, &objects[4]);
+    naAddListLastConst(&list, &objects[0]);
+    naAddListLastConst(&list, &objects[1]);
+    naAddListLastConst(&list, &objects[2]);
+    NAListIterator begin = naMakeListModifier(&list);
+    NAListIterator end = naMakeListModifier(&list);
+    NAListIterator dst = naMakeListModifier(&list);
+    naLocateListIndex(&begin, 2);
+    naLocateListFirst(&dst);
+    naSpliceListRange(&begin, &end, &dst, 3);
+    naTest(test_IsListAscending(&list, 5));
+    naClearListIterator(&begin);
+    naClearListIterator(&end);
+    naClearListIterator(&dst);
+    naClearList(&list, NA_NULL);
+  }
+}
+
+void testNAList(void) {
+  naTestFunction(testListIntrusive);
+  naTestFunction(testListSlab);
+  naTestFunction(testListSortAndSplice);
+}
+
+void benchmarkNAList(void) {
+  NAList list;
+  TestListObject* objects = naMalloc(NA_TEST_LIST_COUNT * sizeof(TestListObject));
+
+  naInitList(&list);
+  naBenchmark((naAddListLastConst(&list, objects), naRemoveListFirstConst(&list)));
+  naClearList(&list, NA_NULL);
+
+  naInitListWithSlab(&list, 0);
+  naBenchmark((naAddListLastConst(&list, objects), naRemoveListFirstConst(&list)));
+  naClearList(&list, NA_NULL);
+
+  naInitListIntrusive(&list, offsetof(TestListObject, listElement));
+  naBenchmark((naAddListLastConst(&list, objects), naRemoveListFirstConst(&list)));
+  naClearList(&list, NA_NULL);
+
+  naFree(objects);
+}
+
+
+
+// This is free and unencumbered software released into the public domain.
+
+// Anyone is free to copy, modify, publish, use, compile, sell, or
+// distribute this software, either in source code form or as a compiled
+// binary, for any purpose, commercial or non-commercial, and by any
+// means.
+
+// In jurisdictions that recognize copyright laws, the author or authors
+// of this software dedicate any and all copyright interest in the
+// software to the public domain. We make this dedication for the benefit
+// of the public at large and to the detriment of our heirs and
+// successors. We intend this dedication to be an overt act of
+// relinquishment in perpetuity of all present and future rights to this
+// software under copyright law.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+
+// For more information, please refer to <http://unlicense.org/>
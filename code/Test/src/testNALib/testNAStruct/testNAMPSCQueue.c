@@ -0,0 +1,132 @@
+#include "NATest.h"
+#include <stdio.h>
+
+#include "NAStruct/NAMPSCQueue.h"
+#include "NAUtility/NAThreading.h"
+
+#define NA_TEST_MPSC_QUEUE_PRODUCER_COUNT 3
+#define NA_TEST_MPSC_QUEUE_ELEMENT_COUNT 10000
+
+typedef struct TestMPSCMessage TestMPSCMessage;
+struct TestMPSCMessage{
+  size_t value;
+  NAMPSCQueueNode node;
+};
+
+typedef struct TestMPSCProducer TestMPSCProducer;
+struct TestMPSCProducer{
+  NAMPSCQueue* queue;
+  TestMPSCMessage messages[NA_TEST_MPSC_QUEUE_ELEMENT_COUNT];
+};
+
+void test_ProduceMPSCQueueMessages(void* arg) {
+  TestMPSCProducer* producer = (TestMPSCProducer*)arg;
+  for(size_t i = 0; i < NA_TEST_MPSC_QUEUE_ELEMENT_COUNT; ++i) {
+    producer->messages[i].value = i;
+    naPushMPSCQueueNode(producer->queue, &producer->messages[i].node);
+  }
+}
+
+void testMPSCQueueSerial() {
+  naTestGroup("Intrusive nodes") {
+    NAMPSCQueue queue;
+    TestMPSCMessage messages[3] = {{1, {NA_NULL}}, {2, {NA_NULL}}, {3, {NA_NULL}}};
+    naInitMPSCQueue(&queue);
+    naTest(naIsMPSCQueueEmpty(&queue));
+    naTest(naPullMPSCQueueNode(&queue) == NA_NULL);
+    for(size_t i = 0; i < 3; ++i) {
+      naPushMPSCQueueNode(&queue, &messages[i].node);
+    }
+    naTest(!naIsMPSCQueueEmpty(&queue));
+    naTest(naGetMPSCQueueNodeOwner(naPullMPSCQueueNode(&queue), TestMPSCMessage, node)->value == 1);
+    naTest(naGetMPSCQueueNodeOwner(naPullMPSCQueueNode(&queue), TestMPSCMessage, node)->value == 2);
+    naPushMPSCQueueNode(&queue, &messages[0].node);
+    naTest(naGetMPSCQueueNodeOwner(naPullMPSCQueueNode(&queue), TestMPSCMessage, node)->value == 3);
+    naTest(naGetMPSCQueueNodeOwner(naPullMPSCQueueNode(&queue), TestMPSCMessage, node)->value == 1);
+    naTest(naPullMPSCQueueNode(&queue) == NA_NULL);
+    naTest(naIsMPSCQueueEmpty(&queue));
+    naTestVoid(naClearMPSCQueue(&queue));
+  }
+
+  naTestGroup("Values") {
+    NAMPSCQueue queue;
+    void* data = NA_NULL;
+    naInitMPSCQueue(&queue);
+    naPushMPSCQueue(&queue, &queue);
+    naTestError(naClearMPSCQueue(&queue));
+    naTest(naPullMPSCQueue(&queue, &data) && data == &queue);
+    naTest(!naPullMPSCQueue(&queue, &data));
+    naClearMPSCQueue(&queue);
+  }
+}
+
+void testMPSCQueueThreaded() {
+  naTestGroup("Multiple producers") {
+    NAMPSCQueue queue;
+    TestMPSCProducer* producers = naMalloc(NA_TEST_MPSC_QUEUE_PRODUCER_COUNT * sizeof(TestMPSCProducer));
+    NAThread threads[NA_TEST_MPSC_QUEUE_PRODUCER_COUNT];
+    size_t nextValues[NA_TEST_MPSC_QUEUE_PRODUCER_COUNT] = {0};
+    size_t received = 0;
+    NABool ordered = NA_TRUE;
+    naInitMPSCQueue(&queue);
+
+    for(size_t i = 0; i < NA_TEST_MPSC_QUEUE_PRODUCER_COUNT; ++i) {
+      producers[i].queue = &queue;
+      threads[i] = naMakeThread("Producer", test_ProduceMPSCQueueMessages, &producers[i]);
+      naRunThread(threads[i]);
+    }
+
+    // The messages of every producer must arrive in the order pushed.
+    while(received < NA_TEST_MPSC_QUEUE_PRODUCER_COUNT * NA_TEST_MPSC_QUEUE_ELEMENT_COUNT) {
+      NAMPSCQueueNode* node = naPullMPSCQueueNode(&queue);
+      if(node) {
+        TestMPSCMessage* message = naGetMPSCQueueNodeOwner(node, TestMPSCMessage, node);
+        size_t producerIndex = (size_t)((NAByte*)message - (NAByte*)producers) / sizeof(TestMPSCProducer);
+        if(message->value != nextValues[producerIndex]) { ordered = NA_FALSE; }
+        nextValues[producerIndex]++;
+        received++;
+      }
+    }
+
+    for(size_t i = 0; i < NA_TEST_MPSC_QUEUE_PRODUCER_COUNT; ++i) {
+      naAwaitThread(threads[i]);
+      naClearThread(threads[i]);
+    }
+    naTest(ordered);
+    naTest(naIsMPSCQueueEmpty(&queue));
+    naClearMPSCQueue(&queue);
+    naFree(producers);
+  }
+}
+
+void testNAMPSCQueue(void) {
+  naTestFunction(testMPSCQueueSerial);
+  naTestFunction(testMPSCQueueThreaded);
+}
+
+
+
+// This is free and unencumbered software released into the public domain.
+
+// Anyone is free to copy, modify, publish, use, compile, sell, or
+// distribute this software, either in source code form or as a compiled
+// binary, for any purpose, commercial or non-commercial, and by any
+// means.
+
+// In jurisdictions that recognize copyright laws, the author or authors
+// of this software dedicate any and all copyright interest in the
+// software to the public domain. We make this dedication for the benefit
+// of the public at large and to the detriment of our heirs and
+// successors. We intend this dedication to be an overt act of
+// relinquishment in perpetuity of all present and future rights to this
+// software under copyright law.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+
+// For more information, please refer to <http://unlicense.org/>
@@ -392,6 +392,51 @@ void testStackDump(void) {
 
 
 
+void testStackBlocks(void) {
+  NAStack stack;
+  uint32 growFlags[] = {
+    NA_STACK_GROW_LINEAR,
+    NA_STACK_GROW_FIBONACCI,
+    NA_STACK_GROW_EXPONENTIAL};
+
+  naTestGroup("Peeking in all blocks") {
+    for(size_t f = 0; f < 3; ++f) {
+      NABool correct = NA_TRUE;
+      naInitStack(&stack, sizeof(size_t), 3, growFlags[f]);
+      for(size_t i = 0; i < NA_BENCHMARK_STACK_SIZE; ++i) {
+        *(size_t*)naPushStack(&stack) = i;
+      }
+      for(size_t i = 0; i < NA_BENCHMARK_STACK_SIZE; ++i) {
+        if(*(size_t*)naPeekStack(&stack, i) != i) { correct = NA_FALSE; }
+      }
+      naTest(correct);
+      naClearStack(&stack);
+    }
+  }
+
+  naTestGroup("Block spans") {
+    NAStackSpan spans[3];
+    naInitStack(&stack, sizeof(int), 2, NA_STACK_GROW_EXPONENTIAL);
+    naTest(naGetStackBlockSpans(&stack, NA_NULL, 0) == 0);
+    for(int i = 0; i < 5; ++i) {
+      *(int*)naPushStack(&stack) = i;
+    }
+    naTest(naGetStackBlockSpans(&stack, NA_NULL, 0) == 2);
+    naTest(naGetStackBlockSpans(&stack, spans, 3) == 2);
+    naTest(spans[0].count == 2 && ((int*)spans[0].first)[1] == 1);
+    naTest(spans[1].count == 3 && ((int*)spans[1].first)[2] == 4);
+    naPopStack(&stack);
+    naPopStack(&stack);
+    naPopStack(&stack);
+    naTest(naGetStackBlockSpans(&stack, spans, 1) == 1);
+    naTest(spans[0].count == 2);
+    naTestCrash(naGetStackBlockSpans(NA_NULL, spans, 1));
+    naClearStack(&stack);
+  }
+}
+
+
+
 void testStackIterator(void) {
   NAStack stack;
   naInitStack(&stack, sizeof(int), 0, 0);
@@ -654,6 +699,7 @@ void testNAStack(void) {
   naTestFunction(testStackShrink);  
   naTestFunction(testStackShrinkIfNecessary);  
   naTestFunction(testStackDump);  
+  naTestFunction(testStackBlocks);  
   naTestFunction(testStackIterator);  
   naTestFunction(testStackIteratorAccessAndMutate);  
   naTestFunction(testStackForeach);  
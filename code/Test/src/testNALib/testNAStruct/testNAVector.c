@@ -0,0 +1,181 @@
+#include "NATest.h"
+#include <stdio.h>
+
+#include "NAStruct/NAVector.h"
+
+#define NA_TEST_VECTOR_COUNT 1000
+#define NA_BENCHMARK_VECTOR_SIZE 1000
+
+void testVectorConstruction() {
+  naTestGroup("Construction and destruction") {
+    NAVector vector;
+    naTest(naInitVector(&vector, sizeof(int), 0) == &vector);
+    naTest(naIsVectorEmpty(&vector));
+    naTest(naGetVectorCapacity(&vector) == 0);
+    naTest(naGetVectorTypeSize(&vector) == sizeof(int));
+    naTestVoid(naClearVector(&vector));
+    naTestError(naInitVector(&vector, 0, 10));
+    naTestError(naInitVectorAligned(&vector, sizeof(int), 10, 3));
+    naTestCrash(naInitVector(NA_NULL, sizeof(int), 10));
+  }
+
+  naTestGroup("Aligned storage") {
+    NAVector vector;
+    naInitVectorAligned(&vector, sizeof(double), 3, 64);
+    naTest(naGetVectorCapacity(&vector) == 3);
+    naTest(((size_t)naGetVectorPointerConst(&vector) & 63) == 0);
+    for(size_t i = 0; i < NA_TEST_VECTOR_COUNT; ++i) {
+      *(double*)naPushVector(&vector) = (double)i;
+    }
+    naTest(((size_t)naGetVectorPointerConst(&vector) & 63) == 0);
+    naClearVector(&vector);
+  }
+}
+
+void testVectorGrowing() {
+  naTestGroup("Push and pop") {
+    NAVector vector;
+    NABool correct = NA_TRUE;
+    naInitVector(&vector, sizeof(size_t), 0);
+    for(size_t i = 0; i < NA_TEST_VECTOR_COUNT; ++i) {
+      *(size_t*)naPushVector(&vector) = i;
+    }
+    naTest(naGetVectorCount(&vector) == NA_TEST_VECTOR_COUNT);
+    naTest(naGetVectorCapacity(&vector) >= NA_TEST_VECTOR_COUNT);
+    const size_t* values = naGetVectorPointerConst(&vector);
+    for(size_t i = 0; i < NA_TEST_VECTOR_COUNT; ++i) {
+      if(values[i] != i) { correct = NA_FALSE; }
+    }
+    naTest(correct);
+    naTest(*(size_t*)naPopVector(&vector) == NA_TEST_VECTOR_COUNT - 1);
+    naTest(*(const size_t*)naGetVectorElementConst(&vector, 10) == 10);
+    naTestError(naGetVectorElementConst(&vector, NA_TEST_VECTOR_COUNT));
+    naEmptyVector(&vector);
+    naTestError(naPopVector(&vector));
+    naClearVector(&vector);
+  }
+
+  naTestGroup("Reserve and shrink") {
+    NAVector vector;
+    naInitVector(&vector, sizeof(int), 0);
+    naReserveVector(&vector, 100);
+    naTest(naGetVectorCapacity(&vector) == 100);
+    naReserveVector(&vector, 10);
+    naTest(naGetVectorCapacity(&vector) == 100);
+    naResizeVector(&vector, 20);
+    naTest(naGetVectorCount(&vector) == 20);
+    naShrinkVectorToFit(&vector);
+    naTest(naGetVectorCapacity(&vector) == 20);
+    naEmptyVector(&vector);
+    naShrinkVectorToFit(&vector);
+    naTest(naGetVectorCapacity(&vector) == 0 && naGetVectorPointerConst(&vector) == NA_NULL);
+    naClearVector(&vector);
+  }
+}
+
+void testVectorRanges() {
+  naTestGroup("Insert and erase") {
+    NAVector vector;
+    int values[] = {0, 1, 2, 3, 4, 5};
+    naInitVector(&vector, sizeof(int), 0);
+    naPushVectorElements(&vector, values, 6);
+    naTest(naGetVectorCount(&vector) == 6);
+
+    int* inserted = naInsertVectorElements(&vector, 2, 3);
+    inserted[0] = 10; inserted[1] = 11; inserted[2] = 12;
+    const int* data = naGetVectorPointerConst(&vector);
+    naTest(naGetVectorCount(&vector) == 9);
+    naTest(data[1] == 1 && data[2] == 10 && data[4] == 12 && data[5] == 2 && data[8] == 5);
+
+    naEraseVectorElements(&vector, 1, 4);
+    data = naGetVectorPointerConst(&vector);
+    naTest(naGetVectorCount(&vector) == 5);
+    naTest(data[0] == 0 && data[1] == 2 && data[4] == 5);
+
+    *(int*)naInsertVectorElements(&vector, 5, 1) = 6;
+    naTest(*(const int*)naGetVectorElementConst(&vector, 5) == 6);
+    naTestError(naInsertVectorElements(&vector, 7, 1));
+    naTestError(naEraseVectorElements(&vector, 4, 3));
+    naClearVector(&vector);
+  }
+
+  naTestGroup("Push own elements") {
+    NAVector vector;
+    int values[] = {0, 1, 2, 3};
+    naInitVector(&vector, sizeof(int), 0);
+    naPushVectorElements(&vector, values, 4);
+    naTest(naGetVectorCapacity(&vector) == 4);
+
+    // Grows the vector while copying from its own storage.
+    naTestVoid(naPushVectorElements(&vector, naGetVectorPointerConst(&vector), 4));
+    const int* data = naGetVectorPointerConst(&vector);
+    naTest(naGetVectorCount(&vector) == 8);
+    naTest(data[0] == 0 && data[3] == 3 && data[4] == 0 && data[7] == 3);
+    naClearVector(&vector);
+  }
+
+  naTestGroup("Handing over to an array") {
+    NAVector vector;
+    NAArray array;
+    naInitVector(&vector, sizeof(int), 0);
+    for(int i = 0; i < 10; ++i) {
+      *(int*)naPushVector(&vector) = i;
+    }
+    const void* data = naGetVectorPointerConst(&vector);
+    naInitArrayWithVector(&array, &vector);
+    naTest(naGetArrayCount(&array) == 10);
+    naTest(naGetArrayPointerConst(&array) == data);
+    naTest(naIsVectorEmpty(&vector) && naGetVectorCapacity(&vector) == 0);
+    naClearArray(&array);
+    naClearVector(&vector);
+  }
+}
+
+void testNAVector(void) {
+  naTestFunction(testVectorConstruction);
+  naTestFunction(testVectorGrowing);
+  naTestFunction(testVectorRanges);
+}
+
+void benchmarkNAVector(void) {
+  NAVector vector;
+  naInitVector(&vector, sizeof(size_t), 0);
+  naBenchmark(naGetVectorCount(&vector) < NA_BENCHMARK_VECTOR_SIZE
+    ? naPushVector(&vector)
+    : (naEmptyVector(&vector), NA_NULL));
+  naClearVector(&vector);
+
+  naInitVector(&vector, sizeof(size_t), NA_BENCHMARK_VECTOR_SIZE);
+  for(size_t i = 0; i < NA_BENCHMARK_VECTOR_SIZE; ++i) {
+    *(size_t*)naPushVector(&vector) = i;
+  }
+  naBenchmark(naGetVectorElementConst(&vector, naTestIn % NA_BENCHMARK_VECTOR_SIZE));
+  naClearVector(&vector);
+}
+
+
+
+// This is free and unencumbered software released into the public domain.
+
+// Anyone is free to copy, modify, publish, use, compile, sell, or
+// distribute this software, either in source code form or as a compiled
+// binary, for any purpose, commercial or non-commercial, and by any
+// means.
+
+// In jurisdictions that recognize copyright laws, the author or authors
+// of this software dedicate any and all copyright interest in the
+// software to the public domain. We make this dedication for the benefit
+// of the public at large and to the detriment of our heirs and
+// successors. We intend this dedication to be an overt act of
+// relinquishment in perpetuity of all present and future rights to this
+// software under copyright law.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+
+// For more information, please refer to <http://unlicense.org/>
@@ -5,7 +5,11 @@
 
 
 // Prototypes
+void testNAArena(void);
 void testNANotifier(void);
+void testNARuntime(void);
+void testNATaskPool(void);
+void testNAThreading(void);
 
 
 
@@ -13,7 +17,11 @@ void printNAUtility(void) {
 }
 
 void testNAUtility(void) {
+  naTestFunction(testNAArena);
   naTestFunction(testNANotifier);
+  naTestFunction(testNARuntime);
+  naTestFunction(testNATaskPool);
+  naTestFunction(testNAThreading);
 }
 
 
@@ -0,0 +1,113 @@
+
+#include "NATest.h"
+#include "NAUtility/NAArena.h"
+#include "NAUtility/NAMemory.h"
+#include <stdio.h>
+
+
+
+void testNAArenaAlloc() {
+  naTestGroup("Allocation") {
+    NAArena* arena = naAllocArena(0);
+    void* ptr = NA_NULL;
+    naTestVoid(ptr = naArenaAlloc(arena, 13));
+    naTest(((size_t)ptr % (2 * NA_ADDRESS_BYTES)) == 0);
+    naTestVoid(ptr = naArenaAllocAligned(arena, 100, 256));
+    naTest(((size_t)ptr % 256) == 0);
+    naTestError(naArenaAllocAligned(arena, 100, 3));
+    naDeallocArena(arena);
+  }
+
+  naTestGroup("Bigger than a chunk") {
+    NAArena* arena = naAllocArena(0);
+    size_t bigSize = 10 * naGetSystemMemoryPagesize();
+    NAByte* ptr = NA_NULL;
+    naTestVoid(ptr = naArenaAlloc(arena, bigSize));
+    naTestVoid(ptr[0] = 1; ptr[bigSize - 1] = 1;);
+    naTest(naGetArenaByteSize(arena) > bigSize);
+    naDeallocArena(arena);
+  }
+
+  naTestGroup("Alignment bigger than a chunk") {
+    NAArena* arena = naAllocArena(0);
+    size_t align = 4 * naGetSystemMemoryPagesize();
+    NABool allAligned = NA_TRUE;
+    for(size_t i = 0; i < 16; ++i) {
+      NAByte* ptr = naArenaAllocAligned(arena, 16, align);
+      ptr[0] = 1;
+      ptr[15] = 1;
+      if((size_t)ptr % align) {
+        allAligned = NA_FALSE;
+      }
+    }
+    naTest(allAligned);
+    naDeallocArena(arena);
+  }
+}
+
+
+
+void testNAArenaMarkAndReset() {
+  naTestGroup("Mark and rewind") {
+    NAArena* arena = naAllocArena(0);
+    naArenaAlloc(arena, 10);
+    NAArenaMark mark = naArenaMark(arena);
+    void* first = naArenaAlloc(arena, 10);
+    for(size_t i = 0; i < 1000; ++i) {
+      naArenaAlloc(arena, 100);
+    }
+    naTestVoid(naArenaRewind(arena, mark));
+    naTest(naArenaAlloc(arena, 10) == first);
+    naDeallocArena(arena);
+  }
+
+  naTestGroup("Reset reuses chunks") {
+    NAArena* arena = naAllocArena(0);
+    void* first = naArenaAlloc(arena, 10);
+    for(size_t i = 0; i < 1000; ++i) {
+      naArenaAlloc(arena, 100);
+    }
+    size_t byteSize = naGetArenaByteSize(arena);
+    naTestVoid(naResetArena(arena));
+    naTest(naArenaAlloc(arena, 10) == first);
+    for(size_t i = 0; i < 1000; ++i) {
+      naArenaAlloc(arena, 100);
+    }
+    naTest(naGetArenaByteSize(arena) == byteSize);
+    naDeallocArena(arena);
+  }
+}
+
+
+
+void testNAArena() {
+  naTestFunction(testNAArenaAlloc);
+  naTestFunction(testNAArenaMarkAndReset);
+}
+
+
+
+// This is free and unencumbered software released into the public domain.
+
+// Anyone is free to copy, modify, publish, use, compile, sell, or
+// distribute this software, either in source code form or as a compiled
+// binary, for any purpose, commercial or non-commercial, and by any
+// means.
+
+// In jurisdictions that recognize copyright laws, the author or authors
+// of this software dedicate any and all copyright interest in the
+// software to the public domain. We make this dedication for the benefit
+// of the public at large and to the detriment of our heirs and
+// successors. We intend this dedication to be an overt act of
+// relinquishment in perpetuity of all present and future rights to this
+// software under copyright law.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+
+// For more information, please refer to <http://unlicense.org/>
@@ -0,0 +1,166 @@
+#include "NATest.h"
+#include "NAUtility/NAMemory.h"
+#include <stdio.h>
+#include <string.h>
+
+
+
+#define RUNTIME_TEST_BATCH_COUNT 100
+#define RUNTIME_TEST_ALIGN 64
+
+typedef struct RuntimeTestObject RuntimeTestObject;
+struct RuntimeTestObject{
+  size_t index;
+  double value;
+};
+
+typedef struct RuntimeTestAligned RuntimeTestAligned;
+struct RuntimeTestAligned{
+  double values[3];
+};
+
+static size_t runtimeTestDestructorCount = 0;
+void destructRuntimeTestObject(RuntimeTestObject* object) {
+  runtimeTestDestructorCount++;
+}
+
+NA_RUNTIME_TYPE(RuntimeTestObject, destructRuntimeTestObject, NA_FALSE);
+NA_RUNTIME_TYPE_ALIGNED(RuntimeTestAligned, NA_NULL, NA_FALSE, RUNTIME_TEST_ALIGN);
+
+// Fills stats with the statistics of the type with the given name. A type
+// which has not been registered yet gets zero counts.
+void getRuntimeTestStats(NARuntimeTypeStats* stats, const char* typeName) {
+  NARuntimeTypeStats allStats[256];
+  size_t typeCount = naGetRuntimeTypeStats(allStats, 256);
+  memset(stats, 0, sizeof(NARuntimeTypeStats));
+  for(size_t i = 0; i < typeCount && i < 256; ++i) {
+    if(!strcmp(allStats[i].typeName, typeName)) {
+      *stats = allStats[i];
+    }
+  }
+}
+
+
+
+void testNARuntimeBatch() {
+  naTestGroup("naNewBatch") {
+    RuntimeTestObject* objects[RUNTIME_TEST_BATCH_COUNT];
+    naTestVoid(naNewBatch(RuntimeTestObject, RUNTIME_TEST_BATCH_COUNT, objects));
+
+    NABool allDistinct = NA_TRUE;
+    for(size_t i = 0; i < RUNTIME_TEST_BATCH_COUNT; ++i) {
+      for(size_t j = i + 1; j < RUNTIME_TEST_BATCH_COUNT; ++j) {
+        if(objects[i] == objects[j]) {
+          allDistinct = NA_FALSE;
+        }
+      }
+    }
+    naTest(allDistinct);
+
+    for(size_t i = 0; i < RUNTIME_TEST_BATCH_COUNT; ++i) {
+      objects[i]->index = i;
+      objects[i]->value = (double)i * .5;
+    }
+    NABool allUsable = NA_TRUE;
+    for(size_t i = 0; i < RUNTIME_TEST_BATCH_COUNT; ++i) {
+      if(objects[i]->index != i || objects[i]->value != (double)i * .5) {
+        allUsable = NA_FALSE;
+      }
+    }
+    naTest(allUsable);
+
+    runtimeTestDestructorCount = 0;
+    naTestVoid(naDeleteBatch((void**)objects, RUNTIME_TEST_BATCH_COUNT));
+    naTest(runtimeTestDestructorCount == RUNTIME_TEST_BATCH_COUNT);
+  }
+}
+
+
+
+void testNARuntimeAlignment() {
+  naTestGroup("NA_RUNTIME_TYPE_ALIGNED") {
+    RuntimeTestAligned* object = naNew(RuntimeTestAligned);
+    naTest(((size_t)object % RUNTIME_TEST_ALIGN) == 0);
+
+    RuntimeTestAligned* objects[RUNTIME_TEST_BATCH_COUNT];
+    naNewBatch(RuntimeTestAligned, RUNTIME_TEST_BATCH_COUNT, objects);
+    NABool allAligned = NA_TRUE;
+    for(size_t i = 0; i < RUNTIME_TEST_BATCH_COUNT; ++i) {
+      if(((size_t)objects[i] % RUNTIME_TEST_ALIGN) != 0) {
+        allAligned = NA_FALSE;
+      }
+    }
+    naTest(allAligned);
+
+    NARuntimeTypeStats stats;
+    getRuntimeTestStats(&stats, "RuntimeTestAligned");
+    naTest(stats.typeSize >= sizeof(RuntimeTestAligned));
+    naTest((stats.typeSize % RUNTIME_TEST_ALIGN) == 0);
+
+    naDeleteBatch((void**)objects, RUNTIME_TEST_BATCH_COUNT);
+    naDelete(object);
+  }
+}
+
+
+
+void testNARuntimeStats() {
+  naTestGroup("naGetRuntimeTypeStats") {
+    NARuntimeTypeStats before;
+    NARuntimeTypeStats stats;
+    RuntimeTestObject* objects[RUNTIME_TEST_BATCH_COUNT];
+    getRuntimeTestStats(&before, "RuntimeTestObject");
+
+    naNewBatch(RuntimeTestObject, RUNTIME_TEST_BATCH_COUNT, objects);
+    RuntimeTestObject* object = naNew(RuntimeTestObject);
+    getRuntimeTestStats(&stats, "RuntimeTestObject");
+    naTest(naGetRuntimeTypeStats(NA_NULL, 0) > stats.typeId);
+    naTest(stats.liveCount == before.liveCount + RUNTIME_TEST_BATCH_COUNT + 1);
+    naTest(stats.allocationCount == before.allocationCount + RUNTIME_TEST_BATCH_COUNT + 1);
+    naTest(stats.maxLiveCount >= stats.liveCount);
+    naTest(stats.partCount > 0);
+    naTest(stats.usedByteSize == stats.liveCount * stats.typeSize);
+    naTest(stats.reservedByteSize >= stats.usedByteSize);
+
+    naDelete(object);
+    naDeleteBatch((void**)objects, RUNTIME_TEST_BATCH_COUNT);
+    getRuntimeTestStats(&stats, "RuntimeTestObject");
+    naTest(stats.liveCount == before.liveCount);
+    naTest(stats.allocationCount == before.allocationCount + RUNTIME_TEST_BATCH_COUNT + 1);
+  }
+}
+
+
+
+void testNARuntime() {
+  naTestFunction(testNARuntimeBatch);
+  naTestFunction(testNARuntimeAlignment);
+  naTestFunction(testNARuntimeStats);
+}
+
+
+
+// This is free and unencumbered software released into the public domain.
+
+// Anyone is free to copy, modify, publish, use, compile, sell, or
+// distribute this software, either in source code form or as a compiled
+// binary, for any purpose, commercial or non-commercial, and by any
+// means.
+
+// In jurisdictions that recognize copyright laws, the author or authors
+// of this software dedicate any and all copyright interest in the
+// software to the public domain. We make this dedication for the benefit
+// of the public at large and to the detriment of our heirs and
+// successors. We intend this dedication to be an overt act of
+// relinquishment in perpetuity of all present and future rights to this
+// software under copyright law.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+
+// For more information, please refer to <http://unlicense.org/>
@@ -0,0 +1,235 @@
+#include "NATest.h"
+#include "NAUtility/NATaskPool.h"
+#include <stdio.h>
+
+
+
+typedef struct TaskPoolSum TaskPoolSum;
+struct TaskPoolSum{
+  NATaskPool* pool;
+  const int* values;
+  size_t count;
+  int64 sum;
+};
+
+// Sums up the values by splitting the range in two subtasks until small.
+void sumTaskPoolValues(void* arg) {
+  TaskPoolSum* sum = (TaskPoolSum*)arg;
+  if(sum->count <= 64) {
+    sum->sum = 0;
+    for(size_t i = 0; i < sum->count; ++i) {
+      sum->sum += sum->values[i];
+    }
+  }else{
+    size_t half = sum->count / 2;
+    TaskPoolSum left = {sum->pool, sum->values, half, 0};
+    TaskPoolSum right = {sum->pool, sum->values + half, sum->count - half, 0};
+    NAWaitGroup* group = naAllocWaitGroup();
+    naSubmitGroupTask(sum->pool, group, sumTaskPoolValues, &left);
+    naSubmitGroupTask(sum->pool, group, sumTaskPoolValues, &right);
+    naAwaitWaitGroup(sum->pool, group);
+    naDeallocWaitGroup(group);
+    sum->sum = left.sum + right.sum;
+  }
+}
+
+void setTaskPoolFlag(void* arg) {
+  *(int*)arg = 1;
+}
+
+void squareParallelRange(size_t begin, size_t end, void* userData) {
+  int64* values = (int64*)userData;
+  for(size_t i = begin; i < end; ++i) {
+    values[i] = (int64)(i * i);
+  }
+}
+
+void sumParallelRange(size_t begin, size_t end, void* partial, void* userData) {
+  const int64* values = (const int64*)userData;
+  for(size_t i = begin; i < end; ++i) {
+    *(int64*)partial += values[i];
+  }
+}
+
+void joinParallelSum(void* result, const void* partial, void* userData) {
+  NA_UNUSED(userData);
+  *(int64*)result += *(const int64*)partial;
+}
+
+void negateTaskPoolValue(void* value) {
+  *(int64*)value = -*(int64*)value;
+}
+
+void* doubleTaskPoolValue(void* arg) {
+  return (void*)(2 * (size_t)arg);
+}
+
+typedef struct TaskGraphStep TaskGraphStep;
+struct TaskGraphStep{
+  int64* counter;
+  int64 order;
+};
+
+void runTaskGraphStep(void* arg) {
+  TaskGraphStep* step = (TaskGraphStep*)arg;
+  step->order = naAtomicAddi64(step->counter, 1, NA_MEMORY_ORDER_SEQ_CST);
+}
+
+
+
+void testNATaskPoolSubmit() {
+  naTestGroup("Submit and await") {
+    NATaskPool* pool = naAllocTaskPool(4);
+    int flags[100] = {0};
+    naTest(naGetTaskPoolWorkerCount(pool) == 4);
+    naTest(naGetCurrentTaskPoolWorkerIndex(pool) == 4);
+    for(size_t i = 0; i < 100; ++i) {
+      naSubmitTask(pool, setTaskPoolFlag, &flags[i]);
+    }
+    naTestVoid(naAwaitTaskPool(pool));
+    int allSet = 1;
+    for(size_t i = 0; i < 100; ++i) {
+      allSet &= flags[i];
+    }
+    naTest(allSet);
+    naDeallocTaskPool(pool);
+  }
+
+  naTestGroup("Nested tasks with wait groups") {
+    NATaskPool* pool = naAllocTaskPool(4);
+    int values[10000];
+    for(size_t i = 0; i < 10000; ++i) {
+      values[i] = (int)i;
+    }
+    TaskPoolSum sum = {pool, values, 10000, 0};
+    NAWaitGroup* group = naAllocWaitGroup();
+    naSubmitGroupTask(pool, group, sumTaskPoolValues, &sum);
+    naTestVoid(naAwaitWaitGroup(pool, group));
+    naTest(naGetWaitGroupCount(group) == 0);
+    naTest(sum.sum == 49995000);
+    naDeallocWaitGroup(group);
+    naDeallocTaskPool(pool);
+  }
+}
+
+
+
+void testNATaskPoolParallel() {
+  naTestGroup("Parallel for and reduce") {
+    int64 values[1000];
+    int64 sum = 0;
+    naTestVoid(naParallelFor(0, 1000, 0, squareParallelRange, values));
+    naTest(values[999] == 999 * 999);
+    naTestVoid(naParallelReduce(0, 1000, 10, &sum, sizeof(int64), sumParallelRange, joinParallelSum, values));
+    naTest(sum == 332833500);
+    naTestVoid(naStopDefaultTaskPool());
+  }
+
+  naTestGroup("Parallel array iteration") {
+    int64 values[1000];
+    NAArray array;
+    NABool allNegated = NA_TRUE;
+    for(size_t i = 0; i < 1000; ++i) {
+      values[i] = (int64)i;
+    }
+    naInitArrayWithDataMutable(&array, values, sizeof(int64), 1000, NA_NULL);
+    naTestVoid(naForeachArrayMutableParallel(&array, negateTaskPoolValue));
+    for(size_t i = 0; i < 1000; ++i) {
+      if(values[i] != -(int64)i) {
+        allNegated = NA_FALSE;
+      }
+    }
+    naTest(allNegated);
+    naClearArray(&array);
+
+    naInitArray(&array);
+    naTestVoid(naForeachArrayMutableParallel(&array, negateTaskPoolValue));
+    naClearArray(&array);
+    naTestVoid(naStopDefaultTaskPool());
+  }
+}
+
+
+
+void testNATaskPoolFutures() {
+  naTestGroup("Futures") {
+    NATaskPool* pool = naAllocTaskPool(2);
+    NAFuture* future = naSubmitFutureTask(pool, doubleTaskPoolValue, (void*)21);
+    naTest(naAwaitFuture(future, 0));
+    naTest(naIsFutureDone(future));
+    naTest((size_t)naGetFutureResult(future) == 42);
+    naDeallocFuture(future);
+
+    future = naAllocFuture();
+    naTest(!naAwaitFuture(future, .01));
+    naTestVoid(naFulfillFuture(future, pool));
+    naTest(naAwaitFuture(future, .01));
+    naTest(naGetFutureResult(future) == pool);
+    naDeallocFuture(future);
+    naDeallocTaskPool(pool);
+  }
+
+  naTestGroup("Task graph") {
+    // A diamond: first, then left and right, then last.
+    NATaskPool* pool = naAllocTaskPool(2);
+    NATaskGraph* graph = naAllocTaskGraph(pool);
+    int64 counter = 0;
+    TaskGraphStep steps[4] = {{&counter, -1}, {&counter, -1}, {&counter, -1}, {&counter, -1}};
+    NATaskNode* last = naAddTaskGraphNode(graph, runTaskGraphStep, &steps[3]);
+    NATaskNode* left = naAddTaskGraphNode(graph, runTaskGraphStep, &steps[1]);
+    NATaskNode* right = naAddTaskGraphNode(graph, runTaskGraphStep, &steps[2]);
+    NATaskNode* first = naAddTaskGraphNode(graph, runTaskGraphStep, &steps[0]);
+    naAddTaskGraphDependency(left, first);
+    naAddTaskGraphDependency(right, first);
+    naAddTaskGraphDependency(last, left);
+    naAddTaskGraphDependency(last, right);
+
+    for(int run = 0; run < 2; ++run) {
+      counter = 0;
+      naTestVoid(naRunTaskGraph(graph));
+      naTestVoid(naAwaitTaskGraph(graph));
+      naTest(counter == 4);
+      naTest(steps[0].order == 0);
+      naTest(steps[1].order == 1 || steps[1].order == 2);
+      naTest(steps[2].order == 1 || steps[2].order == 2);
+      naTest(steps[3].order == 3);
+    }
+    naDeallocTaskGraph(graph);
+    naDeallocTaskPool(pool);
+  }
+}
+
+
+
+void testNATaskPool() {
+  naTestFunction(testNATaskPoolSubmit);
+  naTestFunction(testNATaskPoolParallel);
+  naTestFunction(testNATaskPoolFutures);
+}
+
+
+
+// This is free and unencumbered software released into the public domain.
+
+// Anyone is free to copy, modify, publish, use, compile, sell, or
+// distribute this software, either in source code form or as a compiled
+// binary, for any purpose, commercial or non-commercial, and by any
+// means.
+
+// In jurisdictions that recognize copyright laws, the author or authors
+// of this software dedicate any and all copyright interest in the
+// software to the public domain. We make this dedication for the benefit
+// of the public at large and to the detriment of our heirs and
+// successors. We intend this dedication to be an overt act of
+// relinquishment in perpetuity of all present and future rights to this
+// software under copyright law.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+
+// For more information, please refer to <http://unlicense.org/>
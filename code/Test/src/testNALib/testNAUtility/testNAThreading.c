@@ -0,0 +1,235 @@
+#include "NATest.h"
+#include "NAUtility/NAThreading.h"
+#include <stdio.h>
+
+
+
+#define THREADING_TEST_THREAD_COUNT 4
+#define THREADING_TEST_ITERATIONS 10000
+
+typedef struct ThreadingTestTry ThreadingTestTry;
+struct ThreadingTestTry{
+  NARWLock lock;
+  NASpinMutex mutex;
+  NABool shared;
+  NABool exclusive;
+  NABool spin;
+};
+
+typedef struct ThreadingTestCounter ThreadingTestCounter;
+struct ThreadingTestCounter{
+  NARWLock lock;
+  NASpinMutex mutex;
+  int64 rwCount;
+  int64 spinCount;
+};
+
+// Tries all locks from a different thread and unlocks them when successful.
+void tryThreadingTestLocks(void* arg) {
+  ThreadingTestTry* test = (ThreadingTestTry*)arg;
+  test->shared = naTryRWLockShared(test->lock);
+  if(test->shared) {
+    naUnlockRWLockShared(test->lock);
+  }
+  test->exclusive = naTryRWLockExclusive(test->lock);
+  if(test->exclusive) {
+    naUnlockRWLockExclusive(test->lock);
+  }
+  test->spin = naTrySpinMutex(test->mutex);
+  if(test->spin) {
+    naUnlockSpinMutex(test->mutex);
+  }
+}
+
+void runThreadingTestTry(ThreadingTestTry* test) {
+  NAThread thread = naMakeThread("Threading try", tryThreadingTestLocks, test);
+  naRunThread(thread);
+  naAwaitThread(thread);
+  naClearThread(thread);
+}
+
+typedef struct ThreadingTestLocal ThreadingTestLocal;
+struct ThreadingTestLocal{
+  NAThreadLocal threadLocal;
+  void* value;
+};
+
+// Stores the value which the destructor of the thread local has been called
+// with and counts the calls.
+static void* threadingTestDestructedValue = NA_NULL;
+static int threadingTestDestructorCount = 0;
+
+void destructThreadingTestLocal(void* value) {
+  threadingTestDestructedValue = value;
+  threadingTestDestructorCount++;
+}
+
+void setThreadingTestLocal(void* arg) {
+  ThreadingTestLocal* local = (ThreadingTestLocal*)arg;
+  naSetThreadLocal(local->threadLocal, local->value);
+}
+
+void runThreadingTestLocal(ThreadingTestLocal* local) {
+  NAThread thread = naMakeThread("Threading local", setThreadingTestLocal, local);
+  naRunThread(thread);
+  naAwaitThread(thread);
+  naClearThread(thread);
+}
+
+void incThreadingTestCounter(void* arg) {
+  ThreadingTestCounter* counter = (ThreadingTestCounter*)arg;
+  for(int i = 0; i < THREADING_TEST_ITERATIONS; ++i) {
+    naLockRWLockExclusive(counter->lock);
+    counter->rwCount++;
+    naUnlockRWLockExclusive(counter->lock);
+    naLockSpinMutex(counter->mutex);
+    counter->spinCount++;
+    naUnlockSpinMutex(counter->mutex);
+  }
+}
+
+
+
+void testNAThreadingLocks() {
+  naTestGroup("Try locks from another thread") {
+    ThreadingTestTry test;
+    test.lock = naMakeRWLock();
+    test.mutex = naMakeSpinMutex();
+
+    runThreadingTestTry(&test);
+    naTest(test.shared);
+    naTest(test.exclusive);
+    naTest(test.spin);
+
+    naLockRWLockShared(test.lock);
+    naLockSpinMutex(test.mutex);
+    runThreadingTestTry(&test);
+    naTest(test.shared);
+    naTest(!test.exclusive);
+    naTest(!test.spin);
+    naUnlockSpinMutex(test.mutex);
+    naUnlockRWLockShared(test.lock);
+
+    naLockRWLockExclusive(test.lock);
+    runThreadingTestTry(&test);
+    naTest(!test.shared);
+    naTest(!test.exclusive);
+    naTest(test.spin);
+    naUnlockRWLockExclusive(test.lock);
+
+    runThreadingTestTry(&test);
+    naTest(test.shared);
+    naTest(test.exclusive);
+    naTest(test.spin);
+
+    naClearSpinMutex(test.mutex);
+    naClearRWLock(test.lock);
+  }
+
+  naTestGroup("Try locks from the same thread") {
+    NARWLock lock = naMakeRWLock();
+    NASpinMutex mutex = naMakeSpinMutex();
+    naTest(naTryRWLockExclusive(lock));
+    naTestVoid(naUnlockRWLockExclusive(lock));
+    naTest(naTryRWLockShared(lock));
+    naTestVoid(naUnlockRWLockShared(lock));
+    naTest(naTrySpinMutex(mutex));
+    naTest(!naTrySpinMutex(mutex));
+    naTestVoid(naUnlockSpinMutex(mutex));
+    naClearSpinMutex(mutex);
+    naClearRWLock(lock);
+  }
+
+  naTestGroup("Count with multiple threads") {
+    ThreadingTestCounter counter;
+    NAThread threads[THREADING_TEST_THREAD_COUNT];
+    counter.lock = naMakeRWLock();
+    counter.mutex = naMakeSpinMutex();
+    counter.rwCount = 0;
+    counter.spinCount = 0;
+    for(int i = 0; i < THREADING_TEST_THREAD_COUNT; ++i) {
+      threads[i] = naMakeThread("Threading counter", incThreadingTestCounter, &counter);
+      naRunThread(threads[i]);
+    }
+    for(int i = 0; i < THREADING_TEST_THREAD_COUNT; ++i) {
+      naAwaitThread(threads[i]);
+      naClearThread(threads[i]);
+    }
+    naTest(counter.rwCount == THREADING_TEST_THREAD_COUNT * THREADING_TEST_ITERATIONS);
+    naTest(counter.spinCount == THREADING_TEST_THREAD_COUNT * THREADING_TEST_ITERATIONS);
+    naClearSpinMutex(counter.mutex);
+    naClearRWLock(counter.lock);
+  }
+}
+
+
+
+void testNAThreadingLocals() {
+  naTestGroup("Set and get values") {
+    NAThreadLocal threadLocal = naMakeThreadLocal(NA_NULL);
+    int value = 42;
+    naTest(naGetThreadLocal(threadLocal) == NA_NULL);
+    naTestVoid(naSetThreadLocal(threadLocal, &value));
+    naTest(naGetThreadLocal(threadLocal) == &value);
+    naTestVoid(naSetThreadLocal(threadLocal, NA_NULL));
+    naClearThreadLocal(threadLocal);
+  }
+
+  #if NA_THREAD_LOCAL_DESTRUCTORS == 1
+  naTestGroup("Destructor on thread exit") {
+    ThreadingTestLocal local;
+    int value = 42;
+    local.threadLocal = naMakeThreadLocal(destructThreadingTestLocal);
+    threadingTestDestructedValue = NA_NULL;
+    threadingTestDestructorCount = 0;
+
+    local.value = &value;
+    runThreadingTestLocal(&local);
+    naTest(threadingTestDestructorCount == 1);
+    naTest(threadingTestDestructedValue == &value);
+
+    // No destructor call for values being NA_NULL.
+    local.value = NA_NULL;
+    runThreadingTestLocal(&local);
+    naTest(threadingTestDestructorCount == 1);
+
+    // The value of the current thread is not affected.
+    naTest(naGetThreadLocal(local.threadLocal) == NA_NULL);
+    naClearThreadLocal(local.threadLocal);
+  }
+  #endif
+}
+
+
+
+void testNAThreading() {
+  naTestFunction(testNAThreadingLocks);
+  naTestFunction(testNAThreadingLocals);
+}
+
+
+
+// This is free and unencumbered software released into the public domain.
+
+// Anyone is free to copy, modify, publish, use, compile, sell, or
+// distribute this software, either in source code form or as a compiled
+// binary, for any purpose, commercial or non-commercial, and by any
+// means.
+
+// In jurisdictions that recognize copyright laws, the author or authors
+// of this software dedicate any and all copyright interest in the
+// software to the public domain. We make this dedication for the benefit
+// of the public at large and to the detriment of our heirs and
+// successors. We intend this dedication to be an overt act of
+// relinquishment in perpetuity of all present and future rights to this
+// software under copyright law.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+
+// For more information, please refer to <http://unlicense.org/>